@@ -0,0 +1,209 @@
+#include "ArtNetMerger.h"
+
+#include <algorithm>
+
+ArtNetMerger::ArtNetMerger() {
+  this->Reset( 0, ARTNET_PACKET_MAXSIZE, false, 0 );
+}
+
+ArtNetMerger::~ArtNetMerger() {
+}
+
+void ArtNetMerger::Reset( size_t universe_count, size_t buffer_size, bool is_ltp, uint32_t timeout_ms ) {
+  m_is_ltp     = is_ltp;
+  m_timeout_ms = ( timeout_ms == 0 ) ? DEFAULT_TIMEOUT_MS : timeout_ms;
+  m_stats      = Stats();
+
+  // Per universe a buffer for each source and one for the merged output, plus the spare.
+  const size_t buffers_per_universe = SOURCES_PER_UNIVERSE + 1;
+  m_buffers.assign( ( universe_count * buffers_per_universe + 1 ) * buffer_size, 0 );
+  m_universes.assign( universe_count, Universe() );
+
+  uint8_t* ptr_buffer = m_buffers.data();
+  for( Universe& universe : m_universes ) {
+    for( Source& source : universe.m_sources ) {
+      source = Source{ 0, 0, false, ptr_buffer, ArtNetDMXView() };
+      ptr_buffer += buffer_size;
+    }
+    universe.m_merged     = ptr_buffer;
+    universe.m_merged_dmx = ArtNetDMXView();
+    universe.m_is_merged  = false;
+    ptr_buffer += buffer_size;
+  }
+  m_ptr_spare = ptr_buffer;
+}
+
+const ArtNetDMXView* ArtNetMerger::Merge( uint16_t universe_index, uint32_t source_ip, uint32_t now_ms, const ArtNetDMXView& dmx ) {
+  Universe& universe   = m_universes[ universe_index ];
+  Source*   ptr_source = nullptr;
+  Source*   ptr_free   = nullptr;
+  Source*   ptr_other  = nullptr;
+
+  this->ExpireSources( universe, now_ms );
+  for( Source& source : universe.m_sources ) {
+    if( source.m_is_live && source.m_ip == source_ip ) {
+      ptr_source = &source;
+    } else if( source.m_is_live ) {
+      ptr_other = &source;
+    } else if( ptr_free == nullptr ) {
+      ptr_free = &source;
+    }
+  }
+
+  if( ptr_source == nullptr ) {
+    if( ptr_free == nullptr ) {
+      m_stats.m_ignored_frames++;
+      return nullptr;
+    }
+    ptr_source = ptr_free;
+    ptr_source->m_ip      = source_ip;
+    ptr_source->m_is_live = true;
+    ptr_source->m_dmx     = ArtNetDMXView();
+    universe.m_is_merged  = false;
+  }
+
+  // The source's previous frame stays readable in the new spare until the next packet is read.
+  ArtNetDMXView previous = ptr_source->m_dmx;
+  std::swap( ptr_source->m_buffer, m_ptr_spare );
+  ptr_source->m_dmx     = dmx;
+  ptr_source->m_last_ms = now_ms;
+
+  if( ptr_other == nullptr ) {
+    return &ptr_source->m_dmx;
+  }
+
+  // A source's first frame is an empty view, which mustn't reach memcmp() or memcpy().
+  if( universe.m_is_merged && previous.length == dmx.length && ( dmx.length == 0 || memcmp( previous.data, dmx.data, dmx.length ) == 0 ) ) {
+    m_stats.m_unchanged_frames++;
+    return &universe.m_merged_dmx;
+  }
+
+  if( m_is_ltp ) {
+    this->MergeLTP( universe, dmx, previous, ptr_other->m_dmx );
+  } else {
+    this->MergeHTP( universe, dmx, ptr_other->m_dmx );
+  }
+  universe.m_merged_dmx.universe = dmx.universe;
+  universe.m_merged_dmx.sequence = dmx.sequence;
+  universe.m_merged_dmx.physical = dmx.physical;
+  universe.m_merged_dmx.data     = universe.m_merged;
+  universe.m_is_merged = true;
+  m_stats.m_merged_frames++;
+
+  return &universe.m_merged_dmx;
+}
+
+void ArtNetMerger::MergeHTP( Universe& universe, const ArtNetDMXView& dmx, const ArtNetDMXView& other ) {
+  const ArtNetDMXView& shorter = ( dmx.length <= other.length ) ? dmx : other;
+  const ArtNetDMXView& longer  = ( dmx.length <= other.length ) ? other : dmx;
+
+  uint8_t*       ptr_merged = universe.m_merged;
+  const uint8_t* ptr_a      = dmx.data;
+  const uint8_t* ptr_b      = other.data;
+  size_t         length     = shorter.length;
+  size_t         i          = 0;
+  for( ; i + 4 <= length; i += 4 ) {
+    uint32_t a, b;
+    memcpy( &a, ptr_a + i, 4 );
+    memcpy( &b, ptr_b + i, 4 );
+    uint32_t merged = MaxBytes( a, b );
+    memcpy( ptr_merged + i, &merged, 4 );
+  }
+  for( ; i < length; i++ ) {
+    ptr_merged[ i ] = std::max( ptr_a[ i ], ptr_b[ i ] );
+  }
+  if( longer.length > length ) {
+    memcpy( ptr_merged + length, longer.data + length, longer.length - length );
+  }
+  universe.m_merged_dmx.length = longer.length;
+}
+
+void ArtNetMerger::MergeLTP( Universe& universe, const ArtNetDMXView& dmx, const ArtNetDMXView& previous, const ArtNetDMXView& other ) {
+  uint8_t* ptr_merged = universe.m_merged;
+
+  if( !universe.m_is_merged || previous.length != dmx.length ) {
+    // Merging starts, or the source changed shape : it takes every channel it sends.
+    if( other.length > 0 ) {
+      memcpy( ptr_merged, other.data, other.length );
+    }
+    if( dmx.length > 0 ) {
+      memcpy( ptr_merged, dmx.data, dmx.length );
+    }
+  } else {
+    // Only the channels this source changed follow it, the rest keep their last value.
+    const uint8_t* ptr_new  = dmx.data;
+    const uint8_t* ptr_last = previous.data;
+    size_t         length   = dmx.length;
+    size_t         i        = 0;
+    for( ; i + 4 <= length; i += 4 ) {
+      uint32_t value, last, merged;
+      memcpy( &value, ptr_new + i, 4 );
+      memcpy( &last, ptr_last + i, 4 );
+      memcpy( &merged, ptr_merged + i, 4 );
+      uint32_t mask = ChangedBytes( value, last );
+      merged = ( value & mask ) | ( merged & ~mask );
+      memcpy( ptr_merged + i, &merged, 4 );
+    }
+    for( ; i < length; i++ ) {
+      ptr_merged[ i ] = ( ptr_new[ i ] != ptr_last[ i ] ) ? ptr_new[ i ] : ptr_merged[ i ];
+    }
+  }
+  universe.m_merged_dmx.length = std::max( dmx.length, other.length );
+}
+
+const ArtNetDMXView* ArtNetMerger::Expire( uint16_t universe_index, uint32_t now_ms ) {
+  Universe& universe = m_universes[ universe_index ];
+  if( !this->ExpireSources( universe, now_ms ) ) {
+    return nullptr;
+  }
+  for( const Source& source : universe.m_sources ) {
+    if( source.m_is_live ) {
+      return &source.m_dmx;
+    }
+  }
+  return nullptr;
+}
+
+bool ArtNetMerger::ExpireSources( Universe& universe, uint32_t now_ms ) {
+  bool is_expired = false;
+  for( Source& source : universe.m_sources ) {
+    if( source.m_is_live && now_ms - source.m_last_ms >= m_timeout_ms ) {
+      source.m_is_live     = false;
+      universe.m_is_merged = false;
+      m_stats.m_source_timeouts++;
+      is_expired = true;
+    }
+  }
+  return is_expired;
+}
+
+void ArtNetMerger::RemoveSource( uint16_t universe_index, uint32_t source_ip ) {
+  Universe& universe = m_universes[ universe_index ];
+  for( Source& source : universe.m_sources ) {
+    if( source.m_is_live && source.m_ip == source_ip ) {
+      source.m_is_live     = false;
+      universe.m_is_merged = false;
+    }
+  }
+}
+
+uint8_t ArtNetMerger::GetSourceCount( uint16_t universe_index, uint32_t now_ms ) const {
+  uint8_t count = 0;
+  for( const Source& source : m_universes[ universe_index ].m_sources ) {
+    count += ( source.m_is_live && now_ms - source.m_last_ms < m_timeout_ms );
+  }
+  return count;
+}
+
+bool ArtNetMerger::IsSource( uint16_t universe_index, uint32_t source_ip, uint32_t now_ms ) const {
+  for( const Source& source : m_universes[ universe_index ].m_sources ) {
+    if( source.m_is_live && now_ms - source.m_last_ms < m_timeout_ms && source.m_ip == source_ip ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const ArtNetMerger::Stats& ArtNetMerger::GetStats() const {
+  return m_stats;
+}
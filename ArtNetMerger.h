@@ -0,0 +1,118 @@
+#ifndef _ARTNETMERGER_H_
+#define _ARTNETMERGER_H_
+
+#include <Arduino.h>
+#include <vector>
+
+#include "ArtNetParser.h"
+
+// Merges ArtDMX frames from two sources sending the same universe, as the
+// Art-Net spec describes, rather than letting them overwrite each other.
+//
+// Packets are read into GetReceiveBuffer(), which Merge() swaps for the
+// buffer holding the source's previous frame, so frames are kept without
+// being copied.  With one source its frame goes straight through.  With two,
+// HTP outputs the higher of the two values on each channel, LTP the value
+// last changed by either source; the output is only recomputed when a
+// source's data changed.  A source silent for the merge timeout drops out,
+// and a third source is ignored while two are live.
+class ArtNetMerger {
+public:
+  struct Stats {
+    uint32_t m_merged_frames;     // Frames the merged output was recomputed for.
+    uint32_t m_unchanged_frames;  // Frames from a merging source with the same data as its last one.
+    uint32_t m_ignored_frames;    // Frames from a third source.
+    uint32_t m_source_timeouts;   // Sources dropped for going silent.
+  };
+
+  static const uint8_t  SOURCES_PER_UNIVERSE = 2;
+  static const uint32_t DEFAULT_TIMEOUT_MS   = 10000;   // Art-Net's own.
+
+  ArtNetMerger();
+
+  ~ArtNetMerger();
+
+  // Forgets every source of universes 0 .. universe_count - 1 (ArtNetUniverseMap::Entry::m_index)
+  // and sizes the buffers.  A timeout of 0 is DEFAULT_TIMEOUT_MS.
+  void Reset( size_t universe_count, size_t buffer_size, bool is_ltp, uint32_t timeout_ms );
+
+  uint8_t* GetReceiveBuffer() const {
+    return m_ptr_spare;
+  }
+
+  // Takes dmx from source_ip, which must point into GetReceiveBuffer().
+  // Returns the universe's output, valid until the next call for the same
+  // universe, or nullptr when the frame was ignored.
+  const ArtNetDMXView* Merge( uint16_t universe_index, uint32_t source_ip, uint32_t now_ms, const ArtNetDMXView& dmx );
+
+  // Drops the universe's sources silent for the timeout, as Merge() does, for
+  // universes no packet comes for.  Returns the frame of the source left when
+  // that ended a merge, which is the universe's output again, or nullptr.
+  const ArtNetDMXView* Expire( uint16_t universe_index, uint32_t now_ms );
+
+  // Stops merging source_ip into the universe at once, rather than after the timeout.
+  void RemoveSource( uint16_t universe_index, uint32_t source_ip );
+
+  bool IsLTP() const {
+    return m_is_ltp;
+  }
+
+  // Sources of the universe heard from within the timeout, 0 - SOURCES_PER_UNIVERSE.
+  uint8_t GetSourceCount( uint16_t universe_index, uint32_t now_ms ) const;
+
+  // Whether source_ip is one of them.
+  bool IsSource( uint16_t universe_index, uint32_t source_ip, uint32_t now_ms ) const;
+
+  const Stats& GetStats() const;
+
+  // The larger of each pair of bytes of a and b, four channels at once without
+  // branching; the ESP32 has no SIMD but a 32 bit ALU.
+  static uint32_t MaxBytes( uint32_t a, uint32_t b ) {
+    const uint32_t high = 0x80808080u;
+    // Per byte, the top bit of low_ge is set when a's low 7 bits are >= b's; no borrow crosses bytes.
+    uint32_t low_ge = ( ( a | high ) - ( b & ~high ) ) & high;
+    uint32_t ge     = ( ( a & ~b ) | ( ~( a ^ b ) & low_ge ) ) & high;
+    uint32_t mask   = ( ge >> 7 ) * 0xFF;
+    return ( a & mask ) | ( b & ~mask );
+  }
+
+  // 0xFF in each byte where a and b differ, 0x00 where they are the same.
+  static uint32_t ChangedBytes( uint32_t a, uint32_t b ) {
+    const uint32_t low = 0x7F7F7F7Fu;
+    uint32_t diff    = a ^ b;
+    uint32_t nonzero = ( ( ( diff & low ) + low ) | diff ) & ~low;
+    return ( nonzero >> 7 ) * 0xFF;
+  }
+
+private:
+  struct Source {
+    uint32_t      m_ip;
+    uint32_t      m_last_ms;
+    bool          m_is_live;
+    uint8_t*      m_buffer;
+    ArtNetDMXView m_dmx;        // The latest frame, in m_buffer.
+  };
+
+  struct Universe {
+    Source        m_sources[ SOURCES_PER_UNIVERSE ];
+    uint8_t*      m_merged;
+    ArtNetDMXView m_merged_dmx;
+    bool          m_is_merged;  // m_merged is up to date with both sources.
+  };
+
+  // True when a source was dropped.
+  bool ExpireSources( Universe& universe, uint32_t now_ms );
+
+  void MergeHTP( Universe& universe, const ArtNetDMXView& dmx, const ArtNetDMXView& other );
+
+  void MergeLTP( Universe& universe, const ArtNetDMXView& dmx, const ArtNetDMXView& previous, const ArtNetDMXView& other );
+
+  bool                  m_is_ltp;
+  uint32_t              m_timeout_ms;
+  std::vector<uint8_t>  m_buffers;
+  std::vector<Universe> m_universes;
+  uint8_t*              m_ptr_spare;
+  Stats                 m_stats;
+};
+
+#endif
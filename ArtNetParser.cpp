@@ -0,0 +1,11 @@
+#include "ArtNetParser.h"
+
+const char* ArtNetParser::GetResultName( Result result ) {
+  switch( result ) {
+    case PARSE_OK:         return "ok";
+    case PARSE_TOO_SHORT:  return "too short";
+    case PARSE_BAD_ID:     return "bad header ID";
+    case PARSE_BAD_LENGTH: return "bad DMX length";
+    default:               return "unknown";
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef _ARTNETPARSER_H_
+#define _ARTNETPARSER_H_
+
+#include <Arduino.h>
+
+#include "ArtNet_Spec.h"
+
+// Fields of an ArtDMX packet.  data points into the receive buffer, nothing is copied.
+struct ArtNetDMXView {
+  uint16_t       universe;      // 15 bit port-address, Net << 8 | SubUni.
+  uint8_t        sequence;
+  uint8_t        physical;
+  uint16_t       length;        // Channels in data, 1 - 512.
+  const uint8_t* data;
+};
+
+// Validates received Art-Net datagrams in place.
+//
+// Every field is bounds checked against the number of bytes actually
+// received, never against what the packet claims, and nothing is allocated.
+// The parse functions are inline as they run for every packet.
+class ArtNetParser {
+public:
+  enum Result : uint8_t {
+    PARSE_OK,
+    PARSE_TOO_SHORT,        // Shorter than the header, or than the fixed fields of the packet.
+    PARSE_BAD_ID,           // Doesn't start with "Art-Net\0".
+    PARSE_BAD_LENGTH,       // DMX length of 0, over 512 or more than was received.
+    PARSE_RESULT_MAX
+  };
+
+  static const size_t DMX_DATA_START = ARTNET_PACKET_PAYLOAD_START + 8;
+
+  static Result ParseHeader( const uint8_t* buffer, size_t size, uint16_t& opcode ) {
+    static const uint8_t id[ 8 ] = { 'A', 'r', 't', '-', 'N', 'e', 't', 0 };
+
+    if( size < ARTNET_PACKET_MINSIZE_HEADER ) {
+      return PARSE_TOO_SHORT;
+    }
+    if( memcmp( buffer, id, sizeof( id ) ) != 0 ) {
+      return PARSE_BAD_ID;
+    }
+    opcode = buffer[ 8 ] | buffer[ 9 ] << 8;
+    return PARSE_OK;
+  }
+
+  // The port-address of an ArtDMX packet, from its first DMX_DATA_START bytes
+  // so that the data needn't be read for a universe nobody wants.
+  static Result PeekDMXUniverse( const uint8_t* buffer, size_t size, uint16_t& universe ) {
+    if( size < DMX_DATA_START ) {
+      return PARSE_TOO_SHORT;
+    }
+    universe = buffer[ ARTNET_PACKET_PAYLOAD_START + 4 ] | ( buffer[ ARTNET_PACKET_PAYLOAD_START + 5 ] & 0x7F ) << 8;
+    return PARSE_OK;
+  }
+
+  // For a packet ParseHeader() accepted with ARTNET_OPCODE_DMX.
+  static Result ParseDMX( const uint8_t* buffer, size_t size, ArtNetDMXView& dmx ) {
+    if( size < DMX_DATA_START ) {
+      return PARSE_TOO_SHORT;
+    }
+
+    const uint8_t* fields = buffer + ARTNET_PACKET_PAYLOAD_START;
+    uint16_t length = fields[ 6 ] << 8 | fields[ 7 ];
+    if( length == 0 || length > 512 || length > size - DMX_DATA_START ) {
+      return PARSE_BAD_LENGTH;
+    }
+
+    dmx.sequence = fields[ 2 ];
+    dmx.physical = fields[ 3 ];
+    dmx.universe = fields[ 4 ] | ( fields[ 5 ] & 0x7F ) << 8;
+    dmx.length   = length;
+    dmx.data     = buffer + DMX_DATA_START;
+    return PARSE_OK;
+  }
+
+  static const char* GetResultName( Result result );
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "ArtNetPollResponder.h"
+
+#include "DMXFrameScheduler.h"
+
+#define FIRMWARE_VERSION  0x0001
+#define ESTA_PROTOTYPE    0x7FF0    // ESTA's code for prototypes and experiments.
+#define OEM_UNKNOWN       0x00FF
+#define DMX_REFRESH_RATE  44
+
+// ArtPoll Flags : send ArtPollReply whenever the node's conditions change.
+#define POLL_FLAG_NOTIFY_CHANGES 0x02
+
+ArtNetPollResponder::ArtNetPollResponder() {
+  m_pending_count  = 0;
+  m_notify_ip      = 0;
+  m_is_changed     = false;
+  m_report_code    = REPORT_DEBUG;
+  m_report_counter = 0;
+  this->ResetStats();
+}
+
+void ArtNetPollResponder::Build( const NodeInfo& info, const std::vector<uint16_t>& universes ) {
+  m_pending_count  = 0;
+  m_notify_ip      = 0;
+  m_is_changed     = false;
+  m_report_counter = 0;
+
+  // Everything not set below is zero, as the spec wants of unused fields.
+  m_replies.assign( universes.size(), Reply() );
+  for( size_t i = 0; i < universes.size(); i++ ) {
+    Reply&                 reply = m_replies[ i ];
+    ArtNetPacketPollReply& body  = reply.m_body;
+    uint16_t               universe = universes[ i ];
+
+    memcpy( reply.m_header.m_ID, ARTNET_HEADER_ID, sizeof( reply.m_header.m_ID ) );
+    reply.m_header.m_OpCode = ARTNET_OPCODE_POLLREPLY;
+
+    body.m_Port         = ARTNET_UDP_PORT;
+    body.m_VersInfoH    = FIRMWARE_VERSION >> 8;
+    body.m_VersInfoL    = FIRMWARE_VERSION & 0xFF;
+    body.m_NetSwitch    = ( universe >> 8 ) & 0x7F;
+    body.m_SubSwitch    = ( universe >> 4 ) & 0x0F;
+    body.m_OemHi        = OEM_UNKNOWN >> 8;
+    body.m_Oem          = OEM_UNKNOWN & 0xFF;
+    body.m_Status1      = 0xE0;   // Indicators normal, port-addresses set from the web pages.
+    body.m_EstaManLo    = ESTA_PROTOTYPE & 0xFF;
+    body.m_EstaManHi    = ESTA_PROTOTYPE >> 8;
+    strncpy( (char*)body.m_PortName, info.short_name, sizeof( body.m_PortName ) - 1 );
+    strncpy( (char*)body.m_LongName, info.long_name, sizeof( body.m_LongName ) - 1 );
+    body.m_NumPortsLo   = 1;
+    body.m_PortTypes[ 0 ] = 0x80;   // Outputs DMX512 from Art-Net.
+    body.m_SwOut[ 0 ]   = universe & 0x0F;
+    body.m_Style        = 0x00;     // StNode.
+    body.m_MAC_1_Hi     = info.mac[ 0 ];
+    body.m_MAC_2        = info.mac[ 1 ];
+    body.m_MAC_3        = info.mac[ 2 ];
+    body.m_MAC_4        = info.mac[ 3 ];
+    body.m_MAC_5        = info.mac[ 4 ];
+    body.m_MAC_6_Lo     = info.mac[ 5 ];
+    body.m_BindIndex    = (uint8_t)( i + 1 );
+    body.m_GoodOutputB[ 0 ] = 0xC0;   // No RDM, continuous output.
+    body.m_Status3      = info.is_failsafe_zero ? 0x40 : 0x00;
+    body.m_RefreshRateHi = DMX_REFRESH_RATE >> 8;
+    body.m_RefreshRateLo = DMX_REFRESH_RATE & 0xFF;
+  }
+
+  // The fields that change are written the way they are patched later,
+  // from a state that can't match.
+  m_report_code = 0xFFFF;
+  for( Reply& reply : m_replies ) {
+    reply.m_body.m_Status2 = 0xFF;
+  }
+  this->SetIPAddress( info.ip, info.is_dhcp );
+  this->SetNodeReport( REPORT_POWER_OK, "" );
+  m_is_changed = false;
+  m_stats.m_patches = 0;
+}
+
+bool ArtNetPollResponder::HandlePoll( const uint8_t* buffer, size_t size, IPAddress controller_ip, uint32_t now_us ) {
+  if( size < ARTNET_PACKET_MINSIZE_POLL ) {
+    return false;
+  }
+  m_stats.m_polls++;
+
+  const ArtNetPacketPoll* ptr_poll = (const ArtNetPacketPoll*)( buffer + ARTNET_PACKET_PAYLOAD_START );
+  uint32_t ip = controller_ip;
+  if( ptr_poll->m_Flags & POLL_FLAG_NOTIFY_CHANGES ) {
+    m_notify_ip = ip;
+  } else if( m_notify_ip == ip ) {
+    m_notify_ip = 0;
+  }
+
+  // A controller polling again before it was answered waits for the first answer.
+  for( uint8_t i = 0; i < m_pending_count; i++ ) {
+    if( m_pending[ i ].m_ip == ip ) {
+      return true;
+    }
+  }
+  if( m_pending_count == MAX_PENDING ) {
+    m_stats.m_dropped_polls++;
+    return true;
+  }
+  m_pending[ m_pending_count ].m_ip      = ip;
+  m_pending[ m_pending_count ].m_poll_us = now_us;
+  m_pending[ m_pending_count ].m_due_us  = now_us + random( MAX_DELAY_US );
+  m_pending_count++;
+  return true;
+}
+
+void ArtNetPollResponder::SetIPAddress( IPAddress ip, bool is_dhcp ) {
+  if( m_replies.empty() ) {
+    return;
+  }
+  uint8_t status2 = 0x0D | ( is_dhcp ? 0x02 : 0x00 );   // Web configuration, DHCP capable, 15 bit port-addresses.
+  ArtNetPacketPollReply& first = m_replies[ 0 ].m_body;
+  if( first.m_IPAddress[ 0 ] == ip[ 0 ] && first.m_IPAddress[ 1 ] == ip[ 1 ] && first.m_IPAddress[ 2 ] == ip[ 2 ] &&
+      first.m_IPAddress[ 3 ] == ip[ 3 ] && first.m_Status2 == status2 ) {
+    return;
+  }
+  for( Reply& reply : m_replies ) {
+    for( uint8_t i = 0; i < 4; i++ ) {
+      reply.m_body.m_IPAddress[ i ] = ip[ i ];
+      reply.m_body.m_BindIp[ i ]    = ip[ i ];
+    }
+    reply.m_body.m_Status2 = status2;
+  }
+  m_stats.m_patches++;
+  m_is_changed = true;
+}
+
+void ArtNetPollResponder::SetPortState( size_t index, uint8_t good_output ) {
+  uint8_t& field = m_replies[ index ].m_body.m_GoodOutputA[ 0 ];
+  if( field == good_output ) {
+    return;
+  }
+  field = good_output;
+  m_stats.m_patches++;
+  m_is_changed = true;
+}
+
+void ArtNetPollResponder::SetNodeReport( uint16_t code, const char* text ) {
+  if( m_replies.empty() ) {
+    return;
+  }
+  const char* ptr_report = (const char*)m_replies[ 0 ].m_body.m_NodeReport;
+  if( code == m_report_code && strncmp( ptr_report + REPORT_TEXT_START, text, sizeof( ArtNetPacketPollReply::m_NodeReport ) - REPORT_TEXT_START - 1 ) == 0 ) {
+    return;
+  }
+  m_report_code = code;
+
+  // "#xxxx [yyyy] text" : the code in hex, then the counter Send() keeps up to date.
+  char report[ sizeof( ArtNetPacketPollReply::m_NodeReport ) ];
+  snprintf( report, sizeof( report ), "#%04x [%04u] %s", code, (unsigned)m_report_counter, text );
+  for( Reply& reply : m_replies ) {
+    strncpy( (char*)reply.m_body.m_NodeReport, report, sizeof( reply.m_body.m_NodeReport ) );
+  }
+  m_stats.m_patches++;
+  m_is_changed = true;
+}
+
+bool ArtNetPollResponder::Send( WiFiUDP& udp, uint32_t now_us ) {
+  bool is_sent = false;
+
+  for( uint8_t i = 0; i < m_pending_count; ) {
+    Pending& pending = m_pending[ i ];
+    if( !DMXFrameScheduler::HasReached( now_us, pending.m_due_us ) ) {
+      i++;
+      continue;
+    }
+    m_stats.m_delay_max_us = std::max( m_stats.m_delay_max_us, now_us - pending.m_poll_us );
+    this->SendAll( udp, pending.m_ip );
+    if( pending.m_ip == m_notify_ip ) {
+      m_is_changed = false;
+    }
+    pending = m_pending[ --m_pending_count ];
+    is_sent = true;
+  }
+
+  if( m_is_changed && m_notify_ip != 0 ) {
+    this->SendAll( udp, m_notify_ip );
+    m_stats.m_change_replies++;
+    m_is_changed = false;
+    is_sent = true;
+  }
+  return is_sent;
+}
+
+void ArtNetPollResponder::SendAll( WiFiUDP& udp, uint32_t ip ) {
+  // Only the counter's four digits change from one reply to the next.
+  m_report_counter = ( m_report_counter + 1 ) % 10000;
+  char counter[ 5 ];
+  snprintf( counter, sizeof( counter ), "%04u", (unsigned)m_report_counter );
+  for( Reply& reply : m_replies ) {
+    memcpy( reply.m_body.m_NodeReport + REPORT_COUNTER_START, counter, 4 );
+    udp.beginPacket( IPAddress( ip ), ARTNET_UDP_PORT );
+    udp.write( (const uint8_t*)&reply, sizeof( reply ) );
+    udp.endPacket();
+    m_stats.m_replies++;
+  }
+}
+
+size_t ArtNetPollResponder::GetReplyCount() const {
+  return m_replies.size();
+}
+
+const uint8_t* ArtNetPollResponder::GetReply( size_t index ) const {
+  return (const uint8_t*)&m_replies[ index ];
+}
+
+const ArtNetPollResponder::Stats& ArtNetPollResponder::GetStats() const {
+  return m_stats;
+}
+
+void ArtNetPollResponder::ResetStats() {
+  memset( &m_stats, 0, sizeof( m_stats ) );
+}
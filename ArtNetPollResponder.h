@@ -0,0 +1,121 @@
+#ifndef _ARTNETPOLLRESPONDER_H_
+#define _ARTNETPOLLRESPONDER_H_
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <vector>
+
+#include "ArtNet_Spec.h"
+
+// Answers ArtPoll, so that controllers can discover the node and unicast to it.
+//
+// Build() makes one full size ArtPollReply per subscribed universe when the
+// node starts, each a single output port told apart by BindIndex.  After that
+// only the fields that change are written, in place and only when they did :
+// the IP address, each port's output state and the node report, whose counter
+// moves with every reply.
+//
+// Replies are unicast to the controller that polled, a random 0 - MAX_DELAY_US
+// later so that a network full of nodes doesn't answer a broadcast poll at
+// once.  A controller that asked to hear of changes gets the replies again
+// straight away whenever a patched field changes.
+class ArtNetPollResponder {
+public:
+  struct NodeInfo {
+    IPAddress   ip;
+    uint8_t     mac[ 6 ];
+    bool        is_dhcp;
+    bool        is_failsafe_zero;   // Outputs black out when Art-Net stops, rather than hold.
+    const char* short_name;         // Up to 17 characters.
+    const char* long_name;          // Up to 63 characters.
+  };
+
+  struct Stats {
+    uint32_t m_polls;
+    uint32_t m_replies;         // ArtPollReply packets sent, one per universe each time.
+    uint32_t m_change_replies;  // Times they were sent unasked, for a change.
+    uint32_t m_dropped_polls;   // From more than MAX_PENDING controllers waiting at once.
+    uint32_t m_patches;         // Fields rewritten in the built replies.
+    uint32_t m_delay_max_us;    // Longest a poll waited for its replies.
+  };
+
+  // GoodOutputA bits of SetPortState().
+  static const uint8_t OUTPUT_TRANSMITTING = 0x80;
+  static const uint8_t OUTPUT_MERGING      = 0x08;
+  static const uint8_t OUTPUT_LTP          = 0x02;
+
+  // Node report codes.
+  static const uint16_t REPORT_DEBUG    = 0x0000;
+  static const uint16_t REPORT_POWER_OK = 0x0001;
+
+  static const uint32_t MAX_DELAY_US = 1000000;
+  static const uint8_t  MAX_PENDING  = 4;
+
+  ArtNetPollResponder();
+
+  // Forgets pending polls and controllers waiting for changes.
+  void Build( const NodeInfo& info, const std::vector<uint16_t>& universes );
+
+  // Schedules the replies to an ArtPoll read from controller_ip.  False when
+  // it is too short to be one.
+  bool HandlePoll( const uint8_t* buffer, size_t size, IPAddress controller_ip, uint32_t now_us );
+
+  void SetIPAddress( IPAddress ip, bool is_dhcp );
+
+  // The GoodOutputA bits of the reply of universes[ index ].
+  void SetPortState( size_t index, uint8_t good_output );
+
+  // Text up to 50 characters, after the "#code [counter] " prefix.
+  void SetNodeReport( uint16_t code, const char* text );
+
+  // Replies are waiting, or a controller wants to hear of changes : the
+  // patched fields should be kept up to date.
+  bool IsActive() const {
+    return m_pending_count != 0 || m_notify_ip != 0;
+  }
+
+  // Sends the replies that are due, returns false when none were.
+  bool Send( WiFiUDP& udp, uint32_t now_us );
+
+  size_t GetReplyCount() const;
+
+  const uint8_t* GetReply( size_t index ) const;
+
+  const Stats& GetStats() const;
+
+  void ResetStats();
+
+private:
+  struct Reply {
+    ArtNetPacketHeader    m_header;
+    ArtNetPacketPollReply m_body;
+  } __attribute__( ( packed ) );
+
+  static_assert( sizeof( Reply ) == ARTNET_PACKET_SIZE_POLLREPLY, "ArtPollReply must be full size" );
+
+  struct Pending {
+    uint32_t m_ip;
+    uint32_t m_poll_us;
+    uint32_t m_due_us;
+  };
+
+  static const uint8_t REPORT_COUNTER_START = 7;    // "#0001 [" then 4 digits.
+  static const uint8_t REPORT_TEXT_START    = 13;
+
+  void SendAll( WiFiUDP& udp, uint32_t ip );
+
+  std::vector<Reply> m_replies;
+
+  Pending  m_pending[ MAX_PENDING ];
+  uint8_t  m_pending_count;
+
+  uint32_t m_notify_ip;       // Controller wanting replies on change, 0 for none.
+  bool     m_is_changed;      // Since the last replies to it.
+
+  uint16_t m_report_code;
+  uint16_t m_report_counter;
+
+  Stats    m_stats;
+};
+
+#endif
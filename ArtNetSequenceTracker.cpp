@@ -0,0 +1,59 @@
+#include "ArtNetSequenceTracker.h"
+
+ArtNetSequenceTracker::ArtNetSequenceTracker() {
+}
+
+ArtNetSequenceTracker::~ArtNetSequenceTracker() {
+}
+
+void ArtNetSequenceTracker::Reset( size_t universe_count ) {
+  m_sources.assign( universe_count * SOURCES_PER_UNIVERSE, Source{ 0, 0, 0, false } );
+}
+
+ArtNetSequenceTracker::Result ArtNetSequenceTracker::Check( uint16_t universe_index, uint32_t source_ip, uint8_t sequence, uint32_t now_ms, uint8_t& missed ) {
+  missed = 0;
+
+  // The source's slot, or else a free one, or else the one heard from longest ago.
+  Source* ptr_sources = &m_sources[ universe_index * SOURCES_PER_UNIVERSE ];
+  Source* ptr_source  = nullptr;
+  Source* ptr_oldest  = ptr_sources;
+  for( uint8_t i = 0; i < SOURCES_PER_UNIVERSE; i++ ) {
+    Source* ptr_slot = &ptr_sources[ i ];
+    if( ptr_slot->m_is_used && ptr_slot->m_ip == source_ip ) {
+      ptr_source = ptr_slot;
+      break;
+    }
+    if( ptr_oldest->m_is_used && ( !ptr_slot->m_is_used || (int32_t)( ptr_slot->m_last_ms - ptr_oldest->m_last_ms ) < 0 ) ) {
+      ptr_oldest = ptr_slot;
+    }
+  }
+
+  if( ptr_source == nullptr ) {
+    *ptr_oldest = Source{ source_ip, now_ms, sequence, true };
+    return sequence == 0 ? SEQUENCE_DISABLED : SEQUENCE_RESTART;
+  }
+
+  uint32_t silence_ms = now_ms - ptr_source->m_last_ms;
+  uint8_t  last       = ptr_source->m_sequence;
+  ptr_source->m_last_ms = now_ms;
+
+  if( sequence == 0 || last == 0 ) {
+    ptr_source->m_sequence = sequence;
+    return sequence == 0 ? SEQUENCE_DISABLED : SEQUENCE_RESTART;
+  }
+
+  int distance = Distance( last, sequence );
+  if( silence_ms < RESTART_MS && distance <= 0 && distance >= -STALE_WINDOW ) {
+    return SEQUENCE_STALE;
+  }
+
+  ptr_source->m_sequence = sequence;
+  if( silence_ms >= RESTART_MS || distance < 0 ) {
+    return SEQUENCE_RESTART;
+  }
+  if( distance > 1 ) {
+    missed = (uint8_t)( distance - 1 );
+    return SEQUENCE_GAP;
+  }
+  return SEQUENCE_NEXT;
+}
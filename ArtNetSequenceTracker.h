@@ -0,0 +1,56 @@
+#ifndef _ARTNETSEQUENCETRACKER_H_
+#define _ARTNETSEQUENCETRACKER_H_
+
+#include <Arduino.h>
+#include <vector>
+
+// Follows the ArtDMX sequence numbers of each source sending a universe, so
+// that a frame WiFi delivered after a newer one is dropped instead of making
+// the output jump back.
+//
+// Sequence numbers count 1 - 255 and wrap back to 1.  A source sending 0
+// doesn't number its frames and they are all taken.  A frame up to
+// STALE_WINDOW behind the last one is stale; anything further back, or after
+// RESTART_MS of silence, is taken as the source restarting.
+class ArtNetSequenceTracker {
+public:
+  enum Result : uint8_t {
+    SEQUENCE_NEXT,          // The one after the last frame.
+    SEQUENCE_GAP,           // Ahead of the next, frames were missed.
+    SEQUENCE_STALE,         // Older than, or the same as, the last frame; drop it.
+    SEQUENCE_RESTART,       // First frame from the source, or it started over.
+    SEQUENCE_DISABLED       // The source sends 0.
+  };
+
+  static const uint8_t  SOURCES_PER_UNIVERSE = 4;
+  static const int      STALE_WINDOW         = 20;
+  static const uint32_t RESTART_MS           = 1000;
+
+  ArtNetSequenceTracker();
+
+  ~ArtNetSequenceTracker();
+
+  // Forgets every source, for universes 0 .. universe_count - 1 (ArtNetUniverseMap::Entry::m_index).
+  void Reset( size_t universe_count );
+
+  // missed is set to the number of frames skipped on SEQUENCE_GAP.
+  Result Check( uint16_t universe_index, uint32_t source_ip, uint8_t sequence, uint32_t now_ms, uint8_t& missed );
+
+  // Steps from sequence from to sequence to, -127 .. 127, skipping 0.
+  static int Distance( uint8_t from, uint8_t to ) {
+    int distance = ( (int)to - (int)from + 255 ) % 255;
+    return distance > 127 ? distance - 255 : distance;
+  }
+
+private:
+  struct Source {
+    uint32_t m_ip;
+    uint32_t m_last_ms;
+    uint8_t  m_sequence;
+    bool     m_is_used;
+  };
+
+  std::vector<Source> m_sources;    // SOURCES_PER_UNIVERSE per universe.
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "ArtNetUniverseMap.h"
+
+#include <algorithm>
+
+ArtNetUniverseMap::ArtNetUniverseMap() {
+  m_entries.assign( 1, Entry{ EMPTY, 0, 0, false, 0 } );
+  m_mask           = 0;
+  m_universe_count = 0;
+}
+
+ArtNetUniverseMap::~ArtNetUniverseMap() {
+}
+
+bool ArtNetUniverseMap::Compile( const std::vector<ArtNetUniverseSlice>& slices, uint16_t routed_universe ) {
+  m_slices.clear();
+  for( ArtNetUniverseSlice slice : slices ) {
+    if( slice.universe > 0x7FFF || slice.input_channel < 1 || slice.input_channel > 512 || slice.output_channel < 1 || slice.output_channel > 512 ) {
+      continue;
+    }
+    // Keep both ends of the copy inside the 512 channels.
+    slice.count = std::min<uint16_t>( slice.count, 513 - std::max( slice.input_channel, slice.output_channel ) );
+    if( slice.count > 0 ) {
+      m_slices.push_back( slice );
+    }
+  }
+  bool is_fitting = ( m_slices.size() <= MAX_SLICES );
+  if( !is_fitting ) {
+    m_slices.clear();
+  }
+
+  std::stable_sort( m_slices.begin(), m_slices.end(), []( const ArtNetUniverseSlice& a, const ArtNetUniverseSlice& b ) {
+    return a.universe < b.universe;
+  } );
+
+  // Size the table to at least twice the number of universes.
+  size_t universes = 1;
+  for( size_t i = 1; i < m_slices.size(); i++ ) {
+    if( m_slices[ i ].universe != m_slices[ i - 1 ].universe ) {
+      universes++;
+    }
+  }
+  size_t size = 8;
+  while( size < universes * 2 + 2 ) {
+    size *= 2;
+  }
+
+  m_entries.assign( size, Entry{ EMPTY, 0, 0, false, 0 } );
+  m_mask           = (uint16_t)( size - 1 );
+  m_universe_count = 0;
+
+  for( size_t i = 0; i < m_slices.size(); i++ ) {
+    Entry* ptr_entry = this->Insert( m_slices[ i ].universe );
+    if( ptr_entry->m_slice_count == 0 ) {
+      ptr_entry->m_slice_first = (uint8_t)i;
+    }
+    ptr_entry->m_slice_count++;
+  }
+
+  if( routed_universe <= 0x7FFF ) {
+    this->Insert( routed_universe )->m_is_routed = true;
+  }
+
+  return is_fitting;
+}
+
+ArtNetUniverseMap::Entry* ArtNetUniverseMap::Insert( uint16_t universe ) {
+  uint16_t index = Hash( universe ) & m_mask;
+  while( m_entries[ index ].m_universe != universe ) {
+    if( m_entries[ index ].m_universe == EMPTY ) {
+      m_entries[ index ].m_universe = universe;
+      m_entries[ index ].m_index    = (uint16_t)m_universe_count;
+      m_universe_count++;
+      break;
+    }
+    index = ( index + 1 ) & m_mask;
+  }
+  return &m_entries[ index ];
+}
+
+const ArtNetUniverseSlice* ArtNetUniverseMap::GetSlices() const {
+  return m_slices.data();
+}
+
+size_t ArtNetUniverseMap::GetUniverseCount() const {
+  return m_universe_count;
+}
+
+std::vector<uint16_t> ArtNetUniverseMap::GetUniverses() const {
+  std::vector<uint16_t> universes( m_universe_count );
+  for( const Entry& entry : m_entries ) {
+    if( entry.m_universe != EMPTY ) {
+      universes[ entry.m_index ] = entry.m_universe;
+    }
+  }
+  return universes;
+}
@@ -0,0 +1,79 @@
+#ifndef _ARTNETUNIVERSEMAP_H_
+#define _ARTNETUNIVERSEMAP_H_
+
+#include <Arduino.h>
+#include <vector>
+
+// Channels input_channel .. input_channel + count - 1 of an Art-Net universe,
+// copied to a DMX port starting at output_channel.  Channels are 1 - 512.
+struct ArtNetUniverseSlice {
+  uint16_t universe;          // 15 bit Art-Net port-address ( Net << 8 | SubUni ).
+  uint16_t input_channel;
+  uint16_t output_channel;
+  uint16_t count;
+  uint8_t  port;              // 0 based DMX port index.
+};
+
+// Maps the port-address of an incoming ArtDMX packet to what the node does
+// with it, in constant time however many universes are on the network.
+//
+// An open addressing hash table, kept at most half full, so both subscribed
+// and unsubscribed universes resolve in one or two probes.
+class ArtNetUniverseMap {
+public:
+  struct Entry {
+    uint16_t m_universe;
+    uint8_t  m_slice_first;   // Index into GetSlices().
+    uint8_t  m_slice_count;
+    bool     m_is_routed;     // The DMX routing table takes its input from this universe (for port 1).
+    uint16_t m_index;         // 0 .. GetUniverseCount() - 1, in no particular order.
+  };
+
+  static const size_t MAX_SLICES = 255;
+
+  ArtNetUniverseMap();
+
+  ~ArtNetUniverseMap();
+
+  // False when there are more than MAX_SLICES slices to copy, which is
+  // nothing compiled but the routed universe.
+  bool Compile( const std::vector<ArtNetUniverseSlice>& slices, uint16_t routed_universe );
+
+  const Entry* Find( uint16_t universe ) const {
+    uint16_t index = Hash( universe ) & m_mask;
+    while( true ) {
+      const Entry& entry = m_entries[ index ];
+      if( entry.m_universe == universe ) {
+        return &entry;
+      }
+      if( entry.m_universe == EMPTY ) {
+        return nullptr;
+      }
+      index = ( index + 1 ) & m_mask;
+    }
+  }
+
+  const ArtNetUniverseSlice* GetSlices() const;
+
+  size_t GetUniverseCount() const;
+
+  // The subscribed port-addresses, by Entry::m_index.
+  std::vector<uint16_t> GetUniverses() const;
+
+private:
+  static const uint16_t EMPTY = 0xFFFF;   // Never a valid port-address, they are 15 bits.
+
+  static uint16_t Hash( uint16_t universe ) {
+    // Consecutive universes are the common case; spread them over the table.
+    return (uint16_t)( ( universe * 40503u ) >> 5 );
+  }
+
+  Entry* Insert( uint16_t universe );
+
+  std::vector<Entry>               m_entries;
+  uint16_t                         m_mask;
+  std::vector<ArtNetUniverseSlice> m_slices;    // Grouped by universe.
+  size_t                           m_universe_count;
+};
+
+#endif
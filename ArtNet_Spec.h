@@ -9,7 +9,8 @@
 //    Art-Net Packet Header  (First 10 bytes)
 //    Art-Net Packet DMX (Standard dmx packet structure)
 //    Art-Net Packet Poll
-//    Art-Net Packet Poll Reply
+//    Art-Net Packet Poll Reply (in full)
+//    Art-Net Packet Sync (OpCode and size only, it carries nothing)
 
 #define ARTNET_HEADER_ID        "Art-Net"
 #define ARTNET_VERSION          14
@@ -17,11 +18,14 @@
 #define ARTNET_OPCODE_POLL      0x2000
 #define ARTNET_OPCODE_POLLREPLY 0x2100
 #define ARTNET_OPCODE_DMX       0x5000
+#define ARTNET_OPCODE_SYNC      0x5200
 
 #define ARTNET_PACKET_MINSIZE_HEADER    10
 #define ARTNET_PACKET_MINSIZE_DMX       21
 #define ARTNET_PACKET_MINSIZE_POLL      14
 #define ARTNET_PACKET_MINSIZE_POLLREPLY 207
+#define ARTNET_PACKET_MINSIZE_SYNC      14
+#define ARTNET_PACKET_SIZE_POLLREPLY    239   // With every field up to the filler.
 #define ARTNET_PACKET_MAXSIZE           530   // DMX = 10 for header + 8 packet info + 512 dmx data. To Check: Any other packets go larger?
 #define ARTNET_PACKET_PAYLOAD_START     10
 
@@ -95,7 +99,18 @@ typedef struct ArtNetPacketPollReply
   uint8_t  m_MAC_4;             // 35:
   uint8_t  m_MAC_5;             // 36:
   uint8_t  m_MAC_6_Lo;          // 37:
-
+  uint8_t  m_BindIp[ 4 ];       // 38: IP of the root device when the node's ports are split over several replies.
+  uint8_t  m_BindIndex;         // 39: Which of those replies, 1 based.
+  uint8_t  m_Status2;           // 40:
+  uint8_t  m_GoodOutputB[ 4 ];  // 41:
+  uint8_t  m_Status3;           // 42:
+  uint8_t  m_DefaultRespUID[ 6 ]; // 43: RDMnet & LLRP default responder UID.
+  uint8_t  m_UserHi;            // 44:
+  uint8_t  m_UserLo;            // 45:
+  uint8_t  m_RefreshRateHi;     // 46: Maximum refresh rate in Hz, 44 for DMX512.
+  uint8_t  m_RefreshRateLo;     // 47:
+  uint8_t  m_BackgroundQueuePolicy; // 48:
+  uint8_t  m_Filler[ 10 ];      // 49: Transmit as zero.
 } __attribute__( ( packed ) ) ArtNetPacketPollReply;
 
 #pragma pack( pop ) // Restore original packing alignment
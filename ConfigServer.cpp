@@ -43,13 +43,35 @@ void ConfigServer::ResetESP32PinsToDefault() {
   m_gpio_enable      = 21;  // Connect to DE & RE on MAX485.
   m_gpio_transmit    = 33;  // Connected to DI on MAX485.
   m_gpio_receive     = 38;  // Ensure pin is not connected to anything.
+
+  // Additional DMX ports, off until wired up.
+  for( int i = 0; i < DMX_PORT_MAX - 1; i++ ) {
+    m_dmx_extra_ports[ i ].enabled         = false;
+    m_dmx_extra_ports[ i ].gpio_enable     = 18 - i * 3;
+    m_dmx_extra_ports[ i ].gpio_transmit   = 17 - i * 3;
+    m_dmx_extra_ports[ i ].gpio_receive    = 16 - i * 3;
+    m_dmx_extra_ports[ i ].artnet_universe = 2 + i;
+  }
 }
 
 void ConfigServer::ResetArtnet2DMXToDefault() {
   m_artnet_source_ip       = "255.255.255.255";  // Any IP source is fine.
   m_artnet_universe        = 1;                  // Universe to listen for, all other universes are ignored.
+  m_artnet_universe_slices.clear();              // All of the above universe straight through.
+  m_dmx_curves.clear();                          // Channels sent as they are.
+  m_dmx_interpolate        = false;              // Channels step to each new frame.
+  m_dmx_interpolation_channels.clear();          // Every channel 8 bit and interpolated.
   m_artnet_timeout_ms      = 3000;               // Artnet timeout
+  m_artnet_merge_ltp       = false;              // HTP, as Art-Net does by default.
+  m_artnet_merge_timeout_ms = 10000;             // Art-Net's own source timeout.
+  m_artnet_sync_timeout_ms = 4000;               // Art-Net's own ArtSync timeout.
+  m_sacn_enabled           = false;              // Art-Net only.
   m_dmx_update_interval_ms = 23;                 // Roughly 4hz
+  m_dmx_send_on_receive    = false;              // Send at the interval above.
+  m_dmx_min_frame_gap_us   = 0;                  // Back to back is fine for most fixtures.
+  m_dmx_min_frame_channels = 24;                 // Shortest frame DMX allows.
+  m_dmx_jitter_delay_ms    = 0;                  // No jitter buffer, the newest frame goes out.
+  m_dmx_routing_only       = false;              // Routes merge onto the universe copied straight through.
 }
 
 void ConfigServer::SettingsSave() {
@@ -64,7 +86,16 @@ void ConfigServer::SettingsSave() {
   doc[ "artnet_source_ip" ]       = m_artnet_source_ip;
   doc[ "artnet_universe" ]        = m_artnet_universe;
   doc[ "artnet_timeout_ms" ]      = m_artnet_timeout_ms;
+  doc[ "artnet_merge_ltp" ]       = m_artnet_merge_ltp;
+  doc[ "artnet_merge_timeout_ms" ] = m_artnet_merge_timeout_ms;
+  doc[ "artnet_sync_timeout_ms" ] = m_artnet_sync_timeout_ms;
+  doc[ "sacn_enabled" ]           = m_sacn_enabled;
   doc[ "dmx_update_interval_ms" ] = m_dmx_update_interval_ms;
+  doc[ "dmx_send_on_receive" ]    = m_dmx_send_on_receive;
+  doc[ "dmx_min_frame_gap_us" ]   = m_dmx_min_frame_gap_us;
+  doc[ "dmx_min_frame_channels" ] = m_dmx_min_frame_channels;
+  doc[ "dmx_jitter_delay_ms" ]    = m_dmx_jitter_delay_ms;
+  doc[ "dmx_routing_only" ]       = m_dmx_routing_only;
 
   // Start LittleFS
   if( !LittleFS.begin( false ) ) {
@@ -77,14 +108,63 @@ void ConfigServer::SettingsSave() {
     }
   }
 
+  JsonArray extra_ports = doc.createNestedArray( "dmx_extra_ports" );
+  for( const DMXPortConfig& port : m_dmx_extra_ports ) {
+    JsonObject extra_port = extra_ports.createNestedObject();
+    extra_port[ "enabled" ]         = port.enabled;
+    extra_port[ "gpio_enable" ]     = port.gpio_enable;
+    extra_port[ "gpio_transmit" ]   = port.gpio_transmit;
+    extra_port[ "gpio_receive" ]    = port.gpio_receive;
+    extra_port[ "artnet_universe" ] = port.artnet_universe;
+  }
+
+  JsonArray universe_slices = doc.createNestedArray( "artnet_universe_slices" );
+  for( const ArtNetUniverseSlice& slice : m_artnet_universe_slices ) {
+    JsonObject universe_slice = universe_slices.createNestedObject();
+    universe_slice[ "universe" ]       = slice.universe;
+    universe_slice[ "input_channel" ]  = slice.input_channel;
+    universe_slice[ "output_channel" ] = slice.output_channel;
+    universe_slice[ "count" ]          = slice.count;
+  }
+
+  JsonArray dmx_curves = doc.createNestedArray( "dmx_curves" );
+  for( const DMXCurveAssignment& assignment : m_dmx_curves ) {
+    JsonObject dmx_curve = dmx_curves.createNestedObject();
+    dmx_curve[ "port" ]    = assignment.port;
+    dmx_curve[ "channel" ] = assignment.channel;
+    dmx_curve[ "count" ]   = assignment.count;
+    dmx_curve[ "gamma" ]   = assignment.curve.gamma;
+    dmx_curve[ "scale" ]   = assignment.curve.scale;
+    dmx_curve[ "invert" ]  = assignment.curve.invert;
+    dmx_curve[ "min" ]     = assignment.curve.min;
+    dmx_curve[ "max" ]     = assignment.curve.max;
+  }
+
+  doc[ "dmx_interpolate" ] = m_dmx_interpolate;
+  JsonArray interpolation_channels = doc.createNestedArray( "dmx_interpolation_channels" );
+  for( const DMXInterpolationAssignment& assignment : m_dmx_interpolation_channels ) {
+    JsonObject interpolation_channel = interpolation_channels.createNestedObject();
+    interpolation_channel[ "port" ]         = assignment.port;
+    interpolation_channel[ "channel" ]      = assignment.channel;
+    interpolation_channel[ "count" ]        = assignment.count;
+    interpolation_channel[ "fine_channel" ] = assignment.fine_channel;
+  }
+
   JsonArray routing_configs = doc.createNestedArray("dmx_routing_configs");
 
-  for (const DMXRoutingConfig& config : m_dmx_routing_configs) {
+  for (size_t i = 0; i < m_dmx_routing_table.Size(); i++) {
+    const DMXRoutingConfig& config = m_dmx_routing_table.GetRoute(i);
+    const uint16_t* ptr_output_channels = m_dmx_routing_table.GetOutputChannels(i);
     JsonObject routing_config = routing_configs.createNestedObject();
+    routing_config["merge"] = DMXRoutingTable::GetMergeOperatorName(config.merge_operator);
+    if (config.input_count > 1) {
+      routing_config["block"] = m_dmx_routing_table.FormatBlock(i);
+      continue;
+    }
     routing_config["input_channel"] = config.input_channel;
     JsonArray output_channels = routing_config.createNestedArray("output_channels");
-    for (uint8_t output_channel : config.output_channels) {
-      output_channels.add(output_channel);
+    for (uint16_t j = 0; j < config.output_count; j++) {
+      output_channels.add(ptr_output_channels[j]);
     }
   }
 
@@ -118,13 +198,76 @@ bool ConfigServer::SettingsLoad() {
   m_wifi_pass              = doc[ "wifi_pass" ].as<String>();
   m_wifi_ip                = doc[ "wifi_ip" ].as<String>();
   m_wifi_subnet            = doc[ "wifi_subnet" ].as<String>();
-  m_gpio_enable            = doc[ "gpio_enable" ];
-  m_gpio_transmit          = doc[ "gpio_transmit" ];
-  m_gpio_receive           = doc[ "gpio_receive" ];
   m_artnet_source_ip       = doc[ "artnet_source_ip" ].as<String>();
   m_artnet_universe        = doc[ "artnet_universe" ];
   m_artnet_timeout_ms      = doc[ "artnet_timeout_ms" ];
+  m_artnet_merge_ltp       = doc[ "artnet_merge_ltp" ].as<bool>();
+  m_artnet_merge_timeout_ms = doc[ "artnet_merge_timeout_ms" ];
+  m_artnet_sync_timeout_ms = doc[ "artnet_sync_timeout_ms" ];
+  m_sacn_enabled           = doc[ "sacn_enabled" ].as<bool>();
   m_dmx_update_interval_ms = doc[ "dmx_update_interval_ms" ];
+  m_dmx_send_on_receive    = doc[ "dmx_send_on_receive" ].as<bool>();
+  m_dmx_min_frame_gap_us   = doc[ "dmx_min_frame_gap_us" ];
+  m_dmx_min_frame_channels = doc[ "dmx_min_frame_channels" ];
+  m_dmx_jitter_delay_ms    = doc[ "dmx_jitter_delay_ms" ];
+  m_dmx_routing_only       = doc[ "dmx_routing_only" ].as<bool>();
+
+  this->ResetESP32PinsToDefault();
+  m_gpio_enable            = doc[ "gpio_enable" ];
+  m_gpio_transmit          = doc[ "gpio_transmit" ];
+  m_gpio_receive           = doc[ "gpio_receive" ];
+
+  int port_index = 0;
+  for( JsonObject extra_port : doc[ "dmx_extra_ports" ].as<JsonArray>() ) {
+    if( port_index >= DMX_PORT_MAX - 1 ) {
+      break;
+    }
+    DMXPortConfig& port = m_dmx_extra_ports[ port_index++ ];
+    port.enabled         = extra_port[ "enabled" ].as<bool>();
+    port.gpio_enable     = extra_port[ "gpio_enable" ];
+    port.gpio_transmit   = extra_port[ "gpio_transmit" ];
+    port.gpio_receive    = extra_port[ "gpio_receive" ];
+    port.artnet_universe = extra_port[ "artnet_universe" ];
+  }
+
+  m_artnet_universe_slices.clear();
+  for( JsonObject universe_slice : doc[ "artnet_universe_slices" ].as<JsonArray>() ) {
+    if( m_artnet_universe_slices.size() >= MAX_UNIVERSE_SLICES ) {
+      break;
+    }
+    ArtNetUniverseSlice slice;
+    slice.universe       = universe_slice[ "universe" ].as<uint16_t>();
+    slice.input_channel  = universe_slice[ "input_channel" ].as<uint16_t>();
+    slice.output_channel = universe_slice[ "output_channel" ].as<uint16_t>();
+    slice.count          = universe_slice[ "count" ].as<uint16_t>();
+    slice.port           = 0;
+    m_artnet_universe_slices.push_back( slice );
+  }
+
+  m_dmx_curves.clear();
+  for( JsonObject dmx_curve : doc[ "dmx_curves" ].as<JsonArray>() ) {
+    DMXCurveAssignment assignment;
+    assignment.port         = dmx_curve[ "port" ].as<uint8_t>();
+    assignment.channel      = dmx_curve[ "channel" ].as<uint16_t>();
+    assignment.count        = dmx_curve[ "count" ].as<uint16_t>();
+    assignment.curve.gamma  = dmx_curve[ "gamma" ].as<uint16_t>();
+    assignment.curve.scale  = dmx_curve.containsKey( "scale" ) ? dmx_curve[ "scale" ].as<uint16_t>() : 100;
+    assignment.curve.invert = dmx_curve[ "invert" ].as<bool>();
+    assignment.curve.min    = dmx_curve[ "min" ].as<uint8_t>();
+    assignment.curve.max    = dmx_curve.containsKey( "max" ) ? dmx_curve[ "max" ].as<uint8_t>() : 255;
+    m_dmx_curves.push_back( assignment );
+  }
+
+  m_dmx_interpolate = doc[ "dmx_interpolate" ].as<bool>();
+  m_dmx_interpolation_channels.clear();
+  for( JsonObject interpolation_channel : doc[ "dmx_interpolation_channels" ].as<JsonArray>() ) {
+    DMXInterpolationAssignment assignment;
+    assignment.port         = interpolation_channel[ "port" ].as<uint8_t>();
+    assignment.channel      = interpolation_channel[ "channel" ].as<uint16_t>();
+    assignment.count        = interpolation_channel[ "count" ].as<uint16_t>();
+    assignment.fine_channel = interpolation_channel[ "fine_channel" ].as<uint16_t>();
+    m_dmx_interpolation_channels.push_back( assignment );
+  }
 
   LoadDMXRoutingConfigs();
 
@@ -139,31 +282,259 @@ void ConfigServer::LoadDMXRoutingConfigs() {
     deserializeJson(doc, config_file);
     config_file.close();
 
+    m_dmx_routing_table.Clear();
+
     JsonArray routing_configs = doc["dmx_routing_configs"].as<JsonArray>();
+    std::vector<uint16_t> output_channels;
     for (JsonObject routing_config : routing_configs) {
-      DMXRoutingConfig config;
-      config.input_channel = routing_config["input_channel"];
+      uint16_t input_channel = routing_config["input_channel"].as<uint16_t>();
+      // Routes saved before there was a choice of operator are HTP.
+      uint8_t merge_operator = DMXRoutingTable::FindMergeOperator(routing_config["merge"].as<String>());
+      if (routing_config.containsKey("block")) {
+        AddDMXRoutingBlock(routing_config["block"].as<String>(), merge_operator, false);
+        continue;
+      }
+      output_channels.clear();
       for (JsonVariant output_channel : routing_config["output_channels"].as<JsonArray>()) {
-        config.output_channels.push_back(output_channel.as<uint8_t>());
+        output_channels.push_back(output_channel.as<uint16_t>());
       }
-      m_dmx_routing_configs.push_back(config);
+      m_dmx_routing_table.Add(input_channel, output_channels, merge_operator);
     }
   }
 }
 
-void ConfigServer::AddDMXRoutingConfig(uint8_t input_channel, const std::vector<uint8_t>& output_channels) {
-  DMXRoutingConfig config;
-  config.input_channel = input_channel;
-  config.output_channels = output_channels;
-  m_dmx_routing_configs.push_back(config);
-  SettingsSave();
+void ConfigServer::AddDMXRoutingConfig(uint16_t input_channel, const std::vector<uint16_t>& output_channels, uint8_t merge_operator) {
+  if (m_dmx_routing_table.Add(input_channel, output_channels, merge_operator)) {
+    SettingsSave();
+  }
+}
+
+bool ConfigServer::AddDMXRoutingBlock(const String& block_str, uint8_t merge_operator, bool is_saving) {
+  uint16_t input_channel = 0;
+  uint16_t input_count = 0;
+  uint16_t output_channel = 0;
+  uint8_t output_stride = 1;
+  if (!DMXRoutingTable::ParseBlock(block_str, input_channel, input_count, output_channel, output_stride) ||
+      !m_dmx_routing_table.Add(input_channel, { output_channel }, merge_operator, input_count, output_stride)) {
+    return false;
+  }
+  if (is_saving) {
+    SettingsSave();
+  }
+  return true;
 }
 
 void ConfigServer::ClearDMXRoutingConfigs() {
-  m_dmx_routing_configs.clear();
+  m_dmx_routing_table.Clear();
   SettingsSave();
 }
 
+void ConfigServer::ParseDMXChannelList( const String& channels_str, std::vector<uint16_t>& channels ) {
+  // Comma separated DMX channels, anything outside 1 - 512 is dropped.
+  int start = 0;
+  int end = channels_str.indexOf( ',' );
+  while( true ) {
+    long channel = ( end == -1 ) ? channels_str.substring( start ).toInt() : channels_str.substring( start, end ).toInt();
+    if( channel >= 1 && channel <= 512 ) {
+      channels.push_back( (uint16_t)channel );
+    }
+    if( end == -1 ) {
+      break;
+    }
+    start = end + 1;
+    end = channels_str.indexOf( ',', start );
+  }
+}
+
+void ConfigServer::ParseUniverseSlices( const String& slices_str, std::vector<ArtNetUniverseSlice>& slices ) {
+  // Comma separated "universe:first-last@output", e.g. "3:1-100@1, 7:1-412@101".
+  // Malformed entries are dropped and ranges are clipped to the 512 DMX channels.
+  int start = 0;
+  while( start < (int)slices_str.length() && slices.size() < MAX_UNIVERSE_SLICES ) {
+    int end = slices_str.indexOf( ',', start );
+    String entry = ( end == -1 ) ? slices_str.substring( start ) : slices_str.substring( start, end );
+    start = ( end == -1 ) ? slices_str.length() : end + 1;
+
+    entry.trim();
+    int colon = entry.indexOf( ':' );
+    int dash  = entry.indexOf( '-', colon + 1 );
+    int at    = entry.indexOf( '@', dash + 1 );
+    if( colon <= 0 || dash == -1 || at == -1 ) {
+      continue;
+    }
+
+    long universe = entry.substring( 0, colon ).toInt();
+    long first    = entry.substring( colon + 1, dash ).toInt();
+    long last     = entry.substring( dash + 1, at ).toInt();
+    long output   = entry.substring( at + 1 ).toInt();
+
+    if( universe < 0 || universe > 0x7FFF || first < 1 || last > 512 || first > last || output < 1 || output > 512 ) {
+      continue;
+    }
+
+    ArtNetUniverseSlice slice;
+    slice.universe       = (uint16_t)universe;
+    slice.input_channel  = (uint16_t)first;
+    slice.output_channel = (uint16_t)output;
+    slice.count          = (uint16_t)std::min( last - first + 1, 513 - output );
+    slice.port           = 0;
+    slices.push_back( slice );
+  }
+}
+
+void ConfigServer::ParseDMXCurves( const String& curves_str, std::vector<DMXCurveAssignment>& curves ) {
+  // Comma separated "port:first-last" followed by what to do to the channels,
+  // e.g. "1-16 gamma2.2 max200, 2:17 invert scale50".  The port defaults to 1
+  // and a single channel needs no "-last".  Malformed entries are dropped.
+  int start = 0;
+  while( start < (int)curves_str.length() ) {
+    int end = curves_str.indexOf( ',', start );
+    String entry = ( end == -1 ) ? curves_str.substring( start ) : curves_str.substring( start, end );
+    start = ( end == -1 ) ? curves_str.length() : end + 1;
+
+    entry.trim();
+    int space = entry.indexOf( ' ' );
+    String channels = ( space == -1 ) ? entry : entry.substring( 0, space );
+    int colon = channels.indexOf( ':' );
+    int dash  = channels.indexOf( '-', colon + 1 );
+
+    long port  = ( colon == -1 ) ? 1 : channels.substring( 0, colon ).toInt();
+    long first = ( dash == -1 ) ? channels.substring( colon + 1 ).toInt() : channels.substring( colon + 1, dash ).toInt();
+    long last  = ( dash == -1 ) ? first : channels.substring( dash + 1 ).toInt();
+    if( port < 1 || port > DMX_PORT_MAX || first < 1 || last > 512 || first > last ) {
+      continue;
+    }
+
+    DMXCurveAssignment assignment;
+    assignment.port    = (uint8_t)( port - 1 );
+    assignment.channel = (uint16_t)first;
+    assignment.count   = (uint16_t)( last - first + 1 );
+    assignment.curve   = { 100, 100, false, 0, 255 };
+
+    while( space != -1 ) {
+      int next = entry.indexOf( ' ', space + 1 );
+      String option = ( next == -1 ) ? entry.substring( space + 1 ) : entry.substring( space + 1, next );
+      space = next;
+      if( option.startsWith( "gamma" ) ) {
+        assignment.curve.gamma = (uint16_t)std::max( 1L, std::min( 1000L, lroundf( option.substring( 5 ).toFloat() * 100 ) ) );
+      } else if( option.startsWith( "scale" ) ) {
+        assignment.curve.scale = (uint16_t)std::max( 0L, std::min( 1000L, option.substring( 5 ).toInt() ) );
+      } else if( option.startsWith( "min" ) ) {
+        assignment.curve.min = (uint8_t)std::max( 0L, std::min( 255L, option.substring( 3 ).toInt() ) );
+      } else if( option.startsWith( "max" ) ) {
+        assignment.curve.max = (uint8_t)std::max( 0L, std::min( 255L, option.substring( 3 ).toInt() ) );
+      } else if( option == "invert" ) {
+        assignment.curve.invert = true;
+      }
+    }
+    curves.push_back( assignment );
+  }
+}
+
+String ConfigServer::FormatDMXCurves() {
+  String curves_str;
+  for( const DMXCurveAssignment& assignment : m_dmx_curves ) {
+    if( curves_str.length() > 0 ) {
+      curves_str += ", ";
+    }
+    curves_str += String( assignment.port + 1 ) + ":" + String( assignment.channel );
+    if( assignment.count > 1 ) {
+      curves_str += "-" + String( assignment.channel + assignment.count - 1 );
+    }
+    if( assignment.curve.gamma != 100 ) {
+      curves_str += " gamma" + String( assignment.curve.gamma / 100.0f );
+    }
+    if( assignment.curve.scale != 100 ) {
+      curves_str += " scale" + String( assignment.curve.scale );
+    }
+    if( assignment.curve.invert ) {
+      curves_str += " invert";
+    }
+    if( assignment.curve.min != 0 ) {
+      curves_str += " min" + String( assignment.curve.min );
+    }
+    if( assignment.curve.max != 255 ) {
+      curves_str += " max" + String( assignment.curve.max );
+    }
+  }
+  return curves_str;
+}
+
+void ConfigServer::ParseDMXInterpolationChannels( const String& channels_str, std::vector<DMXInterpolationAssignment>& assignments ) {
+  // Comma separated "port:coarse/fine" for a 16 bit pair and "port:first-last snap"
+  // for channels that jump, e.g. "1/2, 3/4, 7-8 snap, 2:5/6".  The port
+  // defaults to 1.  Malformed entries are dropped.
+  int start = 0;
+  while( start < (int)channels_str.length() ) {
+    int end = channels_str.indexOf( ',', start );
+    String entry = ( end == -1 ) ? channels_str.substring( start ) : channels_str.substring( start, end );
+    start = ( end == -1 ) ? channels_str.length() : end + 1;
+
+    entry.trim();
+    int space = entry.indexOf( ' ' );
+    String channels = ( space == -1 ) ? entry : entry.substring( 0, space );
+    String option   = ( space == -1 ) ? String( "" ) : entry.substring( space + 1 );
+    option.trim();
+    int colon = channels.indexOf( ':' );
+    int slash = channels.indexOf( '/', colon + 1 );
+    int dash  = channels.indexOf( '-', colon + 1 );
+
+    DMXInterpolationAssignment assignment;
+    long port = ( colon == -1 ) ? 1 : channels.substring( 0, colon ).toInt();
+    if( slash != -1 ) {
+      long coarse = channels.substring( colon + 1, slash ).toInt();
+      long fine   = channels.substring( slash + 1 ).toInt();
+      if( port < 1 || port > DMX_PORT_MAX || coarse < 1 || coarse > 512 || fine < 1 || fine > 512 || coarse == fine ) {
+        continue;
+      }
+      assignment.channel      = (uint16_t)coarse;
+      assignment.count        = 1;
+      assignment.fine_channel = (uint16_t)fine;
+    } else {
+      long first = ( dash == -1 ) ? channels.substring( colon + 1 ).toInt() : channels.substring( colon + 1, dash ).toInt();
+      long last  = ( dash == -1 ) ? first : channels.substring( dash + 1 ).toInt();
+      if( option != "snap" || port < 1 || port > DMX_PORT_MAX || first < 1 || last > 512 || first > last ) {
+        continue;
+      }
+      assignment.channel      = (uint16_t)first;
+      assignment.count        = (uint16_t)( last - first + 1 );
+      assignment.fine_channel = 0;
+    }
+    assignment.port = (uint8_t)( port - 1 );
+    assignments.push_back( assignment );
+  }
+}
+
+String ConfigServer::FormatDMXInterpolationChannels() {
+  String channels_str;
+  for( const DMXInterpolationAssignment& assignment : m_dmx_interpolation_channels ) {
+    if( channels_str.length() > 0 ) {
+      channels_str += ", ";
+    }
+    channels_str += String( assignment.port + 1 ) + ":" + String( assignment.channel );
+    if( assignment.fine_channel != 0 ) {
+      channels_str += "/" + String( assignment.fine_channel );
+      continue;
+    }
+    if( assignment.count > 1 ) {
+      channels_str += "-" + String( assignment.channel + assignment.count - 1 );
+    }
+    channels_str += " snap";
+  }
+  return channels_str;
+}
+
+String ConfigServer::FormatUniverseSlices() {
+  String slices_str;
+  for( const ArtNetUniverseSlice& slice : m_artnet_universe_slices ) {
+    if( slices_str.length() > 0 ) {
+      slices_str += ", ";
+    }
+    slices_str += String( slice.universe ) + ":" + String( slice.input_channel ) + "-" + String( slice.input_channel + slice.count - 1 ) + "@" + String( slice.output_channel );
+  }
+  return slices_str;
+}
+
 void ConfigServer::StartWebServer( WebServer* ptr_WebServer ) {
   m_ptr_WebServer = ptr_WebServer;
   m_ptr_WebServer->begin();
@@ -336,6 +707,36 @@ void ConfigServer::SendESP32PinsSetupPage() {
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "GPIO Receive", "gpio_receive", String( m_gpio_receive ), "", true );
 
+  // Additional DMX ports, each on its own UART & MAX485.
+  for( int i = 0; i < DMX_PORT_MAX - 1; i++ ) {
+    const DMXPortConfig& port = m_dmx_extra_ports[ i ];
+    String prefix = "port" + String( i + 2 ) + "_";
+
+    m_WebpageBuilder.AddBreak( 3 );
+    m_WebpageBuilder.AddLabel( prefix + "enabled", "DMX Port " + String( i + 2 ) + " : " );
+    m_WebpageBuilder.AddEnabledSelection( prefix + "enabled", prefix + "enabled", port.enabled );
+    if( DMXPort::GetDMXNum( i + 1 ) == DMX_NUM_0 ) {
+      m_WebpageBuilder.AddBreak( 2 );
+      m_WebpageBuilder.AddLabel( prefix + "enabled", "Uses UART0, the serial console : serial logging stops while it is enabled." );
+    }
+    m_WebpageBuilder.AddBreak( 2 );
+    m_WebpageBuilder.AddLabel( prefix + "gpio_enable", "GPIO - Enable : Connnect to DE & RE on MAX485." );
+    m_WebpageBuilder.AddBreak( 1 );
+    m_WebpageBuilder.AddInputType( "number", prefix + "gpio_enable", prefix + "gpio_enable", String( port.gpio_enable ), "", true );
+    m_WebpageBuilder.AddBreak( 2 );
+    m_WebpageBuilder.AddLabel( prefix + "gpio_transmit", "GPIO - Transmit : Connnect to DI on MAX485." );
+    m_WebpageBuilder.AddBreak( 1 );
+    m_WebpageBuilder.AddInputType( "number", prefix + "gpio_transmit", prefix + "gpio_transmit", String( port.gpio_transmit ), "", true );
+    m_WebpageBuilder.AddBreak( 2 );
+    m_WebpageBuilder.AddLabel( prefix + "gpio_receive", "GPIO - Receive : Ensure GPIO is not connected." );
+    m_WebpageBuilder.AddBreak( 1 );
+    m_WebpageBuilder.AddInputType( "number", prefix + "gpio_receive", prefix + "gpio_receive", String( port.gpio_receive ), "", true );
+    m_WebpageBuilder.AddBreak( 2 );
+    m_WebpageBuilder.AddLabel( prefix + "artnet_universe", "Art-Net Universe : The Art-Net universe sent out of this port." );
+    m_WebpageBuilder.AddBreak( 1 );
+    m_WebpageBuilder.AddInputType( "number", prefix + "artnet_universe", prefix + "artnet_universe", String( port.artnet_universe ), "", true );
+  }
+
   // Submit button
   m_WebpageBuilder.AddBreak( 3 );
   m_WebpageBuilder.AddButton( "submit", "SUBMIT" );
@@ -369,17 +770,69 @@ void ConfigServer::SendArtnet2DMXSetupPage() {
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "text", "source ip", "artnet_source_ip", String( m_artnet_source_ip ), "xxx.xxx.xxx.xxx", true );
   m_WebpageBuilder.AddBreak( 2 );
-  m_WebpageBuilder.AddLabel( "Art-Net Universe", "Art-Net Universe : The Art-Net universe to translate into DMX. All other universes are ignored." );
+  m_WebpageBuilder.AddLabel( "Art-Net Universe", "Art-Net Universe : The Art-Net universe to translate into DMX, DMX routing also takes its input from it. All other universes are ignored unless patched below." );
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "Art-Net universe", "artnet_universe", String( m_artnet_universe ), "", true );
   m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Universe patch", "Universe patch : Build the DMX output from several universes as universe:first-last@output, comma separated.  Leave blank to send all of the universe above." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "Universe patch", "artnet_universe_slices", this->FormatUniverseSlices(), "3:1-100@1, 7:1-412@101", false );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX curves", "DMX curves : Gamma, scale (percent), invert, min and max per output channel, as port:first-last followed by what to do and comma separated.  The port defaults to 1." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "DMX curves", "dmx_curves", this->FormatDMXCurves(), "1-16 gamma2.2 max200, 2:17 invert", false );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "dmx_interpolate", "Interpolation : DMX frames sent between Art-Net frames move the channels smoothly towards the next one, for sources sending slower than the DMX refresh.  Disabled, channels step to each new frame." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "dmx_interpolate", "dmx_interpolate", m_dmx_interpolate );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Interpolation channels", "Interpolation channels : 16 bit pairs as port:coarse/fine, and channels that must jump (gobos, modes) as port:first-last snap, comma separated.  The port defaults to 1." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "text", "Interpolation channels", "dmx_interpolation_channels", this->FormatDMXInterpolationChannels(), "1/2, 3/4, 5-8 snap", false );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "dmx_routing_only", "Routed channels only : DMX port 1 sends only the channels the DMX routes write, the universe above isn't copied straight through first.  Disabled, routes merge onto the straight-through copy." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "dmx_routing_only", "dmx_routing_only", m_dmx_routing_only );
+  m_WebpageBuilder.AddBreak( 2 );
   m_WebpageBuilder.AddLabel( "Art-Net timeout in ms", "Art-Net timeout in ms.  If no data received after this time then everything is turned off.  Use 0 to disable." );
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "Art-Net timeout in ms", "artnet_timeout_ms", String( m_artnet_timeout_ms ), "", true );
   m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "artnet_merge_ltp", "LTP merge : When two sources send the same universe each channel follows whichever changed it last.  Disabled, the highest value wins (HTP)." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "artnet_merge_ltp", "artnet_merge_ltp", m_artnet_merge_ltp );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Art-Net merge timeout in ms", "Art-Net merge timeout in ms.  A source silent for this long stops being merged.  Use 0 for Art-Net's 10 seconds." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "Art-Net merge timeout in ms", "artnet_merge_timeout_ms", String( m_artnet_merge_timeout_ms ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Art-Net sync timeout in ms", "Art-Net sync timeout in ms.  Once a controller sends ArtSync, frames wait for it and all go out together; they go out as they arrive again after this long without one.  Use 0 for Art-Net's 4 seconds." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "Art-Net sync timeout in ms", "artnet_sync_timeout_ms", String( m_artnet_sync_timeout_ms ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "sacn_enabled", "sACN (E1.31) : Also receive sACN, multicast or unicast.  sACN universe N drives whatever Art-Net universe N does and merges with it; of several sACN sources only those of the highest priority are output." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "sacn_enabled", "sacn_enabled", m_sacn_enabled );
+  m_WebpageBuilder.AddBreak( 2 );
   m_WebpageBuilder.AddLabel( "DMX update interval in ms", "DMX interval update in milliseconds.  Only change this if you know what you're doing." );
   m_WebpageBuilder.AddBreak( 1 );
   m_WebpageBuilder.AddInputType( "number", "DMX update interval in ms", "dmx_update_ms", String( m_dmx_update_interval_ms ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "dmx_send_on_receive", "Send on receive : Start a DMX frame as soon as new Art-Net data arrives, for the lowest latency.  The update interval above is then only a keep-alive when no data arrives." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddEnabledSelection( "dmx_send_on_receive", "dmx_send_on_receive", m_dmx_send_on_receive );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX minimum frame gap in us", "Minimum gap between DMX frames in microseconds when sending on receive.  Raise it if fixtures miss back to back frames." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "DMX minimum frame gap in us", "dmx_min_frame_gap_us", String( m_dmx_min_frame_gap_us ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "DMX minimum frame channels", "Minimum DMX frame length in channels, 24 - 512.  Frames stop after the highest channel in use, which refreshes small rigs faster.  Use 512 to always send full frames." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "DMX minimum frame channels", "dmx_min_frame_channels", String( m_dmx_min_frame_channels ), "", true );
+  m_WebpageBuilder.AddBreak( 2 );
+  m_WebpageBuilder.AddLabel( "Jitter buffer delay in ms", "Jitter buffer delay in ms.  Frames arriving in bursts over WiFi are queued and sent on evenly, at the pace the source sends them, this long after they arrive.  Longer rides out worse WiFi but adds latency.  Use 0 to send the newest frame at once." );
+  m_WebpageBuilder.AddBreak( 1 );
+  m_WebpageBuilder.AddInputType( "number", "Jitter buffer delay in ms", "dmx_jitter_delay_ms", String( m_dmx_jitter_delay_ms ), "", true );
 
   // Submit button
   m_WebpageBuilder.AddBreak( 3 );
@@ -446,31 +899,35 @@ void ConfigServer::HandleWebServerData() {
 }
 
 void ConfigServer::SendDMXRoutingSetupPage() {
-  m_WebpageBuilder.AddDMXRoutingConfigTable(m_dmx_routing_configs);
+  m_WebpageBuilder.AddDMXRoutingConfigTable(m_dmx_routing_table);
   m_ptr_WebServer->send(200, "text/html", m_WebpageBuilder.m_html);
 }
 
 bool ConfigServer::HandleSetupDMXRouting() {
-  uint8_t input_channel = 0;
-  std::vector<uint8_t> output_channels;
+  uint16_t input_channel = 0;
+  std::vector<uint16_t> output_channels;
+  uint8_t merge_operator = DMX_MERGE_HTP;
+  String block_str;
 
   for (int i = 0; i < m_ptr_WebServer->args(); i++) {
     if (m_ptr_WebServer->argName(i) == "input_channel") {
       input_channel = m_ptr_WebServer->arg(i).toInt();
     } else if (m_ptr_WebServer->argName(i) == "output_channels") {
-      String output_channels_str = m_ptr_WebServer->arg(i);
-      int start = 0;
-      int end = output_channels_str.indexOf(',');
-      while (end != -1) {
-        output_channels.push_back(output_channels_str.substring(start, end).toInt());
-        start = end + 1;
-        end = output_channels_str.indexOf(',', start);
-      }
-      output_channels.push_back(output_channels_str.substring(start).toInt());
+      ParseDMXChannelList(m_ptr_WebServer->arg(i), output_channels);
+    } else if (m_ptr_WebServer->argName(i) == "block") {
+      block_str = m_ptr_WebServer->arg(i);
+    } else if (m_ptr_WebServer->argName(i) == "merge") {
+      merge_operator = DMXRoutingTable::FindMergeOperator(m_ptr_WebServer->arg(i));
     }
   }
 
-  AddDMXRoutingConfig(input_channel, output_channels);
+  // A block of channels, when given, rather than the single input channel.
+  block_str.trim();
+  if (!block_str.isEmpty()) {
+    AddDMXRoutingBlock(block_str, merge_operator, true);
+  } else if (input_channel >= 1 && input_channel <= 512 && !output_channels.empty()) {
+    AddDMXRoutingConfig(input_channel, output_channels, merge_operator);
+  }
   SendDMXRoutingSetupPage();
   return true;
 }
@@ -484,8 +941,9 @@ bool ConfigServer::HandleEditDMXRouting() {
     }
   }
 
-  if (index >= 0 && index < m_dmx_routing_configs.size()) {
-    const auto& config = m_dmx_routing_configs[index];
+  if (index >= 0 && (size_t)index < m_dmx_routing_table.Size()) {
+    const DMXRoutingConfig& config = m_dmx_routing_table.GetRoute(index);
+    const uint16_t* ptr_output_channels = m_dmx_routing_table.GetOutputChannels(index);
 
     m_WebpageBuilder.StartPage();
     m_WebpageBuilder.AddTitle("Edit DMX Routing Configuration");
@@ -494,18 +952,27 @@ bool ConfigServer::HandleEditDMXRouting() {
     m_WebpageBuilder.AddHeading("Edit DMX Routing Configuration");
 
     m_WebpageBuilder.AddFormAction("/update_dmx_routing", "POST");
-    m_WebpageBuilder.AddLabel("input_channel", "Input DMX Channel:");
-    m_WebpageBuilder.AddInputType("number", "input_channel", "input_channel", String(config.input_channel), "", true);
-    m_WebpageBuilder.AddBreak(2);
-    m_WebpageBuilder.AddLabel("output_channels", "Output DMX Channels (comma-separated):");
-    String output_channels_str;
-    for (size_t j = 0; j < config.output_channels.size(); ++j) {
-      output_channels_str += String(config.output_channels[j]);
-      if (j < config.output_channels.size() - 1) {
-        output_channels_str += ",";
+    if (config.input_count > 1) {
+      m_WebpageBuilder.AddLabel("block", "Block of DMX Channels (first-last > output, /n for every n-th output):");
+      m_WebpageBuilder.AddInputType("text", "block", "block", m_dmx_routing_table.FormatBlock(index), "1-100 > 201-300", true);
+      m_WebpageBuilder.AddBreak(2);
+    } else {
+      m_WebpageBuilder.AddLabel("input_channel", "Input DMX Channel (1-512):");
+      m_WebpageBuilder.AddInputType("number", "input_channel", "input_channel", String(config.input_channel), "", true);
+      m_WebpageBuilder.AddBreak(2);
+      m_WebpageBuilder.AddLabel("output_channels", "Output DMX Channels (1-512, comma-separated):");
+      String output_channels_str;
+      for (uint16_t j = 0; j < config.output_count; ++j) {
+        output_channels_str += String(ptr_output_channels[j]);
+        if (j < config.output_count - 1) {
+          output_channels_str += ",";
+        }
       }
+      m_WebpageBuilder.AddInputType("text", "output_channels", "output_channels", output_channels_str, "", true);
+      m_WebpageBuilder.AddBreak(2);
     }
-    m_WebpageBuilder.AddInputType("text", "output_channels", "output_channels", output_channels_str, "", true);
+    m_WebpageBuilder.AddLabel("merge", "Merge with the output channel:");
+    m_WebpageBuilder.AddMergeOperatorSelection("merge", "merge", config.merge_operator);
     m_WebpageBuilder.AddBreak(2);
     m_WebpageBuilder.AddInputType("hidden", "index", "index", String(index), "", false);
     m_WebpageBuilder.AddBreak(3);
@@ -535,8 +1002,8 @@ bool ConfigServer::HandleDeleteDMXRouting() {
     }
   }
 
-  if (index >= 0 && index < m_dmx_routing_configs.size()) {
-    m_dmx_routing_configs.erase(m_dmx_routing_configs.begin() + index);
+  if (index >= 0 && (size_t)index < m_dmx_routing_table.Size()) {
+    m_dmx_routing_table.Erase(index);
     SettingsSave();
     SendDMXRoutingSetupPage();
     return true;
@@ -547,8 +1014,10 @@ bool ConfigServer::HandleDeleteDMXRouting() {
 
 bool ConfigServer::HandleUpdateDMXRouting() {
   int index = -1;
-  uint8_t input_channel = 0;
-  std::vector<uint8_t> output_channels;
+  uint16_t input_channel = 0;
+  std::vector<uint16_t> output_channels;
+  uint8_t merge_operator = DMX_MERGE_HTP;
+  String block_str;
 
   for (int i = 0; i < m_ptr_WebServer->args(); i++) {
     if (m_ptr_WebServer->argName(i) == "index") {
@@ -556,21 +1025,31 @@ bool ConfigServer::HandleUpdateDMXRouting() {
     } else if (m_ptr_WebServer->argName(i) == "input_channel") {
       input_channel = m_ptr_WebServer->arg(i).toInt();
     } else if (m_ptr_WebServer->argName(i) == "output_channels") {
-      String output_channels_str = m_ptr_WebServer->arg(i);
-      int start = 0;
-      int end = output_channels_str.indexOf(',');
-      while (end != -1) {
-        output_channels.push_back(output_channels_str.substring(start, end).toInt());
-        start = end + 1;
-        end = output_channels_str.indexOf(',', start);
-      }
-      output_channels.push_back(output_channels_str.substring(start).toInt());
+      ParseDMXChannelList(m_ptr_WebServer->arg(i), output_channels);
+    } else if (m_ptr_WebServer->argName(i) == "block") {
+      block_str = m_ptr_WebServer->arg(i);
+    } else if (m_ptr_WebServer->argName(i) == "merge") {
+      merge_operator = DMXRoutingTable::FindMergeOperator(m_ptr_WebServer->arg(i));
     }
   }
 
-  if (index >= 0 && index < m_dmx_routing_configs.size()) {
-    m_dmx_routing_configs[index].input_channel = input_channel;
-    m_dmx_routing_configs[index].output_channels = output_channels;
+  uint16_t input_count = 1;
+  uint8_t output_stride = 1;
+  block_str.trim();
+  if (!block_str.isEmpty()) {
+    uint16_t output_channel = 0;
+    if (!DMXRoutingTable::ParseBlock(block_str, input_channel, input_count, output_channel, output_stride)) {
+      return false;
+    }
+    output_channels.assign(1, output_channel);
+  }
+
+  if (input_channel < 1 || input_channel > 512 || output_channels.empty()) {
+    return false;
+  }
+
+  if (index >= 0 && (size_t)index < m_dmx_routing_table.Size()) {
+    m_dmx_routing_table.Update(index, input_channel, output_channels, merge_operator, input_count, output_stride);
     SettingsSave();
     SendDMXRoutingSetupPage();
     return true;
@@ -679,6 +1158,27 @@ bool ConfigServer::HandleSetupESP32Pins() {
       m_gpio_transmit = m_ptr_WebServer->arg( i ).toInt();
     } else if( m_ptr_WebServer->argName( i ) == "gpio_receive" ) {
       m_gpio_receive = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ).startsWith( "port" ) ) {
+      // port<N>_<setting> for the additional DMX ports.
+      String name = m_ptr_WebServer->argName( i );
+      int underscore = name.indexOf( '_' );
+      int port_index = name.substring( 4, underscore ).toInt() - 2;
+      if( underscore == -1 || port_index < 0 || port_index >= DMX_PORT_MAX - 1 ) {
+        continue;
+      }
+      DMXPortConfig& port = m_dmx_extra_ports[ port_index ];
+      String setting = name.substring( underscore + 1 );
+      if( setting == "enabled" ) {
+        port.enabled = ( m_ptr_WebServer->arg( i ) == "Enabled" );
+      } else if( setting == "gpio_enable" ) {
+        port.gpio_enable = m_ptr_WebServer->arg( i ).toInt();
+      } else if( setting == "gpio_transmit" ) {
+        port.gpio_transmit = m_ptr_WebServer->arg( i ).toInt();
+      } else if( setting == "gpio_receive" ) {
+        port.gpio_receive = m_ptr_WebServer->arg( i ).toInt();
+      } else if( setting == "artnet_universe" ) {
+        port.artnet_universe = m_ptr_WebServer->arg( i ).toInt();
+      }
     }
   }
 
@@ -693,10 +1193,39 @@ bool ConfigServer::HandleSetupArtnet2DMX() {
       m_artnet_source_ip = m_ptr_WebServer->arg( i );
     } else if( m_ptr_WebServer->argName( i ) == "artnet_universe" ) {
       m_artnet_universe = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ) == "artnet_universe_slices" ) {
+      m_artnet_universe_slices.clear();
+      this->ParseUniverseSlices( m_ptr_WebServer->arg( i ), m_artnet_universe_slices );
     } else if( m_ptr_WebServer->argName( i ) == "dmx_update_ms" ) {
       m_dmx_update_interval_ms = m_ptr_WebServer->arg( i ).toInt();
     } else if( m_ptr_WebServer->argName( i ) == "artnet_timeout_ms" ) {
       m_artnet_timeout_ms = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ) == "artnet_merge_ltp" ) {
+      m_artnet_merge_ltp = ( m_ptr_WebServer->arg( i ) == "Enabled" );
+    } else if( m_ptr_WebServer->argName( i ) == "artnet_merge_timeout_ms" ) {
+      m_artnet_merge_timeout_ms = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ) == "artnet_sync_timeout_ms" ) {
+      m_artnet_sync_timeout_ms = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ) == "sacn_enabled" ) {
+      m_sacn_enabled = ( m_ptr_WebServer->arg( i ) == "Enabled" );
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_send_on_receive" ) {
+      m_dmx_send_on_receive = ( m_ptr_WebServer->arg( i ) == "Enabled" );
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_min_frame_gap_us" ) {
+      m_dmx_min_frame_gap_us = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_min_frame_channels" ) {
+      m_dmx_min_frame_channels = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_jitter_delay_ms" ) {
+      m_dmx_jitter_delay_ms = m_ptr_WebServer->arg( i ).toInt();
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_curves" ) {
+      m_dmx_curves.clear();
+      this->ParseDMXCurves( m_ptr_WebServer->arg( i ), m_dmx_curves );
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_interpolate" ) {
+      m_dmx_interpolate = ( m_ptr_WebServer->arg( i ) == "Enabled" );
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_interpolation_channels" ) {
+      m_dmx_interpolation_channels.clear();
+      this->ParseDMXInterpolationChannels( m_ptr_WebServer->arg( i ), m_dmx_interpolation_channels );
+    } else if( m_ptr_WebServer->argName( i ) == "dmx_routing_only" ) {
+      m_dmx_routing_only = ( m_ptr_WebServer->arg( i ) == "Enabled" );
     }
   }
 
@@ -7,17 +7,17 @@
 #include <ArduinoJson.h>
 #include "FS.h"
 #include "WebpageBuilder.h"
+#include "DMXRoutingTable.h"
+#include "ArtNetUniverseMap.h"
+#include "DMXPort.h"
+#include "DMXCurves.h"
+#include "DMXInterpolator.h"
 
 const String HOTSPOT_SSID = "ESP32_ArtNet2DMX";
 const String HOTSPOT_PASS = "1234567890";  // Has to be minimum 10 digits?
 
 const String CONFIG_FILENAME = "/config.json";
 
-struct DMXRoutingConfig {
-  uint8_t input_channel;
-  std::vector<uint8_t> output_channels;
-};
-
 class ConfigServer {
 public:
   ConfigServer();
@@ -45,16 +45,38 @@ public:
   int m_gpio_transmit;
   int m_gpio_receive;
 
+  // DMX ports 2 and up, port 1 is the GPIOs above with the Art-Net settings below.
+  DMXPortConfig m_dmx_extra_ports[ DMX_PORT_MAX - 1 ];
+
   String m_artnet_source_ip;
   int m_artnet_universe;
+  std::vector<ArtNetUniverseSlice> m_artnet_universe_slices;  // Empty : all of m_artnet_universe to DMX 1 - 512.
+
+  // The patch leaves room in ArtNetUniverseMap for the extra ports' universes.
+  static const size_t MAX_UNIVERSE_SLICES = ArtNetUniverseMap::MAX_SLICES - ( DMX_PORT_MAX - 1 );
   unsigned long m_artnet_timeout_ms;
-  unsigned long m_dmx_update_interval_ms;
+  bool m_artnet_merge_ltp;                  // Two sources on a universe merge LTP rather than HTP.
+  unsigned long m_artnet_merge_timeout_ms;  // A merging source drops out after this long silent, 0 is Art-Net's 10 s.
+  unsigned long m_artnet_sync_timeout_ms;   // Frames go out as they arrive again after this long without ArtSync, 0 is Art-Net's 4 s.
+  bool m_sacn_enabled;                      // Also receive sACN (E1.31), universe N being the Art-Net universe N.
+  unsigned long m_dmx_update_interval_ms;   // Refresh interval, the keep-alive when sending on receive.
+  bool m_dmx_send_on_receive;               // Start a DMX frame as soon as new Art-Net data arrives.
+  unsigned long m_dmx_min_frame_gap_us;     // Sending on receive : idle time between the end of a frame and the next.
+  int m_dmx_min_frame_channels;             // DMX frames stop after the highest channel in use, but are at least this long.
+  unsigned long m_dmx_jitter_delay_ms;      // Frames queue and play out evenly this long after arriving, 0 sends the newest at once.
+
+  std::vector<DMXCurveAssignment> m_dmx_curves;  // Response curves of output channels, on any port.
 
-  std::vector<DMXRoutingConfig> m_dmx_routing_configs;
+  bool m_dmx_interpolate;                   // Output channels move smoothly between Art-Net frames.
+  std::vector<DMXInterpolationAssignment> m_dmx_interpolation_channels;  // 16 bit pairs and snap channels, on any port.
+
+  DMXRoutingTable m_dmx_routing_table;
+  bool m_dmx_routing_only;                  // Port 1 sends the routed channels alone, without the universe copied through.
 
   void LoadDMXRoutingConfigs();
   void SaveDMXRoutingConfigs();
-  void AddDMXRoutingConfig(uint8_t input_channel, const std::vector<uint8_t>& output_channels);
+  void AddDMXRoutingConfig(uint16_t input_channel, const std::vector<uint16_t>& output_channels, uint8_t merge_operator);
+  bool AddDMXRoutingBlock(const String& block_str, uint8_t merge_operator, bool is_saving);
   void ClearDMXRoutingConfigs();
 
   // New functions for edit and delete functionality
@@ -85,6 +107,17 @@ private:
   bool HandleSetupArtnet2DMX();
   bool HandleSetupDMXRouting();
 
+  void ParseDMXChannelList( const String& channels_str, std::vector<uint16_t>& channels );
+
+  void ParseUniverseSlices( const String& slices_str, std::vector<ArtNetUniverseSlice>& slices );
+  String FormatUniverseSlices();
+
+  void ParseDMXCurves( const String& curves_str, std::vector<DMXCurveAssignment>& curves );
+  String FormatDMXCurves();
+
+  void ParseDMXInterpolationChannels( const String& channels_str, std::vector<DMXInterpolationAssignment>& assignments );
+  String FormatDMXInterpolationChannels();
+
   WebServer* m_ptr_WebServer;
   WebpageBuilder m_WebpageBuilder;
 
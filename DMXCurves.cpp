@@ -0,0 +1,77 @@
+#include "DMXCurves.h"
+
+#include <math.h>
+
+DMXCurves::DMXCurves() {
+}
+
+DMXCurves::~DMXCurves() {
+}
+
+void DMXCurves::Compile( const std::vector<DMXCurveAssignment>& assignments ) {
+  // The identity first, for channels without a curve.
+  m_tables.resize( 256 );
+  for( int i = 0; i < 256; i++ ) {
+    m_tables[ i ] = (uint8_t)i;
+  }
+  for( std::vector<uint8_t>& curve_indexes : m_curve_indexes ) {
+    curve_indexes.clear();
+  }
+
+  uint8_t table[ 256 ];
+  for( const DMXCurveAssignment& assignment : assignments ) {
+    if( assignment.port >= DMX_PORT_MAX || assignment.channel < 1 || assignment.channel > 512 ) {
+      continue;
+    }
+
+    // Share the table with any curve that came out the same.
+    BuildTable( assignment.curve, table );
+    size_t table_count = m_tables.size() / 256;
+    size_t index = 0;
+    while( index < table_count && memcmp( &m_tables[ index * 256 ], table, 256 ) != 0 ) {
+      index++;
+    }
+    if( index == table_count ) {
+      if( table_count == MAX_TABLES ) {
+        continue;
+      }
+      m_tables.insert( m_tables.end(), table, table + 256 );
+    }
+
+    std::vector<uint8_t>& curve_indexes = m_curve_indexes[ assignment.port ];
+    if( curve_indexes.empty() ) {
+      curve_indexes.assign( DMX_PACKET_SIZE, 0 );
+    }
+    uint16_t last = std::min<uint16_t>( assignment.channel + assignment.count - 1, 512 );
+    for( uint16_t channel = assignment.channel; channel <= last; channel++ ) {
+      curve_indexes[ channel ] = (uint8_t)index;
+    }
+  }
+
+  m_tables.shrink_to_fit();
+}
+
+const uint8_t* DMXCurves::GetCurveIndexes( int port_index ) const {
+  return m_curve_indexes[ port_index ].empty() ? nullptr : m_curve_indexes[ port_index ].data();
+}
+
+const uint8_t* DMXCurves::GetTables() const {
+  return m_tables.data();
+}
+
+size_t DMXCurves::GetTableCount() const {
+  return m_tables.size() / 256;
+}
+
+void DMXCurves::BuildTable( const DMXCurve& curve, uint8_t* table ) {
+  float gamma = ( curve.gamma > 0 ) ? curve.gamma / 100.0f : 1.0f;
+  for( int i = 0; i < 256; i++ ) {
+    float value = 255.0f * powf( i / 255.0f, gamma ) * curve.scale / 100.0f;
+    value = std::min( 255.0f, value );
+    if( curve.invert ) {
+      value = 255.0f - value;
+    }
+    value = std::max<float>( curve.min, std::min<float>( curve.max, value ) );
+    table[ i ] = (uint8_t)lroundf( value );
+  }
+}
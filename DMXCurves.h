@@ -0,0 +1,67 @@
+#ifndef _DMXCURVES_H_
+#define _DMXCURVES_H_
+
+#include <Arduino.h>
+#include <vector>
+
+#include "DMXPort.h"
+
+// How a DMX channel responds : the value is gamma corrected, scaled, inverted
+// and clamped, in that order.
+struct DMXCurve {
+  uint16_t gamma;             // In hundredths, 100 is linear and 220 the usual for LEDs.
+  uint16_t scale;             // Percent, 100 leaves the value as it is.
+  bool     invert;
+  uint8_t  min;
+  uint8_t  max;
+};
+
+// A curve on channels channel .. channel + count - 1 of a DMX port.  Channels are 1 - 512.
+struct DMXCurveAssignment {
+  uint8_t  port;              // 0 based DMX port index.
+  uint16_t channel;
+  uint16_t count;
+  DMXCurve curve;
+};
+
+// The curve assignments compiled into 256 byte lookup tables.
+//
+// Curves that come out the same share one table, and every channel of a port
+// refers to its table by a one byte index, table 0 being the identity for
+// channels without a curve.  Applying the curves to a frame is then one
+// lookup per channel with no branches.  Compile() is only called when the
+// config loads or changes.
+class DMXCurves {
+public:
+  DMXCurves();
+
+  ~DMXCurves();
+
+  void Compile( const std::vector<DMXCurveAssignment>& assignments );
+
+  // Table index per DMX slot of the port (slot 0, the start code, is always
+  // 0), nullptr when none of its channels has a curve.
+  const uint8_t* GetCurveIndexes( int port_index ) const;
+
+  // GetTableCount() tables of 256 bytes, one after the other.
+  const uint8_t* GetTables() const;
+
+  size_t GetTableCount() const;
+
+  static void BuildTable( const DMXCurve& curve, uint8_t* table );
+
+  // output[ i ] = the table of curve_indexes[ i ] looked up with input[ i ], for size slots.
+  static void Apply( const uint8_t* tables, const uint8_t* curve_indexes, const uint8_t* input, uint8_t* output, uint16_t size ) {
+    for( uint16_t i = 0; i < size; i++ ) {
+      output[ i ] = tables[ ( curve_indexes[ i ] << 8 ) | input[ i ] ];
+    }
+  }
+
+  static const size_t MAX_TABLES = 256;   // Indexes are one byte.
+
+private:
+  std::vector<uint8_t> m_tables;
+  std::vector<uint8_t> m_curve_indexes[ DMX_PORT_MAX ];   // DMX_PACKET_SIZE each, or empty without curves.
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "DMXFrameScheduler.h"
+
+DMXFrameScheduler::DMXFrameScheduler() {
+  this->Start( 0, 0 );
+}
+
+void DMXFrameScheduler::Start( uint32_t now_us, uint32_t interval_us, bool is_keep_alive ) {
+  m_interval_us    = interval_us;
+  m_is_keep_alive  = is_keep_alive;
+  m_deadline_us    = now_us;
+  m_last_frame_us  = now_us;
+  m_has_last_frame = false;
+  this->ResetStats();
+}
+
+bool DMXFrameScheduler::IsFrameDue( uint32_t now_us ) const {
+  return HasReached( now_us, m_deadline_us );
+}
+
+void DMXFrameScheduler::OnFrame( uint32_t now_us ) {
+  if( m_has_last_frame ) {
+    uint32_t interval_us = now_us - m_last_frame_us;
+
+    m_stats.m_interval_min_us = std::min( m_stats.m_interval_min_us, interval_us );
+    m_stats.m_interval_max_us = std::max( m_stats.m_interval_max_us, interval_us );
+    m_stats.m_interval_sum_us += interval_us;
+
+    // A keep-alive has no nominal interval to wobble around.
+    if( !m_is_keep_alive ) {
+      uint32_t jitter_us = interval_us > m_interval_us ? interval_us - m_interval_us : m_interval_us - interval_us;
+      m_stats.m_jitter_sum_us += jitter_us;
+      m_stats.m_jitter_max_us  = std::max( m_stats.m_jitter_max_us, jitter_us );
+    }
+  }
+  m_stats.m_frames++;
+  m_last_frame_us  = now_us;
+  m_has_last_frame = true;
+
+  if( m_is_keep_alive ) {
+    m_deadline_us = now_us + m_interval_us;
+    return;
+  }
+
+  if( !HasReached( now_us, m_deadline_us ) ) {
+    return;
+  }
+
+  m_deadline_us += m_interval_us;
+  if( m_interval_us != 0 && HasReached( now_us, m_deadline_us ) ) {
+    // A whole interval or more behind; skip what was missed instead of catching up.
+    m_deadline_us = now_us + m_interval_us;
+    m_stats.m_late++;
+  }
+}
+
+uint32_t DMXFrameScheduler::GetIntervalMicros() const {
+  return m_interval_us;
+}
+
+void DMXFrameScheduler::SetIntervalMicros( uint32_t interval_us ) {
+  if( interval_us == m_interval_us ) {
+    return;
+  }
+  m_interval_us = interval_us;
+  // The interval spanning the change belongs to neither.
+  m_has_last_frame = false;
+  this->ResetStats();
+}
+
+const DMXFrameScheduler::Stats& DMXFrameScheduler::GetStats() const {
+  return m_stats;
+}
+
+void DMXFrameScheduler::ResetStats() {
+  memset( &m_stats, 0, sizeof( m_stats ) );
+  m_stats.m_interval_min_us = UINT32_MAX;
+}
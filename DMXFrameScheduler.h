@@ -0,0 +1,66 @@
+#ifndef _DMXFRAMESCHEDULER_H_
+#define _DMXFRAMESCHEDULER_H_
+
+#include <Arduino.h>
+
+// Decides when a DMX port starts its next frame, in microseconds.
+//
+// Deadlines advance by exactly one interval per frame, so the refresh rate
+// doesn't drift with loop timing.  After a stall longer than an interval the
+// missed frames are dropped and the schedule restarts from now, rather than
+// sending them back to back.  All comparisons are wrap safe, micros() wraps
+// every 71 minutes.
+//
+// As a keep-alive the deadline is instead one interval after the last frame,
+// however it was started.
+//
+// The time between frame starts is recorded so refresh jitter can be reported,
+// since the interval was last set; an interval that changes starts them over
+// rather than counting the change as jitter.
+class DMXFrameScheduler {
+public:
+  struct Stats {
+    uint32_t m_frames;
+    uint32_t m_late;              // Frames more than an interval late, the schedule was restarted.
+    uint32_t m_interval_min_us;
+    uint32_t m_interval_max_us;
+    uint64_t m_interval_sum_us;
+    uint64_t m_jitter_sum_us;     // Sum of | interval - nominal interval |, not kept for a keep-alive.
+    uint32_t m_jitter_max_us;
+  };
+
+  DMXFrameScheduler();
+
+  // An interval of 0 sends frames back to back.
+  void Start( uint32_t now_us, uint32_t interval_us, bool is_keep_alive = false );
+
+  bool IsFrameDue( uint32_t now_us ) const;
+
+  // Call as a frame starts.  A frame started before it was due (e.g. forced)
+  // doesn't move the schedule.
+  void OnFrame( uint32_t now_us );
+
+  uint32_t GetIntervalMicros() const;
+
+  // Takes effect from the next deadline.  A different interval resets the stats.
+  void SetIntervalMicros( uint32_t interval_us );
+
+  const Stats& GetStats() const;
+
+  void ResetStats();
+
+  // True once now has reached deadline, for deadlines less than 2^31 ahead.
+  static bool HasReached( uint32_t now, uint32_t deadline ) {
+    return (int32_t)( now - deadline ) >= 0;
+  }
+
+private:
+  uint32_t m_interval_us;
+  uint32_t m_deadline_us;
+  bool     m_is_keep_alive;
+  uint32_t m_last_frame_us;
+  bool     m_has_last_frame;
+  Stats    m_stats;
+};
+
+#endif
@@ -0,0 +1,227 @@
+#include "DMXInterpolator.h"
+
+#include <esp_dmx.h>
+
+DMXInterpolator::DMXInterpolator() {
+  m_is_enabled   = false;
+  m_moving_count = 0;
+  m_size         = 0;
+  m_has_target   = false;
+  m_target_us    = 0;
+  m_start_us     = 0;
+  m_interval_us  = 0;
+  m_render_us    = 0;
+  memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+void DMXInterpolator::Configure( bool is_enabled, int port_index, const std::vector<DMXInterpolationAssignment>& assignments ) {
+  m_is_enabled   = is_enabled;
+  m_moving_count = 0;
+  m_size         = 0;
+  m_has_target   = false;
+  m_interval_us  = 0;
+  memset( &m_stats, 0, sizeof( m_stats ) );
+
+  if( !is_enabled ) {
+    m_kinds.clear();
+    m_pairs.clear();
+    m_target.clear();
+    m_output.clear();
+    m_from.clear();
+    m_moving.clear();
+    m_is_moving.clear();
+    return;
+  }
+
+  m_kinds.assign( DMX_PACKET_SIZE, SLOT_LINEAR );
+  m_pairs.assign( DMX_PACKET_SIZE, 0 );
+  m_target.assign( DMX_PACKET_SIZE, 0 );
+  m_output.assign( DMX_PACKET_SIZE, 0 );
+  m_from.assign( DMX_PACKET_SIZE, 0 );
+  m_moving.assign( DMX_PACKET_SIZE, 0 );
+  m_is_moving.assign( DMX_PACKET_SIZE, 0 );
+
+  // Later entries win over earlier ones for the same channel.
+  for( const DMXInterpolationAssignment& assignment : assignments ) {
+    if( assignment.port != port_index || assignment.channel < 1 || assignment.channel > 512 ) {
+      continue;
+    }
+    if( assignment.fine_channel == 0 ) {
+      uint16_t last = std::min<uint16_t>( 512, assignment.channel + std::max<uint16_t>( assignment.count, 1 ) - 1 );
+      for( uint16_t channel = assignment.channel; channel <= last; channel++ ) {
+        m_kinds[ channel ] = SLOT_SNAP;
+      }
+    } else if( assignment.fine_channel <= 512 && assignment.fine_channel != assignment.channel ) {
+      m_kinds[ assignment.channel ]      = SLOT_COARSE;
+      m_pairs[ assignment.channel ]      = assignment.fine_channel;
+      m_kinds[ assignment.fine_channel ] = SLOT_FINE;
+      m_pairs[ assignment.fine_channel ] = assignment.channel;
+    }
+  }
+
+  // A channel taken over by another pair leaves its old partner on its own.
+  for( uint16_t slot = 1; slot < DMX_PACKET_SIZE; slot++ ) {
+    uint8_t pair_kind = ( m_kinds[ slot ] == SLOT_COARSE ) ? SLOT_FINE : SLOT_COARSE;
+    if( ( m_kinds[ slot ] == SLOT_COARSE || m_kinds[ slot ] == SLOT_FINE ) &&
+        ( m_kinds[ m_pairs[ slot ] ] != pair_kind || m_pairs[ m_pairs[ slot ] ] != slot ) ) {
+      m_kinds[ slot ] = SLOT_LINEAR;
+    }
+  }
+}
+
+bool DMXInterpolator::IsEnabled() const {
+  return m_is_enabled;
+}
+
+uint16_t DMXInterpolator::GetValue( uint16_t slot ) const {
+  if( m_kinds[ slot ] == SLOT_COARSE ) {
+    return ( m_output[ slot ] << 8 ) | m_output[ m_pairs[ slot ] ];
+  }
+  return m_output[ slot ];
+}
+
+void DMXInterpolator::Retarget( uint16_t slot ) {
+  switch( m_kinds[ slot ] ) {
+    case SLOT_SNAP:
+      m_output[ slot ] = m_target[ slot ];
+      return;
+    case SLOT_FINE:
+      slot = m_pairs[ slot ];
+      break;
+    default:
+      break;
+  }
+  if( m_is_moving[ slot ] ) {
+    return;
+  }
+  m_from[ slot ]      = this->GetValue( slot );
+  m_is_moving[ slot ] = 1;
+  m_moving[ m_moving_count++ ] = slot;
+}
+
+void DMXInterpolator::SetTarget( const uint8_t* frame, uint16_t size, uint32_t now_us ) {
+  if( !m_is_enabled ) {
+    return;
+  }
+  size = std::min<uint16_t>( size, DMX_PACKET_SIZE );
+  m_stats.m_targets++;
+
+  uint32_t interval_us = now_us - m_target_us;
+  m_target_us = now_us;
+  m_start_us  = now_us;
+
+  // Nothing to move from yet, or the source paused : go straight there.
+  if( !m_has_target || interval_us > MAX_INTERVAL_US ) {
+    memcpy( m_target.data(), frame, size );
+    memcpy( m_output.data(), frame, size );
+    for( uint16_t i = 0; i < m_moving_count; i++ ) {
+      m_is_moving[ m_moving[ i ] ] = 0;
+    }
+    m_moving_count = 0;
+    m_size         = size;
+    m_has_target   = true;
+    m_stats.m_jumps++;
+    return;
+  }
+
+  // Frames come in unevenly, e.g. every other DMX frame or two in one, so
+  // move at their average pace.
+  m_interval_us = m_interval_us ? ( 3 * m_interval_us + interval_us ) / 4 : interval_us;
+  m_interval_us = std::max<uint32_t>( m_interval_us, 1 );
+
+  // The move starts from the frame sent last, so the frame this target goes
+  // out with is already a step on the way rather than a repeat.
+  if( now_us - m_render_us < m_interval_us ) {
+    m_start_us = m_render_us;
+  }
+
+  // Channels already in motion carry on from where they are.
+  for( uint16_t i = 0; i < m_moving_count; i++ ) {
+    m_from[ m_moving[ i ] ] = this->GetValue( m_moving[ i ] );
+  }
+
+  m_target[ 0 ] = m_output[ 0 ] = frame[ 0 ];
+
+  // Only what changed since the last target, skipping a word at a time.
+  uint16_t slot = 1;
+  for( ; slot + 4 <= size; slot += 4 ) {
+    uint32_t word, target_word;
+    memcpy( &word, frame + slot, 4 );
+    memcpy( &target_word, &m_target[ slot ], 4 );
+    if( word == target_word ) {
+      continue;
+    }
+    for( uint16_t i = slot; i < slot + 4; i++ ) {
+      if( frame[ i ] != m_target[ i ] ) {
+        m_target[ i ] = frame[ i ];
+        this->Retarget( i );
+      }
+    }
+  }
+  for( ; slot < size; slot++ ) {
+    if( frame[ slot ] != m_target[ slot ] ) {
+      m_target[ slot ] = frame[ slot ];
+      this->Retarget( slot );
+    }
+  }
+  m_size = size;
+}
+
+const uint8_t* DMXInterpolator::Render( uint32_t now_us ) {
+  m_stats.m_renders++;
+  m_stats.m_channel_steps += m_moving_count;
+  m_render_us = now_us;
+
+  uint32_t elapsed_us = now_us - m_start_us;
+  if( elapsed_us >= m_interval_us ) {
+    // Arrived, everything in motion stops at its target.
+    for( uint16_t i = 0; i < m_moving_count; i++ ) {
+      uint16_t slot = m_moving[ i ];
+      m_output[ slot ] = m_target[ slot ];
+      if( m_kinds[ slot ] == SLOT_COARSE ) {
+        m_output[ m_pairs[ slot ] ] = m_target[ m_pairs[ slot ] ];
+      }
+      m_is_moving[ slot ] = 0;
+    }
+    m_moving_count = 0;
+    return m_output.data();
+  }
+
+  // Fraction of the way there, 16 bit fixed point.
+  int64_t fraction = ( (uint64_t)elapsed_us << 16 ) / m_interval_us;
+  for( uint16_t i = 0; i < m_moving_count; i++ ) {
+    uint16_t slot = m_moving[ i ];
+    int32_t  from = m_from[ slot ];
+    if( m_kinds[ slot ] == SLOT_COARSE ) {
+      uint16_t fine  = m_pairs[ slot ];
+      int32_t  to    = ( m_target[ slot ] << 8 ) | m_target[ fine ];
+      uint16_t value = (uint16_t)( from + ( ( ( to - from ) * fraction ) >> 16 ) );
+      m_output[ slot ] = value >> 8;
+      m_output[ fine ] = value & 0xFF;
+    } else {
+      int32_t to = m_target[ slot ];
+      m_output[ slot ] = (uint8_t)( from + ( ( ( to - from ) * fraction ) >> 16 ) );
+    }
+  }
+  return m_output.data();
+}
+
+uint16_t DMXInterpolator::GetSize() const {
+  return m_size;
+}
+
+bool DMXInterpolator::IsMoving() const {
+  return m_moving_count > 0;
+}
+
+uint16_t DMXInterpolator::GetMovingCount() const {
+  return m_moving_count;
+}
+
+uint32_t DMXInterpolator::GetIntervalMicros() const {
+  return m_interval_us;
+}
+
+const DMXInterpolator::Stats& DMXInterpolator::GetStats() const {
+  return m_stats;
+}
@@ -0,0 +1,93 @@
+#ifndef _DMXINTERPOLATOR_H_
+#define _DMXINTERPOLATOR_H_
+
+#include <Arduino.h>
+#include <vector>
+
+// Channels that don't interpolate like the rest.  Channels are 1 - 512.
+struct DMXInterpolationAssignment {
+  uint8_t  port;              // 0 based DMX port index.
+  uint16_t channel;           // Coarse channel of a pair, or the first snap channel.
+  uint16_t count;             // Snap channels channel .. channel + count - 1, 1 for a pair.
+  uint16_t fine_channel;      // The pair's fine channel, 0 for snap channels.
+};
+
+// Upsamples the frames a DMX port receives to its refresh rate.
+//
+// Each new frame becomes the target the channels move to in a straight line,
+// over the time frames have been arriving apart (smoothed), starting from
+// wherever they are.  A coarse/fine pair moves as one 16 bit value, snap
+// channels (gobos, modes) jump straight to their new value.
+//
+// Only channels in motion are kept in a list and touched per frame sent;
+// a new frame is compared with the last a word at a time, so a static rig
+// costs next to nothing.  The interpolator lives on the transmit side.
+class DMXInterpolator {
+public:
+  struct Stats {
+    uint32_t m_targets;         // Frames that became a target.
+    uint32_t m_jumps;           // Targets jumped to, after silence or the first.
+    uint32_t m_renders;
+    uint64_t m_channel_steps;   // Channels moved, over all renders.
+  };
+
+  DMXInterpolator();
+
+  // Builds the port's channel kinds, nothing is allocated while disabled.
+  void Configure( bool is_enabled, int port_index, const std::vector<DMXInterpolationAssignment>& assignments );
+
+  bool IsEnabled() const;
+
+  // A new frame to move to, of size slots, arriving at now_us.
+  void SetTarget( const uint8_t* frame, uint16_t size, uint32_t now_us );
+
+  // Moves the channels in motion on to now_us and returns the frame to send, GetSize() slots.
+  const uint8_t* Render( uint32_t now_us );
+
+  uint16_t GetSize() const;
+
+  bool IsMoving() const;
+
+  uint16_t GetMovingCount() const;
+
+  uint32_t GetIntervalMicros() const;
+
+  const Stats& GetStats() const;
+
+  // Frames further apart than this aren't interpolated, the next one is jumped to.
+  static const uint32_t MAX_INTERVAL_US = 200000;
+
+private:
+  enum SlotKind : uint8_t {
+    SLOT_LINEAR,
+    SLOT_SNAP,
+    SLOT_COARSE,              // m_pairs holds the fine slot.
+    SLOT_FINE                 // m_pairs holds the coarse slot.
+  };
+
+  void Retarget( uint16_t slot );
+
+  uint16_t GetValue( uint16_t slot ) const;
+
+  bool     m_is_enabled;
+
+  std::vector<uint8_t>  m_kinds;
+  std::vector<uint16_t> m_pairs;
+  std::vector<uint8_t>  m_target;
+  std::vector<uint8_t>  m_output;
+  std::vector<uint16_t> m_from;       // Value when the current target was set, 16 bit for a pair.
+  std::vector<uint16_t> m_moving;     // Slots in motion, a pair by its coarse slot.
+  std::vector<uint8_t>  m_is_moving;
+  uint16_t m_moving_count;
+
+  uint16_t m_size;
+  bool     m_has_target;
+  uint32_t m_target_us;        // When the last target was set.
+  uint32_t m_start_us;         // When the move to it started, the frame sent before it.
+  uint32_t m_interval_us;
+  uint32_t m_render_us;
+
+  Stats    m_stats;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "DMXJitterBuffer.h"
+
+#include "DMXFrameScheduler.h"
+
+DMXJitterBuffer::DMXJitterBuffer() {
+  m_delay_us = 0;
+  this->Configure( 0 );
+}
+
+void DMXJitterBuffer::Configure( uint32_t delay_us ) {
+  m_delay_us = delay_us;
+  if( delay_us == 0 ) {
+    m_frames.clear();
+    m_frames.shrink_to_fit();
+  } else {
+    m_frames.assign( SLOTS * DMX_PACKET_SIZE, 0 );
+  }
+  for( Slot& slot : m_slots ) {
+    slot.m_arrival_us = 0;
+    slot.m_cadence_us = 0;
+    slot.m_size       = DMX_PACKET_SIZE;
+  }
+
+  // The frame being sent is slot 0 to start with.
+  m_head.store( 1, std::memory_order_relaxed );
+  m_read.store( 0, std::memory_order_relaxed );
+  m_tail.store( 1, std::memory_order_release );
+
+  memset( m_arrivals_us, 0, sizeof( m_arrivals_us ) );
+  m_arrival_count   = 0;
+  m_cadence_us      = 0;
+  m_due_us          = 0;
+  m_is_playing      = false;
+  m_is_underrun     = false;
+
+  this->ResetStats();
+}
+
+bool DMXJitterBuffer::IsEnabled() const {
+  return m_delay_us != 0;
+}
+
+uint32_t DMXJitterBuffer::GetDelayMicros() const {
+  return m_delay_us;
+}
+
+uint8_t* DMXJitterBuffer::GetWriteBuffer() {
+  return &m_frames[ ( m_head.load( std::memory_order_relaxed ) % SLOTS ) * DMX_PACKET_SIZE ];
+}
+
+void DMXJitterBuffer::Publish( uint16_t size, uint32_t now_us, const DMXFrameStamp& stamp ) {
+  // The sender's cadence, the time across a full window over the frames in
+  // it; 0 until the first window fills.  A pause longer than MAX_CADENCE_US
+  // starts the window again.
+  uint32_t last_us = m_arrivals_us[ ( m_arrival_count - 1 ) % CADENCE_WINDOW ];
+  if( m_arrival_count != 0 && now_us - last_us > MAX_CADENCE_US ) {
+    m_arrival_count = 0;
+  }
+  if( m_arrival_count >= CADENCE_WINDOW - 1 ) {
+    uint32_t window_cadence_us = ( now_us - m_arrivals_us[ ( m_arrival_count - ( CADENCE_WINDOW - 1 ) ) % CADENCE_WINDOW ] ) / ( CADENCE_WINDOW - 1 );
+    m_cadence_us = m_cadence_us ? ( 3 * m_cadence_us + window_cadence_us ) / 4 : window_cadence_us;
+  }
+  m_arrivals_us[ m_arrival_count++ % CADENCE_WINDOW ] = now_us;
+  m_stats.m_frames++;
+  m_stats.m_cadence_us = m_cadence_us;
+
+  uint32_t head = m_head.load( std::memory_order_relaxed );
+  uint32_t tail = m_tail.load( std::memory_order_acquire );
+
+  // The next write buffer is never the frame being sent : with the transmit
+  // side stalled the write buffer isn't handed over and is simply written again.
+  if( head + 1 - m_read.load( std::memory_order_acquire ) >= SLOTS ) {
+    m_stats.m_overruns++;
+    return;
+  }
+
+  // The oldest frame makes room, unless the reader has just taken it.
+  if( head - tail >= DEPTH ) {
+    if( m_tail.compare_exchange_strong( tail, tail + 1, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+      tail++;
+      m_stats.m_overruns++;
+    }
+  }
+  uint32_t queued = head - tail;
+
+  Slot& slot = this->GetSlot( head );
+  slot.m_arrival_us = now_us;
+  slot.m_cadence_us = m_cadence_us;
+  slot.m_size       = size;
+  slot.m_stamp      = stamp;
+  m_stats.m_depth_max = std::max( m_stats.m_depth_max, queued + 1 );
+
+  // Release makes the frame visible before the position that points at it.
+  m_head.store( head + 1, std::memory_order_release );
+}
+
+bool DMXJitterBuffer::IsDue( uint32_t now_us ) const {
+  uint32_t tail = m_tail.load( std::memory_order_relaxed );
+  if( m_head.load( std::memory_order_acquire ) == tail ) {
+    return false;
+  }
+  if( !m_is_playing ) {
+    return DMXFrameScheduler::HasReached( now_us, this->GetSlot( tail ).m_arrival_us + m_delay_us );
+  }
+  return m_is_underrun || DMXFrameScheduler::HasReached( now_us, m_due_us );
+}
+
+bool DMXJitterBuffer::Acquire( uint32_t now_us ) {
+  // The writer may drop the oldest frame meanwhile, moving the tail on; the
+  // frames are then looked at again.
+  uint32_t tail = m_tail.load( std::memory_order_acquire );
+  uint32_t taken;
+  do {
+    uint32_t head = m_head.load( std::memory_order_acquire );
+    if( head == tail ) {
+      if( m_is_playing && !m_is_underrun && DMXFrameScheduler::HasReached( now_us, m_due_us ) ) {
+        m_stats.m_underruns++;
+        m_is_underrun = true;
+      }
+      // A sender that went quiet starts afresh, its next frame waits the delay again.
+      if( m_is_playing && DMXFrameScheduler::HasReached( now_us, m_due_us + MAX_CADENCE_US ) ) {
+        m_is_playing  = false;
+        m_is_underrun = false;
+      }
+      return false;
+    }
+
+    if( !this->IsDue( now_us ) ) {
+      return false;
+    }
+
+    // Too far behind, e.g. after the transmit side stalled : skip to the newest
+    // frame that hasn't waited longer than a burst could explain.
+    uint32_t cadence_us  = this->GetSlot( tail ).m_cadence_us;
+    uint32_t max_wait_us = m_delay_us + ( DEPTH / 2 ) * cadence_us;
+    for( taken = tail; cadence_us != 0 && head - taken > 1 && now_us - this->GetSlot( taken + 1 ).m_arrival_us > max_wait_us; ) {
+      taken++;
+    }
+  } while( !m_tail.compare_exchange_weak( tail, taken + 1, std::memory_order_acq_rel, std::memory_order_acquire ) );
+
+  uint32_t played_us = m_is_playing ? m_due_us : this->GetSlot( tail ).m_arrival_us + m_delay_us;
+  if( m_is_underrun ) {
+    played_us = now_us;
+  }
+  m_stats.m_skipped += taken - tail;
+
+  const Slot& slot = this->GetSlot( taken );
+  uint32_t wait_us = now_us - slot.m_arrival_us;
+  m_stats.m_played++;
+  m_stats.m_wait_sum_us += wait_us;
+  m_stats.m_wait_max_us  = std::max( m_stats.m_wait_max_us, wait_us );
+
+  // The next frame a cadence on, moved an eighth of the way later when this
+  // one had less than the delay to spare, a sixty-fourth earlier when more.
+  int32_t error_us = (int32_t)( slot.m_arrival_us + m_delay_us - played_us );
+  m_due_us      = played_us + slot.m_cadence_us + ( error_us > 0 ? error_us / 8 : error_us / 64 );
+  m_is_underrun = false;
+
+  // Until the cadence is known each frame simply plays the delay after it arrived.
+  m_is_playing  = ( slot.m_cadence_us != 0 );
+
+  m_read.store( taken, std::memory_order_release );
+  return true;
+}
+
+const uint8_t* DMXJitterBuffer::GetReadBuffer() const {
+  return &m_frames[ ( m_read.load( std::memory_order_relaxed ) % SLOTS ) * DMX_PACKET_SIZE ];
+}
+
+uint16_t DMXJitterBuffer::GetReadSize() const {
+  return this->GetSlot( m_read.load( std::memory_order_relaxed ) ).m_size;
+}
+
+const DMXFrameStamp& DMXJitterBuffer::GetReadStamp() const {
+  return this->GetSlot( m_read.load( std::memory_order_relaxed ) ).m_stamp;
+}
+
+const DMXJitterBuffer::Stats& DMXJitterBuffer::GetStats() const {
+  return m_stats;
+}
+
+void DMXJitterBuffer::ResetStats() {
+  memset( &m_stats, 0, sizeof( m_stats ) );
+}
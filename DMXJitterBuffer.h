@@ -0,0 +1,126 @@
+#ifndef _DMXJITTERBUFFER_H_
+#define _DMXJITTERBUFFER_H_
+
+#include <Arduino.h>
+#include <esp_dmx.h>
+#include <atomic>
+#include <vector>
+
+#include "DMXTripleBuffer.h"
+
+// Plays DMX frames out evenly when they arrive in bursts, as they do over WiFi.
+//
+// Published frames are queued with their arrival time, up to DEPTH of them,
+// and the reader takes them one at a time at the sender's cadence, measured
+// over the last CADENCE_WINDOW arrivals so bursts average out.  The first
+// frame plays the configured delay after it arrived, each frame after that a
+// cadence after the one before.  The schedule moves later quickly when a
+// frame arrived with less than the delay to spare, and earlier slowly when
+// frames arrive early, so the latest frames of a burst set the pace and the
+// queue neither drains nor fills when the clocks differ.  Until the first
+// window has filled frames just play the delay after they arrived.
+//
+// A frame due with nothing queued is an underrun, the last frame is sent on
+// and the next one plays as soon as it arrives.  A frame published with the
+// queue full is an overrun, and the oldest queued frame is dropped for it;
+// only once another queue of frames has been dropped while one frame was
+// being sent, the transmit side having stalled, is the new frame dropped
+// instead.  Once frames have waited longer than the delay plus half a queue
+// of cadence they are skipped to catch up.
+//
+// Like DMXTripleBuffer it hands frames from the receive to the transmit task
+// without a lock, one writer and one reader only; both move the tail on, the
+// writer to drop a frame and the reader to take one, with a compare and swap.
+class DMXJitterBuffer {
+public:
+  struct Stats {
+    uint32_t m_frames;          // Published.
+    uint32_t m_played;
+    uint32_t m_underruns;       // Frames due with the queue empty.
+    uint32_t m_overruns;        // Frames dropped as the queue was full, the oldest mostly.
+    uint32_t m_skipped;         // Frames dropped to catch up.
+    uint32_t m_depth_max;       // Most frames queued at once.
+    uint64_t m_wait_sum_us;     // Arrival to playout, over the frames played.
+    uint32_t m_wait_max_us;
+    uint32_t m_cadence_us;      // The sender's, as last measured.
+  };
+
+  static const uint8_t  DEPTH          = 8;
+  static const uint8_t  CADENCE_WINDOW = 16;
+  static const uint32_t MAX_CADENCE_US = 250000;   // Slower senders are played as they come, after the delay.
+
+  DMXJitterBuffer();
+
+  // A delay of 0 turns the buffer off and frees the queue.  Neither side may be running.
+  void Configure( uint32_t delay_us );
+
+  bool IsEnabled() const;
+
+  uint32_t GetDelayMicros() const;
+
+  // Writer : fill GetWriteBuffer(), then Publish() the first size slots of it.
+  uint8_t* GetWriteBuffer();
+
+  void Publish( uint16_t size, uint32_t now_us, const DMXFrameStamp& stamp = DMXFrameStamp() );
+
+  // Reader : takes the next frame if it is due, returns false when the read
+  // buffer is unchanged.
+  bool Acquire( uint32_t now_us );
+
+  // True when Acquire() would take a new frame.
+  bool IsDue( uint32_t now_us ) const;
+
+  const uint8_t* GetReadBuffer() const;
+
+  uint16_t GetReadSize() const;
+
+  const DMXFrameStamp& GetReadStamp() const;
+
+  const Stats& GetStats() const;
+
+  // Only while neither side is running.
+  void ResetStats();
+
+private:
+  struct Slot {
+    uint32_t m_arrival_us;
+    uint32_t m_cadence_us;
+    uint16_t m_size;
+    DMXFrameStamp m_stamp;
+  };
+
+  // The queue, the frame being sent, the one being written and as many again
+  // as the queue for those dropped while one frame is being sent.
+  static const uint8_t SLOTS = 2 * DEPTH + 2;
+
+  Slot& GetSlot( uint32_t position ) {
+    return m_slots[ position % SLOTS ];
+  }
+
+  const Slot& GetSlot( uint32_t position ) const {
+    return m_slots[ position % SLOTS ];
+  }
+
+  uint32_t m_delay_us;
+
+  std::vector<uint8_t> m_frames;    // SLOTS frames of DMX_PACKET_SIZE.
+  Slot     m_slots[ SLOTS ];
+
+  std::atomic<uint32_t> m_head;     // Next position written, the writer's.
+  std::atomic<uint32_t> m_tail;     // Next position read, moved on by the reader, or by the writer dropping the oldest frame.
+  std::atomic<uint32_t> m_read;     // Position of the frame being sent, the reader's.
+
+  // Writer.
+  uint32_t m_arrivals_us[ CADENCE_WINDOW ];
+  uint32_t m_arrival_count;
+  uint32_t m_cadence_us;
+
+  // Reader.
+  uint32_t m_due_us;
+  bool     m_is_playing;
+  bool     m_is_underrun;
+
+  Stats    m_stats;
+};
+
+#endif
@@ -0,0 +1,245 @@
+#include <esp_log.h>
+
+#include "DMXPort.h"
+#include "DMXCurves.h"
+
+static const dmx_port_t DMX_PORT_UARTS[ DMX_PORT_MAX ] = {
+  DMX_NUM_1,
+#if SOC_UART_NUM > 2
+  DMX_NUM_2,
+#endif
+  DMX_NUM_0
+};
+
+// Fewer channels would break the 1204 us minimum from break to break.
+#define DMX_MIN_FRAME_CHANNELS 24
+
+// 11 bits at 250 kbaud.
+#ifndef DMX_SLOT_LEN_US
+#define DMX_SLOT_LEN_US 44
+#endif
+
+DMXPort::DMXPort() {
+  memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
+
+  m_dmx_num    = DMX_NUM_1;
+  m_is_started = false;
+
+  m_ptr_curve_tables  = nullptr;
+  m_ptr_curve_indexes = nullptr;
+
+  m_sent_stamp = DMXFrameStamp();
+}
+
+DMXPort::~DMXPort() {
+  this->Stop();
+}
+
+dmx_port_t DMXPort::GetDMXNum( int port_index ) {
+  return DMX_PORT_UARTS[ port_index ];
+}
+
+bool DMXPort::Start( int port_index, const DMXPortConfig& config, const DMXOutputTiming& timing ) {
+  dmx_config_t dmx_config = DMX_CONFIG_DEFAULT;
+  dmx_personality_t personalities[] = {};
+  int personality_count = 0;
+
+  m_dmx_num = GetDMXNum( port_index );
+
+  if( m_dmx_num == DMX_NUM_0 ) {
+    // UART0 is the serial console : logging stops, or it would go out on the DMX line.
+    Serial.printf( "DMX port %i takes over the serial console, logging stops until restart\n", port_index + 1 );
+    Serial.flush();
+    Serial.end();
+    esp_log_level_set( "*", ESP_LOG_NONE );
+  }
+
+  if( !dmx_driver_install( m_dmx_num, &dmx_config, personalities, personality_count ) ) {
+    Serial.printf( "Failed to install DMX driver for port %i\n", port_index + 1 );
+    return false;
+  }
+
+  dmx_set_pin( m_dmx_num, config.gpio_transmit, config.gpio_receive, config.gpio_enable );
+
+  m_frames.Reset();
+
+  m_timing        = timing;
+  m_timing.min_frame_channels = std::max<uint16_t>( DMX_MIN_FRAME_CHANNELS, std::min<uint16_t>( timing.min_frame_channels, DMX_PACKET_SIZE - 1 ) );
+  m_used_channels = 0;
+  m_interval_size = DMX_PACKET_SIZE;
+  m_frame_end_us  = micros();
+  m_scheduler.Start( m_frame_end_us, timing.update_interval_us, timing.is_send_on_receive );
+  this->Publish();
+
+  m_is_started = true;
+
+  return m_is_started;
+}
+
+void DMXPort::Stop() {
+  if( m_is_started && dmx_driver_is_installed( m_dmx_num ) ) {
+    dmx_driver_delete( m_dmx_num );
+  }
+
+  m_is_started = false;
+}
+
+bool DMXPort::IsStarted() {
+  return m_is_started;
+}
+
+uint8_t* DMXPort::GetBuffer() {
+  return m_dmx_buffer;
+}
+
+void DMXPort::Clear() {
+  memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
+}
+
+void DMXPort::MarkUsed( uint16_t channel ) {
+  if( channel > m_used_channels.load( std::memory_order_relaxed ) ) {
+    m_used_channels.store( channel, std::memory_order_relaxed );
+  }
+}
+
+void DMXPort::SetCurves( const uint8_t* ptr_curve_tables, const uint8_t* ptr_curve_indexes ) {
+  m_ptr_curve_tables  = ptr_curve_tables;
+  m_ptr_curve_indexes = ptr_curve_indexes;
+}
+
+void DMXPort::Publish( const DMXFrameStamp& stamp ) {
+  uint16_t size = 1 + std::max( m_used_channels.load( std::memory_order_relaxed ), m_timing.min_frame_channels );
+
+  bool     is_queued        = m_jitter_buffer.IsEnabled();
+  uint8_t* ptr_write_buffer = is_queued ? m_jitter_buffer.GetWriteBuffer() : m_frames.GetWriteBuffer();
+
+  // The copy to the transmit side is the pass that applies the curves.
+  if( m_ptr_curve_indexes != nullptr ) {
+    DMXCurves::Apply( m_ptr_curve_tables, m_ptr_curve_indexes, m_dmx_buffer, ptr_write_buffer, size );
+  } else {
+    memcpy( ptr_write_buffer, m_dmx_buffer, size );
+  }
+  if( is_queued ) {
+    m_jitter_buffer.Publish( size, micros(), stamp );
+  } else {
+    m_frames.Publish( size, stamp );
+  }
+}
+
+void DMXPort::SetInterpolation( bool is_enabled, int port_index, const std::vector<DMXInterpolationAssignment>& assignments ) {
+  m_interpolator.Configure( is_enabled, port_index, assignments );
+}
+
+const DMXInterpolator& DMXPort::GetInterpolator() const {
+  return m_interpolator;
+}
+
+void DMXPort::SetJitterBuffer( uint32_t delay_us ) {
+  m_jitter_buffer.Configure( delay_us );
+}
+
+DMXJitterBuffer& DMXPort::GetJitterBuffer() {
+  return m_jitter_buffer;
+}
+
+const DMXJitterBuffer& DMXPort::GetJitterBuffer() const {
+  return m_jitter_buffer;
+}
+
+bool DMXPort::HasNewFrame( uint32_t now_us ) {
+  return m_jitter_buffer.IsEnabled() ? m_jitter_buffer.IsDue( now_us ) : m_frames.HasNew();
+}
+
+bool DMXPort::IsFrameDue( uint32_t now_us ) {
+  if( !m_is_started ) {
+    return false;
+  }
+  // Channels still in motion are sent on as if new.
+  if( m_timing.is_send_on_receive && ( this->HasNewFrame( now_us ) || m_interpolator.IsMoving() ) &&
+      DMXFrameScheduler::HasReached( now_us, m_frame_end_us + m_timing.min_frame_gap_us ) ) {
+    return true;
+  }
+  return m_scheduler.IsFrameDue( now_us );
+}
+
+bool DMXPort::IsIdleFor( uint32_t now_us, uint32_t idle_us ) const {
+  return m_is_started && DMXFrameScheduler::HasReached( now_us, m_frame_end_us + idle_us );
+}
+
+void DMXPort::BeginFrame( uint32_t now_us ) {
+  // Without a new frame the previous one is sent again.
+  bool           is_new;
+  uint16_t       size;
+  const uint8_t* ptr_frame;
+  const DMXFrameStamp* ptr_stamp;
+  if( m_jitter_buffer.IsEnabled() ) {
+    is_new    = m_jitter_buffer.Acquire( now_us );
+    size      = m_jitter_buffer.GetReadSize();
+    ptr_frame = m_jitter_buffer.GetReadBuffer();
+    ptr_stamp = &m_jitter_buffer.GetReadStamp();
+  } else {
+    is_new    = m_frames.Acquire();
+    size      = m_frames.GetReadSize();
+    ptr_frame = m_frames.GetReadBuffer();
+    ptr_stamp = &m_frames.GetReadStamp();
+  }
+  if( m_interpolator.IsEnabled() ) {
+    if( is_new ) {
+      m_interpolator.SetTarget( ptr_frame, size, now_us );
+    }
+    ptr_frame = m_interpolator.Render( now_us );
+  }
+
+  // Idle, the short frames go out at the configured rate.
+  uint16_t interval_size = m_used_channels.load( std::memory_order_relaxed ) != 0 ? size : DMX_PACKET_SIZE;
+  if( interval_size != m_interval_size && !m_timing.is_send_on_receive ) {
+    m_scheduler.SetIntervalMicros( this->GetIntervalMicros( interval_size ) );
+    m_interval_size = interval_size;
+  }
+
+  dmx_write( m_dmx_num, ptr_frame, size );
+  // A frame sent again isn't the one its data arrived in.
+  m_sent_stamp.m_is_stamped = is_new && ptr_stamp->m_is_stamped;
+  if( m_sent_stamp.m_is_stamped ) {
+    m_sent_stamp = *ptr_stamp;
+    m_sent_stamp.m_sent_us = micros();
+  }
+  dmx_send_num( m_dmx_num, size );
+  m_scheduler.OnFrame( now_us );
+  m_frame_end_us = now_us + GetFrameTimeMicros( size );
+}
+
+uint32_t DMXPort::GetIntervalMicros( uint16_t size ) {
+  // The configured interval is for a full frame; keep its idle time, but
+  // never go slower than configured.
+  uint32_t interval_us   = m_timing.update_interval_us;
+  uint32_t full_frame_us = GetFrameTimeMicros( DMX_PACKET_SIZE );
+  uint32_t idle_us       = interval_us > full_frame_us ? interval_us - full_frame_us : 0;
+  return std::min( interval_us, GetFrameTimeMicros( size ) + idle_us );
+}
+
+uint32_t DMXPort::GetFrameTimeMicros( uint16_t size ) {
+  return DMX_BREAK_LEN_US + DMX_MAB_LEN_US + size * DMX_SLOT_LEN_US;
+}
+
+bool DMXPort::IsSending() {
+  return m_is_started && !dmx_wait_sent( m_dmx_num, 0 );
+}
+
+const DMXFrameStamp& DMXPort::GetSentStamp() const {
+  return m_sent_stamp;
+}
+
+DMXFrameScheduler& DMXPort::GetScheduler() {
+  return m_scheduler;
+}
+
+const DMXFrameScheduler& DMXPort::GetScheduler() const {
+  return m_scheduler;
+}
+
+void DMXPort::WaitSent() {
+  if( m_is_started ) {
+    dmx_wait_sent( m_dmx_num, DMX_TIMEOUT_TICK );
+  }
+}
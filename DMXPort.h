@@ -0,0 +1,158 @@
+#ifndef _DMXPORT_H_
+#define _DMXPORT_H_
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_dmx.h>
+
+#include "DMXTripleBuffer.h"
+#include "DMXFrameScheduler.h"
+#include "DMXInterpolator.h"
+#include "DMXJitterBuffer.h"
+
+// UARTs used for DMX output, port 1 first.  UART0 comes last as it carries the
+// serial console on most boards; the port on it ends serial logging when started.
+#if SOC_UART_NUM > 2
+#define DMX_PORT_MAX 3
+#else
+#define DMX_PORT_MAX 2
+#endif
+
+// Settings of one DMX output : the MAX485 wiring and the Art-Net universe sent out of it.
+struct DMXPortConfig {
+  bool enabled;
+  int  gpio_enable;
+  int  gpio_transmit;
+  int  gpio_receive;
+  int  artnet_universe;
+};
+
+// When frames go out, the same for all ports.
+struct DMXOutputTiming {
+  uint32_t update_interval_us;    // Refresh interval, the keep-alive when sending on receive.
+  bool     is_send_on_receive;    // Start a frame as soon as a new one is published.
+  uint32_t min_frame_gap_us;      // Sending on receive : idle time between the end of a frame and the next.
+  uint16_t min_frame_channels;    // Frames are cut after the highest channel in use, but never shorter than this.
+};
+
+// One physical DMX output, a UART driving a MAX485 transceiver.
+//
+// Each port owns its frame buffer and refresh timer.  Sending is split into
+// BeginFrame(), which hands the frame to the UART and returns straight away,
+// and IsSending() / WaitSent(), so several ports can be on the wire at the
+// same time and the caller can carry on while they are.
+//
+// The receive side builds the frame in GetBuffer() and Publish()es it; the
+// transmit side, which may run in another task, sends the newest published
+// frame.
+//
+// Publish() passes the frame through the port's response curves, if it has
+// any, on the way to the transmit side.  With interpolation on, the transmit
+// side moves the channels towards each new frame over the frames it sends in
+// between, rather than stepping to it.  With a jitter buffer, published
+// frames queue up and go out at the sender's pace, after a delay, rather
+// than the newest one as soon as possible.
+//
+// Frames only run up to the highest channel anything has written to since
+// Start().  Shorter frames take less time on the wire, so the update interval
+// is shortened to match, keeping the same idle time after each frame.  A port
+// nothing has written to yet keeps the configured interval, there is nothing
+// on it worth refreshing faster.
+class DMXPort {
+public:
+  DMXPort();
+
+  ~DMXPort();
+
+  bool Start( int port_index, const DMXPortConfig& config, const DMXOutputTiming& timing );
+
+  void Stop();
+
+  bool IsStarted();
+
+  // Receive side.  Slot 0 is the start code, 1 - 512 the channels.
+  uint8_t* GetBuffer();
+
+  void Clear();
+
+  // Channels 1 - channel are in use and have to be sent.
+  void MarkUsed( uint16_t channel );
+
+  // Response curves Publish() applies, see DMXCurves.  nullptr curve_indexes for none.
+  void SetCurves( const uint8_t* ptr_curve_tables, const uint8_t* ptr_curve_indexes );
+
+  // stamp travels with the frame to the transmit side, see GetSentStamp().
+  void Publish( const DMXFrameStamp& stamp = DMXFrameStamp() );
+
+  // Call before Start(), while the transmit side isn't running.
+  void SetInterpolation( bool is_enabled, int port_index, const std::vector<DMXInterpolationAssignment>& assignments );
+
+  const DMXInterpolator& GetInterpolator() const;
+
+  // Call before Start(), while the transmit side isn't running.  A delay of 0 for none.
+  void SetJitterBuffer( uint32_t delay_us );
+
+  DMXJitterBuffer& GetJitterBuffer();
+
+  const DMXJitterBuffer& GetJitterBuffer() const;
+
+  // Transmit side.
+  bool IsFrameDue( uint32_t now_us );
+
+  // Nothing has gone out for idle_us since the last frame ended.
+  bool IsIdleFor( uint32_t now_us, uint32_t idle_us ) const;
+
+  uint32_t GetIntervalMicros( uint16_t size );
+
+  void BeginFrame( uint32_t now_us );
+
+  // The stamp of the frame BeginFrame() last started, unstamped unless it was
+  // a newly published frame that carried one.
+  const DMXFrameStamp& GetSentStamp() const;
+
+  // Polls the UART, true while the last frame is still going out.
+  bool IsSending();
+
+  void WaitSent();
+
+  DMXFrameScheduler& GetScheduler();
+
+  const DMXFrameScheduler& GetScheduler() const;
+
+  static dmx_port_t GetDMXNum( int port_index );
+
+  static uint32_t GetFrameTimeMicros( uint16_t size );
+
+private:
+  bool HasNewFrame( uint32_t now_us );
+
+  bool          m_is_started;
+
+  dmx_port_t    m_dmx_num;
+
+  DMXOutputTiming   m_timing;
+
+  DMXFrameScheduler m_scheduler;
+
+  uint32_t      m_frame_end_us;
+
+  uint16_t      m_interval_size;    // Slots the scheduler's interval is set for.
+
+  // Written by the receive side, read by the transmit side.
+  std::atomic<uint16_t> m_used_channels;
+
+  uint8_t       m_dmx_buffer[ DMX_PACKET_SIZE ];
+
+  const uint8_t* m_ptr_curve_tables;
+  const uint8_t* m_ptr_curve_indexes;
+
+  DMXTripleBuffer m_frames;
+
+  DMXInterpolator m_interpolator;
+
+  DMXJitterBuffer m_jitter_buffer;
+
+  DMXFrameStamp   m_sent_stamp;
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "DMXRouter.h"
+
+#include <algorithm>
+#include <tuple>
+
+DMXRouter::DMXRouter() {
+  std::fill( m_output_ends, m_output_ends + DMX_MERGE_MAX, 0 );
+  m_highest_output_channel = 0;
+  m_through_mask           = 0xFF;
+}
+
+DMXRouter::~DMXRouter() {
+}
+
+void DMXRouter::Compile( const DMXRoutingTable& routing_table, bool is_through ) {
+  // ( output channel, route index, link ) for every output of every route.
+  std::vector<std::tuple<uint16_t, uint16_t, uint16_t>> links;
+
+  for( size_t i = 0; i < routing_table.Size(); i++ ) {
+    const DMXRoutingConfig& config = routing_table.GetRoute( i );
+    const uint16_t* ptr_output_channels = routing_table.GetOutputChannels( i );
+    if( config.input_channel < 1 || config.input_channel > 512 ) {
+      continue;
+    }
+    for( uint16_t k = 0; k < config.input_count && config.input_channel + k <= 512; k++ ) {
+      uint16_t link = ( config.input_channel - 1 + k ) | ( config.merge_operator << LINK_OPERATOR_SHIFT );
+      for( uint16_t j = 0; j < config.output_count; j++ ) {
+        uint32_t output_channel = ptr_output_channels[ j ] + (uint32_t)k * config.output_stride;
+        if( output_channel > 0 && output_channel < 513 ) {
+          links.push_back( std::make_tuple( (uint16_t)output_channel, (uint16_t)i, link ) );
+        }
+      }
+    }
+  }
+
+  // Operators other than HTP depend on order, so the inputs of an output keep
+  // the order of their routes in the table; a later route merges onto the
+  // result of the earlier ones.
+  std::sort( links.begin(), links.end() );
+  links.erase( std::unique( links.begin(), links.end() ), links.end() );
+
+  m_outputs.clear();
+  m_links.clear();
+  m_links.reserve( links.size() );
+  m_blocks.clear();
+
+  // Outputs by the one merge operator of their routes, DMX_MERGE_MAX for those mixing them.
+  std::vector<DMXRouteOutput> operator_outputs[ DMX_MERGE_MAX + 1 ];
+  std::vector<uint16_t>       operator_links[ DMX_MERGE_MAX + 1 ];
+
+  // Merging a single input onto 0 leaves it as it is for every operator but scale.
+  const uint8_t copy_operators = is_through ? ( 1 << DMX_MERGE_LTP ) :
+                                 ( 1 << DMX_MERGE_HTP ) | ( 1 << DMX_MERGE_LTP ) | ( 1 << DMX_MERGE_ADD ) | ( 1 << DMX_MERGE_PRIORITY );
+
+  for( size_t first = 0, last = 0; first < links.size(); first = last ) {
+    uint8_t merge_operator = std::get<2>( links[ first ] ) >> LINK_OPERATOR_SHIFT;
+    for( last = first; last < links.size() && std::get<0>( links[ last ] ) == std::get<0>( links[ first ] ); last++ ) {
+      if( ( std::get<2>( links[ last ] ) >> LINK_OPERATOR_SHIFT ) != merge_operator ) {
+        merge_operator = DMX_MERGE_MAX;
+      }
+    }
+
+    // An output that is a plain copy of one input, next to the one before it
+    // on both sides, extends that block.
+    uint16_t output_channel = std::get<0>( links[ first ] );
+    uint16_t link           = std::get<2>( links[ first ] );
+    if( last - first == 1 && ( ( copy_operators >> merge_operator ) & 1 ) ) {
+      uint16_t input_index = link & LINK_INPUT_MASK;
+      if( !m_blocks.empty() && m_blocks.back().m_output_channel + m_blocks.back().m_count == output_channel &&
+          m_blocks.back().m_input_index + m_blocks.back().m_count == input_index ) {
+        m_blocks.back().m_count++;
+      } else {
+        m_blocks.push_back( { input_index, output_channel, 1 } );
+      }
+      continue;
+    }
+
+    // Only outputs mixing operators keep them in their links.
+    uint16_t link_mask = ( merge_operator == DMX_MERGE_MAX ) ? 0xFFFF : LINK_INPUT_MASK;
+    operator_outputs[ merge_operator ].push_back( { output_channel, (uint16_t)( last - first ) } );
+    for( size_t i = first; i < last; i++ ) {
+      operator_links[ merge_operator ].push_back( std::get<2>( links[ i ] ) & link_mask );
+    }
+  }
+
+  // A block of one is cheaper merged than copied.
+  for( size_t i = 0; i < m_blocks.size(); ) {
+    if( m_blocks[ i ].m_count == 1 ) {
+      operator_outputs[ DMX_MERGE_LTP ].push_back( { m_blocks[ i ].m_output_channel, 1 } );
+      operator_links[ DMX_MERGE_LTP ].push_back( m_blocks[ i ].m_input_index );
+      m_blocks.erase( m_blocks.begin() + i );
+    } else {
+      i++;
+    }
+  }
+
+  for( uint8_t merge_operator = 0; merge_operator <= DMX_MERGE_MAX; merge_operator++ ) {
+    m_outputs.insert( m_outputs.end(), operator_outputs[ merge_operator ].begin(), operator_outputs[ merge_operator ].end() );
+    m_links.insert( m_links.end(), operator_links[ merge_operator ].begin(), operator_links[ merge_operator ].end() );
+    if( merge_operator < DMX_MERGE_MAX ) {
+      m_output_ends[ merge_operator ] = m_outputs.size();
+    }
+  }
+
+  m_outputs.shrink_to_fit();
+  m_links.shrink_to_fit();
+  m_blocks.shrink_to_fit();
+  m_highest_output_channel = links.empty() ? 0 : std::get<0>( links.back() );
+  m_through_mask           = is_through ? 0xFF : 0x00;
+}
+
+template <uint8_t MERGE_OPERATOR>
+void DMXRouter::ApplyOutputs( const DMXRouteOutput*& ptr_output, const DMXRouteOutput* ptr_output_end,
+                              const uint16_t*& ptr_link, const uint8_t* data, uint16_t number_of_channels,
+                              const uint8_t* through, uint8_t through_mask, uint8_t* dmx_buffer ) {
+  for( ; ptr_output != ptr_output_end; ptr_output++ ) {
+    uint8_t value = through[ ptr_output->m_output_channel ] & through_mask;
+    for( const uint16_t* ptr_end = ptr_link + ptr_output->m_input_count; ptr_link != ptr_end; ptr_link++ ) {
+      uint8_t present = -(uint8_t)( *ptr_link < number_of_channels );
+      uint8_t merged  = Merge( MERGE_OPERATOR, value, data[ *ptr_link ] );
+      value = ( merged & present ) | ( value & ~present );
+    }
+    dmx_buffer[ ptr_output->m_output_channel ] = value;
+  }
+}
+
+void DMXRouter::Apply( const uint8_t* data, uint16_t number_of_channels, const uint8_t* through,
+                       uint8_t* dmx_buffer ) const {
+  const DMXRouteOutput* ptr_outputs  = m_outputs.data();
+  const DMXRouteOutput* ptr_output   = ptr_outputs;
+  const uint16_t*       ptr_link     = m_links.data();
+  const uint8_t         through_mask = m_through_mask;
+
+  // Blocks are copied whole.  Outputs of inputs past the end of a short
+  // packet are left at the value they start from, as they are below.
+  for( const DMXRouteBlock& block : m_blocks ) {
+    uint16_t present = ( number_of_channels > block.m_input_index ) ?
+                       std::min<uint16_t>( block.m_count, number_of_channels - block.m_input_index ) : 0;
+    memcpy( &dmx_buffer[ block.m_output_channel ], &data[ block.m_input_index ], present );
+    uint16_t output_channel_end = block.m_output_channel + block.m_count;
+    for( uint16_t output_channel = block.m_output_channel + present; output_channel < output_channel_end; output_channel++ ) {
+      dmx_buffer[ output_channel ] = through[ output_channel ] & through_mask;
+    }
+  }
+
+  // data always has room for 512 channels, so every read below is in bounds;
+  // channels beyond the packet length are masked out rather than branched on.
+  ApplyOutputs<DMX_MERGE_HTP>( ptr_output, ptr_outputs + m_output_ends[ DMX_MERGE_HTP ], ptr_link,
+                               data, number_of_channels, through, through_mask, dmx_buffer );
+  ApplyOutputs<DMX_MERGE_LTP>( ptr_output, ptr_outputs + m_output_ends[ DMX_MERGE_LTP ], ptr_link,
+                               data, number_of_channels, through, through_mask, dmx_buffer );
+  ApplyOutputs<DMX_MERGE_ADD>( ptr_output, ptr_outputs + m_output_ends[ DMX_MERGE_ADD ], ptr_link,
+                               data, number_of_channels, through, through_mask, dmx_buffer );
+  ApplyOutputs<DMX_MERGE_SCALE>( ptr_output, ptr_outputs + m_output_ends[ DMX_MERGE_SCALE ], ptr_link,
+                                 data, number_of_channels, through, through_mask, dmx_buffer );
+  ApplyOutputs<DMX_MERGE_PRIORITY>( ptr_output, ptr_outputs + m_output_ends[ DMX_MERGE_PRIORITY ], ptr_link,
+                                    data, number_of_channels, through, through_mask, dmx_buffer );
+
+  // The rest mix operators.
+  for( const DMXRouteOutput* ptr_output_end = ptr_outputs + m_outputs.size(); ptr_output != ptr_output_end; ptr_output++ ) {
+    uint8_t value = through[ ptr_output->m_output_channel ] & through_mask;
+    for( const uint16_t* ptr_end = ptr_link + ptr_output->m_input_count; ptr_link != ptr_end; ptr_link++ ) {
+      uint16_t input_index = *ptr_link & LINK_INPUT_MASK;
+      uint8_t  present     = -(uint8_t)( input_index < number_of_channels );
+      uint8_t  merged      = Merge( *ptr_link >> LINK_OPERATOR_SHIFT, value, data[ input_index ] );
+      value = ( merged & present ) | ( value & ~present );
+    }
+    dmx_buffer[ ptr_output->m_output_channel ] = value;
+  }
+}
+
+size_t DMXRouter::GetLinkCount() const {
+  size_t link_count = m_links.size();
+  for( const DMXRouteBlock& block : m_blocks ) {
+    link_count += block.m_count;
+  }
+  return link_count;
+}
+
+size_t DMXRouter::GetBlockCount() const {
+  return m_blocks.size();
+}
+
+uint16_t DMXRouter::GetHighestOutputChannel() const {
+  return m_highest_output_channel;
+}
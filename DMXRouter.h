@@ -0,0 +1,96 @@
+#ifndef _DMXROUTER_H_
+#define _DMXROUTER_H_
+
+#include <Arduino.h>
+#include <vector>
+
+#include "DMXRoutingTable.h"
+
+// The DMX routing table compiled into flat, contiguous index arrays.
+//
+// Routes are inverted into one entry per routed output channel, listing every
+// input channel that feeds it and the route's merge operator, in table order.
+// Applying the routes to a packet is then one linear pass : each output starts
+// from its straight-through value, is merged in a register with its inputs and
+// written once.  Outputs fed by routes of one merge operator are grouped, each
+// group with its own loop; only outputs that mix operators look theirs up per
+// input.  Runs of outputs that are each a plain copy of one input, the inputs
+// in the same order, are copied as blocks instead.  Compile() is only called
+// when the config loads or changes, never per packet.
+class DMXRouter {
+public:
+  DMXRouter();
+
+  ~DMXRouter();
+
+  // is_through : routed outputs start from the value Apply() is given for
+  // that channel, otherwise from 0.
+  void Compile( const DMXRoutingTable& routing_table, bool is_through = true );
+
+  // Write the routed outputs for data (number_of_channels long) to dmx_buffer,
+  // starting from through.  Both are indexed by DMX slot (slot 0 is the start
+  // code); only the routed outputs of dmx_buffer are written.
+  void Apply( const uint8_t* data, uint16_t number_of_channels, const uint8_t* through,
+              uint8_t* dmx_buffer ) const;
+
+  // Input to output channel links, those in blocks included.
+  size_t GetLinkCount() const;
+
+  size_t GetBlockCount() const;
+
+  // Highest output channel written by Apply(), 0 without routes.
+  uint16_t GetHighestOutputChannel() const;
+
+  // value merged with input by a DMXMergeOperator.
+  static uint8_t Merge( uint8_t merge_operator, uint8_t value, uint8_t input ) {
+    switch( merge_operator ) {
+      case DMX_MERGE_HTP:
+        return std::max( value, input );
+      case DMX_MERGE_LTP:
+        return input;
+      case DMX_MERGE_ADD:
+        return (uint8_t)std::min( 255, value + input );
+      case DMX_MERGE_SCALE: {
+        // value * input / 255, rounded, without the division.
+        uint32_t scaled = value * input + 128;
+        return (uint8_t)( ( scaled + ( scaled >> 8 ) ) >> 8 );
+      }
+      case DMX_MERGE_PRIORITY:
+        return input ? input : value;
+    }
+    return value;
+  }
+
+private:
+  struct DMXRouteOutput {
+    uint16_t m_output_channel;  // 1 - 512, the DMX slot.
+    uint16_t m_input_count;     // Number of entries in m_links for this output.
+  };
+
+  struct DMXRouteBlock {
+    uint16_t m_input_index;     // 0 based Art-Net data index of the first input.
+    uint16_t m_output_channel;  // DMX slot of the first output.
+    uint16_t m_count;
+  };
+
+  // A link is the 0 based Art-Net data index of an input, with the merge
+  // operator in the top bits for outputs mixing operators.
+  static const uint16_t LINK_INPUT_MASK     = 0x0FFF;
+  static const uint8_t  LINK_OPERATOR_SHIFT = 12;
+
+  // Write the outputs from ptr_output to ptr_output_end, all fed by routes of
+  // MERGE_OPERATOR, their inputs from ptr_link on; both are left past them.
+  template <uint8_t MERGE_OPERATOR>
+  static void ApplyOutputs( const DMXRouteOutput*& ptr_output, const DMXRouteOutput* ptr_output_end,
+                            const uint16_t*& ptr_link, const uint8_t* data, uint16_t number_of_channels,
+                            const uint8_t* through, uint8_t through_mask, uint8_t* dmx_buffer );
+
+  std::vector<DMXRouteOutput> m_outputs;            // By merge operator, then those mixing them, each ascending.
+  std::vector<uint16_t>       m_links;              // Grouped by output, in routing table order within each.
+  std::vector<DMXRouteBlock>  m_blocks;             // Outputs in none of m_outputs.
+  size_t                      m_output_ends[ DMX_MERGE_MAX ];  // Past the last output of each merge operator.
+  uint16_t                    m_highest_output_channel;
+  uint8_t                     m_through_mask;       // 0xFF to start from the straight-through value, 0x00 from 0.
+};
+
+#endif
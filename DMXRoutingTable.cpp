@@ -0,0 +1,192 @@
+#include "DMXRoutingTable.h"
+
+#include <algorithm>
+#include <ctype.h>
+
+DMXRoutingTable::DMXRoutingTable() {
+}
+
+DMXRoutingTable::~DMXRoutingTable() {
+}
+
+size_t DMXRoutingTable::Size() const {
+  return m_routes.size();
+}
+
+const DMXRoutingConfig& DMXRoutingTable::GetRoute( size_t index ) const {
+  return m_routes[ index ];
+}
+
+const uint16_t* DMXRoutingTable::GetOutputChannels( size_t index ) const {
+  return m_output_channels.data() + m_routes[ index ].output_first;
+}
+
+bool DMXRoutingTable::Add( uint16_t input_channel, const std::vector<uint16_t>& output_channels, uint8_t merge_operator,
+                           uint16_t input_count, uint8_t output_stride ) {
+  if( m_output_channels.size() + output_channels.size() > MAX_OUTPUT_CHANNELS ) {
+    return false;
+  }
+
+  DMXRoutingConfig config;
+  config.input_channel  = input_channel;
+  config.input_count    = std::max<uint16_t>( input_count, 1 );
+  config.output_first   = (uint16_t)m_output_channels.size();
+  config.output_count   = (uint16_t)output_channels.size();
+  config.output_stride  = std::max<uint8_t>( output_stride, 1 );
+  config.merge_operator = ( merge_operator < DMX_MERGE_MAX ) ? merge_operator : (uint8_t)DMX_MERGE_HTP;
+
+  m_output_channels.insert( m_output_channels.end(), output_channels.begin(), output_channels.end() );
+  m_routes.push_back( config );
+
+  return true;
+}
+
+bool DMXRoutingTable::Update( size_t index, uint16_t input_channel, const std::vector<uint16_t>& output_channels, uint8_t merge_operator,
+                              uint16_t input_count, uint8_t output_stride ) {
+  if( index >= m_routes.size() ) {
+    return false;
+  }
+
+  DMXRoutingConfig& config = m_routes[ index ];
+  int delta = (int)output_channels.size() - (int)config.output_count;
+
+  if( m_output_channels.size() + delta > MAX_OUTPUT_CHANNELS ) {
+    return false;
+  }
+
+  // Replace this route's slice of the pool and move the following routes along.
+  auto first = m_output_channels.begin() + config.output_first;
+  m_output_channels.erase( first, first + config.output_count );
+  m_output_channels.insert( m_output_channels.begin() + config.output_first, output_channels.begin(), output_channels.end() );
+
+  config.input_channel  = input_channel;
+  config.input_count    = std::max<uint16_t>( input_count, 1 );
+  config.output_count   = (uint16_t)output_channels.size();
+  config.output_stride  = std::max<uint8_t>( output_stride, 1 );
+  config.merge_operator = ( merge_operator < DMX_MERGE_MAX ) ? merge_operator : (uint8_t)DMX_MERGE_HTP;
+
+  for( size_t i = index + 1; i < m_routes.size(); i++ ) {
+    m_routes[ i ].output_first += delta;
+  }
+
+  return true;
+}
+
+bool DMXRoutingTable::Erase( size_t index ) {
+  if( index >= m_routes.size() ) {
+    return false;
+  }
+
+  const DMXRoutingConfig config = m_routes[ index ];
+
+  auto first = m_output_channels.begin() + config.output_first;
+  m_output_channels.erase( first, first + config.output_count );
+  m_routes.erase( m_routes.begin() + index );
+
+  for( size_t i = index; i < m_routes.size(); i++ ) {
+    m_routes[ i ].output_first -= config.output_count;
+  }
+
+  return true;
+}
+
+void DMXRoutingTable::Clear() {
+  m_routes.clear();
+  m_output_channels.clear();
+}
+
+static const char* const MERGE_OPERATOR_NAMES[ DMX_MERGE_MAX ] = { "htp", "ltp", "add", "scale", "priority" };
+
+const char* DMXRoutingTable::GetMergeOperatorName( uint8_t merge_operator ) {
+  return MERGE_OPERATOR_NAMES[ ( merge_operator < DMX_MERGE_MAX ) ? merge_operator : (uint8_t)DMX_MERGE_HTP ];
+}
+
+uint8_t DMXRoutingTable::FindMergeOperator( const String& name ) {
+  for( uint8_t i = 0; i < DMX_MERGE_MAX; i++ ) {
+    if( name.equalsIgnoreCase( MERGE_OPERATOR_NAMES[ i ] ) ) {
+      return i;
+    }
+  }
+  return DMX_MERGE_HTP;
+}
+
+// A channel number as ParseBlock() takes it : digits alone, spaces around them trimmed.
+static bool ParseBlockNumber( String number_str, long& number ) {
+  number_str.trim();
+  if( number_str.isEmpty() || number_str.length() > 3 ) {
+    return false;
+  }
+  for( size_t i = 0; i < number_str.length(); i++ ) {
+    if( !isdigit( (unsigned char)number_str[ i ] ) ) {
+      return false;
+    }
+  }
+  number = number_str.toInt();
+  return true;
+}
+
+bool DMXRoutingTable::ParseBlock( const String& block_str, uint16_t& input_channel, uint16_t& input_count, uint16_t& output_channel, uint8_t& output_stride ) {
+  int separator = block_str.indexOf( '>' );
+  if( separator == -1 ) {
+    return false;
+  }
+
+  String input  = block_str.substring( 0, separator );
+  String output = block_str.substring( separator + 1 );
+
+  int  input_dash  = input.indexOf( '-' );
+  long input_first = 0;
+  long input_last  = 0;
+  if( input_dash == -1 || !ParseBlockNumber( input.substring( 0, input_dash ), input_first ) ||
+      !ParseBlockNumber( input.substring( input_dash + 1 ), input_last ) ) {
+    return false;
+  }
+
+  long stride = 1;
+  int  slash  = output.indexOf( '/' );
+  if( slash != -1 ) {
+    if( !ParseBlockNumber( output.substring( slash + 1 ), stride ) ) {
+      return false;
+    }
+    output = output.substring( 0, slash );
+  }
+  int  output_dash  = output.indexOf( '-' );
+  long output_first = 0;
+  long output_last  = -1;   // Where the block ends, unless given.
+  if( output_dash == -1 ) {
+    if( !ParseBlockNumber( output, output_first ) ) {
+      return false;
+    }
+  } else if( !ParseBlockNumber( output.substring( 0, output_dash ), output_first ) ||
+             !ParseBlockNumber( output.substring( output_dash + 1 ), output_last ) ) {
+    return false;
+  }
+
+  if( input_first < 1 || input_last > 512 || input_first > input_last || output_first < 1 || stride < 1 || stride > 255 ) {
+    return false;
+  }
+
+  // Every input needs its output, within the 512 channels and, when the last
+  // output is given, ending on it.
+  long block_last = output_first + ( input_last - input_first ) * stride;
+  if( block_last > 512 || ( output_last != -1 && output_last != block_last ) ) {
+    return false;
+  }
+
+  input_channel  = (uint16_t)input_first;
+  input_count    = (uint16_t)( input_last - input_first + 1 );
+  output_channel = (uint16_t)output_first;
+  output_stride  = (uint8_t)stride;
+  return true;
+}
+
+String DMXRoutingTable::FormatBlock( size_t index ) const {
+  const DMXRoutingConfig& config = m_routes[ index ];
+  uint16_t output_channel = ( config.output_count > 0 ) ? this->GetOutputChannels( index )[ 0 ] : 0;
+  String block_str = String( config.input_channel ) + "-" + String( config.input_channel + config.input_count - 1 ) + " > " +
+                     String( output_channel ) + "-" + String( output_channel + ( config.input_count - 1 ) * config.output_stride );
+  if( config.output_stride > 1 ) {
+    block_str += "/" + String( config.output_stride );
+  }
+  return block_str;
+}
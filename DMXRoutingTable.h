@@ -0,0 +1,79 @@
+#ifndef _DMXROUTINGTABLE_H_
+#define _DMXROUTINGTABLE_H_
+
+#include <Arduino.h>
+#include <vector>
+
+// How a route combines its input with the value already on an output channel.
+enum DMXMergeOperator : uint8_t {
+  DMX_MERGE_HTP,        // The higher of the two.
+  DMX_MERGE_LTP,        // The route's input replaces the channel.
+  DMX_MERGE_ADD,        // Added, clipped at 255.
+  DMX_MERGE_SCALE,      // The channel scaled by the input, 255 is 100 %.
+  DMX_MERGE_PRIORITY,   // The input replaces the channel while it is above 0.
+  DMX_MERGE_MAX
+};
+
+// One route : an input channel copied to output_count output channels, or a
+// block of input_count channels from input_channel on, the k-th of them going
+// to output + k * output_stride for each output channel.  Channels are DMX
+// addresses, 1 - 512.
+struct DMXRoutingConfig {
+  uint16_t input_channel;
+  uint16_t input_count;     // 1 for a single channel.
+  uint16_t output_first;    // Index of the first output channel in the table's shared pool.
+  uint16_t output_count;
+  uint8_t  output_stride;   // 1 for consecutive channels.
+  uint8_t  merge_operator;  // DMXMergeOperator.
+};
+
+// The list of DMX routes as configured.
+//
+// All output channels of all routes share one pool, so a full table of 512
+// routes costs 10 bytes per route plus 2 bytes per output channel rather than a
+// heap allocated vector per route, and a block of channels is one route.
+class DMXRoutingTable {
+public:
+  DMXRoutingTable();
+
+  ~DMXRoutingTable();
+
+  size_t Size() const;
+
+  const DMXRoutingConfig& GetRoute( size_t index ) const;
+
+  const uint16_t* GetOutputChannels( size_t index ) const;
+
+  bool Add( uint16_t input_channel, const std::vector<uint16_t>& output_channels, uint8_t merge_operator = DMX_MERGE_HTP,
+            uint16_t input_count = 1, uint8_t output_stride = 1 );
+
+  bool Update( size_t index, uint16_t input_channel, const std::vector<uint16_t>& output_channels, uint8_t merge_operator = DMX_MERGE_HTP,
+               uint16_t input_count = 1, uint8_t output_stride = 1 );
+
+  bool Erase( size_t index );
+
+  void Clear();
+
+  // "htp", "ltp", "add", "scale" or "priority", as stored in the config.
+  static const char* GetMergeOperatorName( uint8_t merge_operator );
+
+  // The operator with that name, HTP for anything else.
+  static uint8_t FindMergeOperator( const String& name );
+
+  // A block route written as "first-last > output", "first-last > output-last"
+  // or with every n-th output channel "first-last > output/n".  False for a
+  // block whose outputs don't fit the 512 channels or end on another channel
+  // than output-last.
+  static bool ParseBlock( const String& block_str, uint16_t& input_channel, uint16_t& input_count, uint16_t& output_channel, uint8_t& output_stride );
+
+  // A block route as ParseBlock() reads it, e.g. "1-100 > 201-300".
+  String FormatBlock( size_t index ) const;
+
+  static const size_t MAX_OUTPUT_CHANNELS = 0xFFFF;  // Total over all routes, output_first is 16 bits.
+
+private:
+  std::vector<DMXRoutingConfig> m_routes;
+  std::vector<uint16_t>         m_output_channels;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "DMXTripleBuffer.h"
+
+DMXTripleBuffer::DMXTripleBuffer() {
+  memset( m_frames, 0, sizeof( m_frames ) );
+  m_sizes[ 0 ] = m_sizes[ 1 ] = m_sizes[ 2 ] = DMX_PACKET_SIZE;
+  memset( m_stamps, 0, sizeof( m_stamps ) );
+
+  this->Reset();
+}
+
+void DMXTripleBuffer::Reset() {
+  m_write_index = 0;
+  m_read_index  = 1;
+  m_spare.store( 2, std::memory_order_release );
+}
+
+uint8_t* DMXTripleBuffer::GetWriteBuffer() {
+  return m_frames[ m_write_index ];
+}
+
+void DMXTripleBuffer::Publish( uint16_t size, const DMXFrameStamp& stamp ) {
+  m_sizes[ m_write_index ]  = size;
+  m_stamps[ m_write_index ] = stamp;
+
+  // Release makes the frame contents visible before the index that points at them.
+  uint32_t previous = m_spare.exchange( m_write_index | FRESH, std::memory_order_acq_rel );
+  m_write_index = previous & INDEX_MASK;
+}
+
+bool DMXTripleBuffer::Acquire() {
+  if( ( m_spare.load( std::memory_order_relaxed ) & FRESH ) == 0 ) {
+    return false;
+  }
+
+  uint32_t previous = m_spare.exchange( m_read_index, std::memory_order_acq_rel );
+  m_read_index = previous & INDEX_MASK;
+  return true;
+}
+
+bool DMXTripleBuffer::HasNew() {
+  return ( m_spare.load( std::memory_order_relaxed ) & FRESH ) != 0;
+}
+
+const uint8_t* DMXTripleBuffer::GetReadBuffer() {
+  return m_frames[ m_read_index ];
+}
+
+uint16_t DMXTripleBuffer::GetReadSize() {
+  return m_sizes[ m_read_index ];
+}
+
+const DMXFrameStamp& DMXTripleBuffer::GetReadStamp() {
+  return m_stamps[ m_read_index ];
+}
@@ -0,0 +1,67 @@
+#ifndef _DMXTRIPLEBUFFER_H_
+#define _DMXTRIPLEBUFFER_H_
+
+#include <Arduino.h>
+#include <esp_dmx.h>
+#include <atomic>
+
+// When the data of a frame was received and when it was routed to the port,
+// from micros(), and when the frame started going out.  Frames that don't
+// carry received data, e.g. a blackout, aren't stamped.
+struct DMXFrameStamp {
+  bool     m_is_stamped;
+  uint32_t m_received_us;   // The oldest packet in the frame was read from the socket,
+  uint32_t m_routed_us;     // the frame was routed to the port and published,
+  uint32_t m_sent_us;       // and handed to dmx_send_num(), set by the transmit side.
+};
+
+// Hands DMX frames from the Art-Net receive task to the DMX transmit task
+// without a lock.
+//
+// There are three frames : one the writer fills, one the reader sends and a
+// spare holding the newest complete frame.  Publish() and Acquire() swap a
+// frame with the spare in a single atomic exchange, so the reader only ever
+// sees whole frames and neither side waits for the other.
+//
+// One writer and one reader only.
+class DMXTripleBuffer {
+public:
+  DMXTripleBuffer();
+
+  // Puts the frames back to their initial roles.  Neither side may be running.
+  void Reset();
+
+  // Writer : fill GetWriteBuffer(), then Publish() the first size slots of it.
+  uint8_t* GetWriteBuffer();
+
+  void Publish( uint16_t size = DMX_PACKET_SIZE, const DMXFrameStamp& stamp = DMXFrameStamp() );
+
+  // Reader : swaps in the newest published frame, returns false when nothing
+  // was published since the last call and the read buffer is unchanged.
+  bool Acquire();
+
+  // True when Acquire() would swap in a new frame.
+  bool HasNew();
+
+  const uint8_t* GetReadBuffer();
+
+  uint16_t GetReadSize();
+
+  const DMXFrameStamp& GetReadStamp();
+
+private:
+  static const uint32_t INDEX_MASK = 0x03;
+  static const uint32_t FRESH      = 0x04;
+
+  uint8_t               m_frames[ 3 ][ DMX_PACKET_SIZE ];
+  uint16_t              m_sizes[ 3 ];
+  DMXFrameStamp         m_stamps[ 3 ];
+
+  // Index of the spare frame, plus FRESH when it holds an unread frame.
+  std::atomic<uint32_t> m_spare;
+
+  uint32_t              m_write_index;
+  uint32_t              m_read_index;
+};
+
+#endif
@@ -0,0 +1,13 @@
+#include "E131Parser.h"
+
+const char* E131Parser::GetResultName( Result result ) {
+  switch( result ) {
+    case PARSE_OK:         return "ok";
+    case PARSE_TOO_SHORT:  return "too short";
+    case PARSE_BAD_ID:     return "bad ACN packet identifier";
+    case PARSE_NOT_DATA:   return "not a data packet";
+    case PARSE_BAD_LAYER:  return "bad framing or DMP layer";
+    case PARSE_BAD_LENGTH: return "bad length";
+    default:               return "unknown";
+  }
+}
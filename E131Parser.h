@@ -0,0 +1,104 @@
+#ifndef _E131PARSER_H_
+#define _E131PARSER_H_
+
+#include <Arduino.h>
+
+#include "E131_Spec.h"
+
+// Fields of an E1.31 data packet.  cid and data point into the receive buffer, nothing is copied.
+struct E131DataView {
+  uint16_t       universe;      // 1 - 63999.
+  uint8_t        priority;      // 0 - 200.
+  uint8_t        sequence;
+  uint8_t        options;       // E131_OPTION_ bits.
+  uint8_t        start_code;    // 0 for DMX levels.
+  uint16_t       length;        // Channels in data, 1 - 512.
+  const uint8_t* cid;           // 16 bytes, the source's identity.
+  const uint8_t* data;
+};
+
+// Validates received E1.31 datagrams in place, like ArtNetParser does Art-Net.
+//
+// Every field is bounds checked against the number of bytes actually
+// received, the three PDU lengths have to agree with the property value
+// count, and nothing is allocated.  The parse functions are inline as they
+// run for every packet.
+class E131Parser {
+public:
+  enum Result : uint8_t {
+    PARSE_OK,
+    PARSE_TOO_SHORT,        // Shorter than the layers up to the START code.
+    PARSE_BAD_ID,           // Not an ACN root layer packet.
+    PARSE_NOT_DATA,         // Synchronization or universe discovery, nothing a DMX output needs.
+    PARSE_BAD_LAYER,        // Framing or DMP layer vectors, addressing or universe out of spec.
+    PARSE_BAD_LENGTH,       // No channels, over 512, more than was received or PDU lengths disagreeing.
+    PARSE_RESULT_MAX
+  };
+
+  static const size_t DMX_DATA_START = E131_OFFSET_DMX_DATA;
+
+  // The universe of a data packet from its first DMX_DATA_START bytes, so
+  // that the data needn't be read for a universe nobody wants.
+  static Result PeekUniverse( const uint8_t* buffer, size_t size, uint16_t& universe ) {
+    if( size < DMX_DATA_START ) {
+      return PARSE_TOO_SHORT;
+    }
+    if( ReadBE16( buffer + E131_OFFSET_PREAMBLE ) != 0x0010 || ReadBE16( buffer + E131_OFFSET_POSTAMBLE ) != 0x0000 ||
+        memcmp( buffer + E131_OFFSET_ACN_ID, E131_ACN_ID, 12 ) != 0 ) {
+      return PARSE_BAD_ID;
+    }
+    if( ReadBE32( buffer + E131_OFFSET_ROOT_VECTOR ) != E131_VECTOR_ROOT_DATA ) {
+      return PARSE_NOT_DATA;
+    }
+    universe = ReadBE16( buffer + E131_OFFSET_UNIVERSE );
+    return PARSE_OK;
+  }
+
+  static Result Parse( const uint8_t* buffer, size_t size, E131DataView& view ) {
+    uint16_t universe = 0;
+    Result   result   = PeekUniverse( buffer, size, universe );
+    if( result != PARSE_OK ) {
+      return result;
+    }
+
+    if( ReadBE32( buffer + E131_OFFSET_FRAMING_VECTOR ) != E131_VECTOR_FRAMING_DATA ||
+        buffer[ E131_OFFSET_DMP_VECTOR ] != E131_VECTOR_DMP_SET_PROPERTY || buffer[ E131_OFFSET_ADDRESS_TYPE ] != E131_DMP_ADDRESS_DATA_TYPE ||
+        ReadBE16( buffer + E131_OFFSET_FIRST_ADDRESS ) != 0x0000 || ReadBE16( buffer + E131_OFFSET_ADDRESS_INCREMENT ) != 0x0001 ||
+        universe < E131_UNIVERSE_MIN || universe > E131_UNIVERSE_MAX || buffer[ E131_OFFSET_PRIORITY ] > E131_PRIORITY_MAX ) {
+      return PARSE_BAD_LAYER;
+    }
+
+    // Each PDU runs from its length field to the end of the data.
+    uint16_t count = ReadBE16( buffer + E131_OFFSET_VALUE_COUNT );
+    size_t   end   = E131_OFFSET_START_CODE + count;
+    if( count < 2 || count > 513 || end > size ||
+        ( ReadBE16( buffer + E131_OFFSET_ROOT_LENGTH ) & 0x0FFF ) != end - E131_OFFSET_ROOT_LENGTH ||
+        ( ReadBE16( buffer + E131_OFFSET_FRAMING_LENGTH ) & 0x0FFF ) != end - E131_OFFSET_FRAMING_LENGTH ||
+        ( ReadBE16( buffer + E131_OFFSET_DMP_LENGTH ) & 0x0FFF ) != end - E131_OFFSET_DMP_LENGTH ) {
+      return PARSE_BAD_LENGTH;
+    }
+
+    view.universe   = universe;
+    view.priority   = buffer[ E131_OFFSET_PRIORITY ];
+    view.sequence   = buffer[ E131_OFFSET_SEQUENCE ];
+    view.options    = buffer[ E131_OFFSET_OPTIONS ];
+    view.start_code = buffer[ E131_OFFSET_START_CODE ];
+    view.length     = count - 1;
+    view.cid        = buffer + E131_OFFSET_CID;
+    view.data       = buffer + DMX_DATA_START;
+    return PARSE_OK;
+  }
+
+  static const char* GetResultName( Result result );
+
+private:
+  static uint16_t ReadBE16( const uint8_t* ptr ) {
+    return ptr[ 0 ] << 8 | ptr[ 1 ];
+  }
+
+  static uint32_t ReadBE32( const uint8_t* ptr ) {
+    return (uint32_t)ptr[ 0 ] << 24 | (uint32_t)ptr[ 1 ] << 16 | (uint32_t)ptr[ 2 ] << 8 | ptr[ 3 ];
+  }
+};
+
+#endif
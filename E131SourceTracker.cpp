@@ -0,0 +1,77 @@
+#include "E131SourceTracker.h"
+
+E131SourceTracker::E131SourceTracker() {
+}
+
+E131SourceTracker::~E131SourceTracker() {
+}
+
+void E131SourceTracker::Reset( size_t universe_count ) {
+  m_sources.assign( universe_count * SOURCES_PER_UNIVERSE, Source() );
+}
+
+E131SourceTracker::Result E131SourceTracker::Check( uint16_t universe_index, const E131DataView& view, uint32_t now_ms, uint32_t& source_id, Dropped& dropped ) {
+  dropped.m_count = 0;
+  source_id       = GetSourceId( view.cid );
+
+  // Sources gone silent are dropped first, so a lower priority can take over.
+  Source* ptr_sources = &m_sources[ universe_index * SOURCES_PER_UNIVERSE ];
+  Source* ptr_source  = nullptr;
+  Source* ptr_free    = nullptr;
+  for( uint8_t i = 0; i < SOURCES_PER_UNIVERSE; i++ ) {
+    Source* ptr_slot = &ptr_sources[ i ];
+    if( ptr_slot->m_is_used && now_ms - ptr_slot->m_last_ms >= DATA_LOSS_MS ) {
+      ptr_slot->m_is_used = false;
+      dropped.m_ids[ dropped.m_count++ ] = ptr_slot->m_id;
+    }
+    if( ptr_slot->m_is_used && memcmp( ptr_slot->m_cid, view.cid, sizeof( ptr_slot->m_cid ) ) == 0 ) {
+      ptr_source = ptr_slot;
+    } else if( !ptr_slot->m_is_used && ptr_free == nullptr ) {
+      ptr_free = ptr_slot;
+    }
+  }
+
+  if( ptr_source == nullptr ) {
+    if( view.options & E131_OPTION_TERMINATED ) {
+      return SOURCE_TERMINATED;
+    }
+    if( ptr_free == nullptr ) {
+      return SOURCE_IGNORED;
+    }
+    ptr_source = ptr_free;
+    memcpy( ptr_source->m_cid, view.cid, sizeof( ptr_source->m_cid ) );
+    ptr_source->m_id      = source_id;
+    ptr_source->m_is_used = true;
+  } else {
+    // E1.31 6.7.2 : -20 < new - last <= 0 is out of order.
+    int distance = (int8_t)( view.sequence - ptr_source->m_sequence );
+    if( distance <= 0 && distance > -STALE_WINDOW ) {
+      return SOURCE_STALE;
+    }
+  }
+  ptr_source->m_sequence = view.sequence;
+  ptr_source->m_last_ms  = now_ms;
+  ptr_source->m_priority = view.priority;
+
+  if( view.options & E131_OPTION_TERMINATED ) {
+    ptr_source->m_is_used = false;
+    dropped.m_ids[ dropped.m_count++ ] = ptr_source->m_id;
+    return SOURCE_TERMINATED;
+  }
+
+  for( uint8_t i = 0; i < SOURCES_PER_UNIVERSE; i++ ) {
+    const Source& other = ptr_sources[ i ];
+    if( &other != ptr_source && other.m_is_used && other.m_priority > view.priority ) {
+      return SOURCE_OUTRANKED;
+    }
+  }
+
+  // Any source below this one's priority stops being output.
+  for( uint8_t i = 0; i < SOURCES_PER_UNIVERSE; i++ ) {
+    const Source& other = ptr_sources[ i ];
+    if( other.m_is_used && other.m_priority < view.priority ) {
+      dropped.m_ids[ dropped.m_count++ ] = other.m_id;
+    }
+  }
+  return SOURCE_ACCEPTED;
+}
@@ -0,0 +1,74 @@
+#ifndef _E131SOURCETRACKER_H_
+#define _E131SOURCETRACKER_H_
+
+#include <Arduino.h>
+#include <vector>
+
+#include "E131Parser.h"
+
+// Decides which sACN sources of a universe reach the output, as E1.31 has
+// receivers do, before their frames go to ArtNetMerger.
+//
+// Sources are told apart by their CID, not their IP address.  Only the
+// sources at the universe's highest priority are output; when one of them
+// goes a source of a lower priority takes over with its next packet.  Equal
+// priorities are merged.  A packet up to STALE_WINDOW behind the source's
+// last sequence number, or the same, is out of order and dropped.  A source
+// is gone when it says so with the stream terminated option, or once silent
+// for DATA_LOSS_MS.
+//
+// Sources that stop being output are handed back in Dropped, so that the
+// merger forgets their last frame at once rather than after its timeout.
+class E131SourceTracker {
+public:
+  enum Result : uint8_t {
+    SOURCE_ACCEPTED,
+    SOURCE_STALE,           // Out of sequence; drop it.
+    SOURCE_OUTRANKED,       // Below the priority of another source of the universe.
+    SOURCE_TERMINATED,      // The source stopped sending the universe.
+    SOURCE_IGNORED          // Beyond SOURCES_PER_UNIVERSE sources.
+  };
+
+  static const uint8_t  SOURCES_PER_UNIVERSE = 4;
+  static const int      STALE_WINDOW         = 20;
+  static const uint32_t DATA_LOSS_MS         = E131_NETWORK_DATA_LOSS_MS;
+
+  // Sources no longer output, for ArtNetMerger::RemoveSource().
+  struct Dropped {
+    uint8_t  m_count;
+    uint32_t m_ids[ SOURCES_PER_UNIVERSE ];
+  };
+
+  E131SourceTracker();
+
+  ~E131SourceTracker();
+
+  // Forgets every source, for universes 0 .. universe_count - 1 (ArtNetUniverseMap::Entry::m_index).
+  void Reset( size_t universe_count );
+
+  // source_id is set to the id the source merges under, from its CID.
+  Result Check( uint16_t universe_index, const E131DataView& view, uint32_t now_ms, uint32_t& source_id, Dropped& dropped );
+
+  // 32 bit FNV-1a of the 16 byte CID.
+  static uint32_t GetSourceId( const uint8_t* cid ) {
+    uint32_t hash = 2166136261u;
+    for( uint8_t i = 0; i < 16; i++ ) {
+      hash = ( hash ^ cid[ i ] ) * 16777619u;
+    }
+    return hash;
+  }
+
+private:
+  struct Source {
+    uint8_t  m_cid[ 16 ];
+    uint32_t m_id;
+    uint32_t m_last_ms;
+    uint8_t  m_priority;
+    uint8_t  m_sequence;
+    bool     m_is_used;
+  };
+
+  std::vector<Source> m_sources;    // SOURCES_PER_UNIVERSE per universe.
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef _E131_SPEC_H_
+#define _E131_SPEC_H_
+
+// Refer to ANSI E1.31 (sACN, Streaming ACN) for the full specification.
+
+// Only what a receiver of E1.31 data packets needs :
+//    Root layer, framing layer and DMP layer offsets of a data packet
+//    The vectors telling data packets from sync and universe discovery
+//    Framing options, priorities and the multicast addressing of universes
+
+#define E131_UDP_PORT               5568
+#define E131_ACN_ID                 "ASC-E1.17\0\0\0"   // 12 bytes, NUL padded.
+
+#define E131_VECTOR_ROOT_DATA       0x00000004
+#define E131_VECTOR_ROOT_EXTENDED   0x00000008    // Synchronization and universe discovery.
+#define E131_VECTOR_FRAMING_DATA    0x00000002
+#define E131_VECTOR_DMP_SET_PROPERTY 0x02
+#define E131_DMP_ADDRESS_DATA_TYPE  0xA1
+
+#define E131_OPTION_PREVIEW         0x80    // For visualisers, not to be output.
+#define E131_OPTION_TERMINATED      0x40    // The source stops sending the universe, now.
+#define E131_OPTION_FORCE_SYNC      0x20
+
+#define E131_PRIORITY_DEFAULT       100
+#define E131_PRIORITY_MAX           200
+#define E131_UNIVERSE_MIN           1
+#define E131_UNIVERSE_MAX           63999
+#define E131_NETWORK_DATA_LOSS_MS   2500    // A source silent this long is gone.
+
+// Offsets into a data packet.  Multi byte fields are big endian.
+#define E131_OFFSET_PREAMBLE        0     // 2 : 0x0010
+#define E131_OFFSET_POSTAMBLE       2     // 2 : 0x0000
+#define E131_OFFSET_ACN_ID          4     // 12
+#define E131_OFFSET_ROOT_LENGTH     16    // 2 : 0x7000 flags | PDU length
+#define E131_OFFSET_ROOT_VECTOR     18    // 4
+#define E131_OFFSET_CID             22    // 16 : the source's UUID.
+#define E131_OFFSET_FRAMING_LENGTH  38    // 2
+#define E131_OFFSET_FRAMING_VECTOR  40    // 4
+#define E131_OFFSET_SOURCE_NAME     44    // 64 : UTF-8, NUL terminated.
+#define E131_OFFSET_PRIORITY        108   // 1
+#define E131_OFFSET_SYNC_ADDRESS    109   // 2
+#define E131_OFFSET_SEQUENCE        111   // 1
+#define E131_OFFSET_OPTIONS         112   // 1
+#define E131_OFFSET_UNIVERSE        113   // 2
+#define E131_OFFSET_DMP_LENGTH      115   // 2
+#define E131_OFFSET_DMP_VECTOR      117   // 1
+#define E131_OFFSET_ADDRESS_TYPE    118   // 1
+#define E131_OFFSET_FIRST_ADDRESS   119   // 2 : 0x0000
+#define E131_OFFSET_ADDRESS_INCREMENT 121 // 2 : 0x0001
+#define E131_OFFSET_VALUE_COUNT     123   // 2 : START code plus channels, 1 - 513.
+#define E131_OFFSET_START_CODE      125   // 1
+#define E131_OFFSET_DMX_DATA        126
+
+#define E131_PACKET_MINSIZE_DATA    126   // Up to and including the START code.
+#define E131_PACKET_MAXSIZE         638   // 512 channels.
+
+#endif
@@ -1,12 +1,69 @@
 #include "Print.h"
 #include "ESP32Artnet2DMX.h"
 
-ESP32Artnet2DMX::ESP32Artnet2DMX() {
-  memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
+#include <algorithm>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <lwip/igmp.h>
+#include <lwip/tcpip.h>
+
+// The WiFi stack lives on core 0, so Art-Net is received there and DMX is sent
+// from the other core, at a higher priority than loop() and its web server.
+#if portNUM_PROCESSORS > 1
+#define ARTNET_RECEIVE_CORE  0
+#define DMX_TRANSMIT_CORE    1
+#else
+#define ARTNET_RECEIVE_CORE  0
+#define DMX_TRANSMIT_CORE    0
+#endif
+
+#define ARTNET_RECEIVE_PRIORITY  2
+#define DMX_TRANSMIT_PRIORITY    3
+#define TASK_STACK_SIZE          4096
+
+#define NODE_SHORT_NAME "ESP32-Artnet2DMX"
+#define NODE_LONG_NAME  "ESP32-Artnet2DMX, Art-Net to DMX512 node"
+
+// Synchronous, a port not sent to by ArtSync for this long sends its frame again.
+#define DMX_SYNC_KEEPALIVE_US 1000000
+
+// Art-Net's own, a node goes back to sending frames as they arrive after this long without ArtSync.
+#define ARTNET_SYNC_DEFAULT_TIMEOUT_MS 4000
 
+// Longest the receive side keeps draining the UDP queue before it applies what
+// it has, so that a flood can't hold back the DMX output.
+#define ARTNET_RECEIVE_BUDGET_US 2000
+
+// How often merging sources are checked for going silent, besides when their universe's packets arrive.
+#define ARTNET_MERGE_EXPIRY_INTERVAL_MS 100
+
+// Longest /stats response.
+#define STATS_JSON_MAXSIZE 2048
+
+ESP32Artnet2DMX::ESP32Artnet2DMX() {
   m_artnet_source_ipaddress_any.fromString( "255.255.255.255" );
 
   m_is_started = false;
+  m_use_tasks  = true;
+  m_ptr_WebServer    = nullptr;
+  m_is_tasks_running = false;
+  m_task_count       = 0;
+  m_forced_ports     = 0;
+  m_changed_ports    = 0;
+  m_stamped_ports    = 0;
+  memset( m_port_received_us, 0, sizeof( m_port_received_us ) );
+  m_is_jitter_buffered = false;
+  m_is_artnet_timeout_armed = false;
+  m_is_synchronous   = false;
+
+  m_pending_count = 0;
+  m_receive_stats = ArtNetReceiveStats();
+  memset( m_routing_through, 0, sizeof( m_routing_through ) );
+  memset( m_routing_input, 0, sizeof( m_routing_input ) );
+  m_routing_input_length = 0;
+  m_is_sacn_enabled    = false;
+  m_sacn_receive_stats = SACNReceiveStats();
 }
 
 ESP32Artnet2DMX::~ESP32Artnet2DMX() {
@@ -15,6 +72,8 @@ ESP32Artnet2DMX::~ESP32Artnet2DMX() {
 
 void ESP32Artnet2DMX::Init( WebServer* ptr_WebServer ) {
 
+  m_ptr_WebServer = ptr_WebServer;
+
   m_ConfigServer.Init();
 
   m_ConfigServer.ConnectToWiFi();
@@ -26,13 +85,35 @@ void ESP32Artnet2DMX::Init( WebServer* ptr_WebServer ) {
 
 bool ESP32Artnet2DMX::Start() {
 
-  dmx_config_t config = DMX_CONFIG_DEFAULT;
-  dmx_personality_t personalities[] = {};
-  int personality_count = 0;
+  DMXPortConfig port_config;
+  port_config.enabled         = true;
+  port_config.gpio_enable     = m_ConfigServer.m_gpio_enable;
+  port_config.gpio_transmit   = m_ConfigServer.m_gpio_transmit;
+  port_config.gpio_receive    = m_ConfigServer.m_gpio_receive;
+  port_config.artnet_universe = m_ConfigServer.m_artnet_universe;
+
+  DMXOutputTiming timing;
+  timing.update_interval_us = m_ConfigServer.m_dmx_update_interval_ms * 1000;
+  timing.is_send_on_receive = m_ConfigServer.m_dmx_send_on_receive;
+  timing.min_frame_gap_us   = m_ConfigServer.m_dmx_min_frame_gap_us;
+  timing.min_frame_channels = m_ConfigServer.m_dmx_min_frame_channels;
+
+  // Curves first, so the first frame a port publishes goes through them too.
+  m_DMXCurves.Compile( m_ConfigServer.m_dmx_curves );
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    m_dmx_ports[ i ].SetCurves( m_DMXCurves.GetTables(), m_DMXCurves.GetCurveIndexes( i ) );
+    m_dmx_ports[ i ].SetInterpolation( m_ConfigServer.m_dmx_interpolate, i, m_ConfigServer.m_dmx_interpolation_channels );
+    m_dmx_ports[ i ].SetJitterBuffer( m_ConfigServer.m_dmx_jitter_delay_ms * 1000 );
+  }
+  m_is_jitter_buffered = ( m_ConfigServer.m_dmx_jitter_delay_ms != 0 );
 
-  dmx_driver_install( DMX_NUM_1, &config, personalities, personality_count );
+  m_dmx_ports[ 0 ].Start( 0, port_config, timing );
 
-  dmx_set_pin( DMX_NUM_1, m_ConfigServer.m_gpio_transmit, m_ConfigServer.m_gpio_receive, m_ConfigServer.m_gpio_enable );
+  for( int i = 1; i < DMX_PORT_MAX; i++ ) {
+    if( m_ConfigServer.m_dmx_extra_ports[ i - 1 ].enabled ) {
+      m_dmx_ports[ i ].Start( i, m_ConfigServer.m_dmx_extra_ports[ i - 1 ], timing );
+    }
+  }
 
   if( !m_WiFiUDP.begin( ARTNET_UDP_PORT ) ) {
     Serial.print("Failed to create Art-Net network socket on UDP port 6464\n");
@@ -41,12 +122,89 @@ bool ESP32Artnet2DMX::Start() {
 
   m_artnet_source_ipaddress.fromString( m_ConfigServer.m_artnet_source_ip );
 
-  m_dmx_update_time_next_ms = millis();
+  // Routing only changes with the config, so compile it once here rather than per packet.
+  m_DMXRouter.Compile( m_ConfigServer.m_dmx_routing_table, !m_ConfigServer.m_dmx_routing_only );
+  m_dmx_ports[ 0 ].MarkUsed( m_DMXRouter.GetHighestOutputChannel() );
 
-  if( m_ConfigServer.m_artnet_timeout_ms == 0 ) {
-    m_artnet_timeout_next_ms = 0;
-  } else {
-    m_artnet_timeout_next_ms = m_dmx_update_time_next_ms + m_ConfigServer.m_artnet_timeout_ms;
+  std::vector<ArtNetUniverseSlice> slices = m_ConfigServer.m_artnet_universe_slices;
+  if( slices.empty() ) {
+    // No patch, the whole of the configured universe goes straight through.
+    slices.push_back( { (uint16_t)m_ConfigServer.m_artnet_universe, 1, 1, 512, 0 } );
+  }
+  if( m_ConfigServer.m_dmx_routing_only ) {
+    // Port 1 only sends what the routes write, the routed universe isn't copied through.
+    slices.erase( std::remove_if( slices.begin(), slices.end(), [this]( const ArtNetUniverseSlice& slice ) {
+      return slice.port == 0 && slice.universe == (uint16_t)m_ConfigServer.m_artnet_universe;
+    } ), slices.end() );
+  }
+  // Additional ports each send one whole universe.
+  for( int i = 1; i < DMX_PORT_MAX; i++ ) {
+    if( m_dmx_ports[ i ].IsStarted() ) {
+      slices.push_back( { (uint16_t)m_ConfigServer.m_dmx_extra_ports[ i - 1 ].artnet_universe, 1, 1, 512, (uint8_t)i } );
+    }
+  }
+  if( !m_ArtNetUniverseMap.Compile( slices, m_ConfigServer.m_artnet_universe ) ) {
+    // Nothing is received until the config is changed.
+    Serial.printf( "Too many universe slices, %u of at most %u\n", (unsigned)slices.size(), (unsigned)ArtNetUniverseMap::MAX_SLICES );
+    m_WiFiUDP.stop();
+    return false;
+  }
+
+  size_t universe_count = m_ArtNetUniverseMap.GetUniverseCount();
+  m_pending_frames.assign( universe_count, PendingFrame{ nullptr, nullptr, false, 0 } );
+  m_pending_count = 0;
+  m_receive_stats = ArtNetReceiveStats();
+  memset( m_routing_through, 0, sizeof( m_routing_through ) );
+  memset( m_routing_input, 0, sizeof( m_routing_input ) );
+  m_routing_input_length = 0;
+  m_ArtNetSequenceTracker.Reset( universe_count );
+
+  // sACN universe N is Art-Net universe N, 1 - 63999, its frames merge with Art-Net's.
+  m_is_sacn_enabled    = m_ConfigServer.m_sacn_enabled;
+  m_sacn_receive_stats = SACNReceiveStats();
+  m_E131SourceTracker.Reset( universe_count );
+  if( m_is_sacn_enabled ) {
+    if( !m_sACNUDP.begin( E131_UDP_PORT ) ) {
+      Serial.print( "Failed to create sACN network socket on UDP port 5568\n" );
+      m_is_sacn_enabled = false;
+    } else {
+      this->SetSACNGroups( true );
+    }
+  }
+  size_t buffer_size = m_is_sacn_enabled ? std::max( ARTNET_PACKET_MAXSIZE, E131_PACKET_MAXSIZE ) : ARTNET_PACKET_MAXSIZE;
+  m_ArtNetMerger.Reset( universe_count, buffer_size, m_ConfigServer.m_artnet_merge_ltp, m_ConfigServer.m_artnet_merge_timeout_ms );
+
+  // The poll replies are built once here, UpdatePollReply() patches them.
+  m_node_info.ip               = m_ConfigServer.IsConnectedToWiFi() ? WiFi.localIP() : WiFi.softAPIP();
+  m_node_info.is_dhcp          = m_ConfigServer.IsConnectedToWiFi() && m_ConfigServer.m_wifi_ip.length() == 0;
+  m_node_info.is_failsafe_zero = ( m_ConfigServer.m_artnet_timeout_ms != 0 );
+  m_node_info.short_name       = NODE_SHORT_NAME;
+  m_node_info.long_name        = NODE_LONG_NAME;
+  WiFi.macAddress( m_node_info.mac );
+  m_ArtNetPollResponder.Build( m_node_info, m_ArtNetUniverseMap.GetUniverses() );
+
+  // The tasks keep their own copy so the web server can't change it underneath.
+  m_artnet_timeout_ms = m_ConfigServer.m_artnet_timeout_ms;
+
+  m_is_artnet_timeout_armed = ( m_artnet_timeout_ms != 0 );
+  m_artnet_timeout_next_ms  = millis() + m_artnet_timeout_ms;
+
+  m_artnet_sync_timeout_ms = m_ConfigServer.m_artnet_sync_timeout_ms ? m_ConfigServer.m_artnet_sync_timeout_ms : ARTNET_SYNC_DEFAULT_TIMEOUT_MS;
+  m_is_synchronous         = false;
+
+  m_merge_expiry_next_ms = millis() + ARTNET_MERGE_EXPIRY_INTERVAL_MS;
+
+  m_changed_ports = 0;
+  m_stamped_ports = 0;
+  m_forced_ports  = 0;
+
+  m_NodeTelemetry.Reset( micros() );
+
+  if( m_use_tasks ) {
+    m_is_tasks_running = true;
+    m_task_count = 2;
+    xTaskCreatePinnedToCore( ReceiveTask, "artnet_rx", TASK_STACK_SIZE, this, ARTNET_RECEIVE_PRIORITY, NULL, ARTNET_RECEIVE_CORE );
+    xTaskCreatePinnedToCore( TransmitTask, "dmx_tx", TASK_STACK_SIZE, this, DMX_TRANSMIT_PRIORITY, NULL, DMX_TRANSMIT_CORE );
   }
 
   m_is_started = true;
@@ -55,12 +213,24 @@ bool ESP32Artnet2DMX::Start() {
 }
 
 void ESP32Artnet2DMX::Stop() {
-  if( dmx_driver_is_installed( DMX_NUM_1 ) ) {
-    dmx_driver_delete( DMX_NUM_1 ) ;
+  // The tasks finish their current packet or frame before the ports and socket go away.
+  m_is_tasks_running = false;
+  while( m_task_count > 0 ) {
+    delay( 1 );
+  }
+
+  for( DMXPort& dmx_port : m_dmx_ports ) {
+    dmx_port.Stop();
   }
 
   m_WiFiUDP.stop();
 
+  if( m_is_sacn_enabled ) {
+    this->SetSACNGroups( false );
+    m_sACNUDP.stop();
+    m_is_sacn_enabled = false;
+  }
+
   m_is_started = false;
   return;
 }
@@ -69,6 +239,34 @@ bool ESP32Artnet2DMX::IsStarted() {
   return m_is_started;
 }
 
+void ESP32Artnet2DMX::SetUseTasks( bool use_tasks ) {
+  m_use_tasks = use_tasks;
+}
+
+DMXPort& ESP32Artnet2DMX::GetDMXPort( int port_index ) {
+  return m_dmx_ports[ port_index ];
+}
+
+const ArtNetReceiveStats& ESP32Artnet2DMX::GetReceiveStats() const {
+  return m_receive_stats;
+}
+
+const SACNReceiveStats& ESP32Artnet2DMX::GetSACNReceiveStats() const {
+  return m_sacn_receive_stats;
+}
+
+const ArtNetMerger::Stats& ESP32Artnet2DMX::GetMergeStats() const {
+  return m_ArtNetMerger.GetStats();
+}
+
+const ArtNetPollResponder& ESP32Artnet2DMX::GetPollResponder() const {
+  return m_ArtNetPollResponder;
+}
+
+const NodeTelemetry& ESP32Artnet2DMX::GetTelemetry() const {
+  return m_NodeTelemetry;
+}
+
 void ESP32Artnet2DMX::Update() {
 
   if( m_ConfigServer.Update() ) {
@@ -76,113 +274,630 @@ void ESP32Artnet2DMX::Update() {
     this->Start();
   }
 
-  this->CheckForArtNetData();
-
-  if( millis() >= m_dmx_update_time_next_ms ) {
-    this->SendDMX();
+  if( !m_use_tasks ) {
+    this->ReceiveArtNet();
+    this->TransmitDMX();
   }
+}
 
-  if( ( m_artnet_timeout_next_ms != 0 ) && ( millis() >= m_artnet_timeout_next_ms ) ) {
-    m_artnet_timeout_next_ms = 0;
-    memset( m_dmx_buffer, 0, sizeof( m_dmx_buffer ) );
-    this->SendDMX();
+void ESP32Artnet2DMX::ReceiveTask( void* ptr_parameter ) {
+  ESP32Artnet2DMX* ptr_this = (ESP32Artnet2DMX*)ptr_parameter;
+
+  while( ptr_this->m_is_tasks_running ) {
+    // A flood that keeps using up the drain budget would otherwise never
+    // block, starving IDLE on this core until the task watchdog trips.
+    uint32_t budget_exceeded = ptr_this->m_receive_stats.m_budget_exceeded;
+    if( !ptr_this->ReceiveArtNet() || ptr_this->m_receive_stats.m_budget_exceeded != budget_exceeded ) {
+      vTaskDelay( 1 );
+    }
   }
+
+  ptr_this->m_task_count--;
+  vTaskDelete( NULL );
 }
 
-void ESP32Artnet2DMX::HandleWebServerData() {
-  m_ConfigServer.HandleWebServerData();
+void ESP32Artnet2DMX::TransmitTask( void* ptr_parameter ) {
+  ESP32Artnet2DMX* ptr_this = (ESP32Artnet2DMX*)ptr_parameter;
+
+  while( ptr_this->m_is_tasks_running ) {
+    if( ptr_this->TransmitDMX() ) {
+      // This task has nothing else to do until the UARTs are free again.
+      for( DMXPort& dmx_port : ptr_this->m_dmx_ports ) {
+        dmx_port.WaitSent();
+      }
+    } else {
+      vTaskDelay( 1 );
+    }
+  }
+
+  ptr_this->m_task_count--;
+  vTaskDelete( NULL );
 }
 
-void ESP32Artnet2DMX::CheckForArtNetData() {
-  int packet_size_in_bytes = m_WiFiUDP.parsePacket();
+// Receive side : drains the queued packets, applies the newest frame of each
+// universe to the port frames and publishes the ones that changed.  Returns
+// false when there was nothing to read.
+bool ESP32Artnet2DMX::ReceiveArtNet() {
+  uint32_t start_us  = micros();
+  bool     is_packet = false;
+
+  // Both sockets are drained turn about, so neither protocol waits on the other.
+  while( true ) {
+    bool is_read = this->CheckForArtNetData();
+    if( m_is_sacn_enabled ) {
+      is_read |= this->CheckForSACNData();
+    }
+    if( !is_read ) {
+      break;
+    }
+    is_packet = true;
+    if( DMXFrameScheduler::HasReached( micros(), start_us + ARTNET_RECEIVE_BUDGET_US ) ) {
+      m_receive_stats.m_budget_exceeded++;
+      break;
+    }
+  }
 
-  if( packet_size_in_bytes == 0 ) {
-    return;
+  if( DMXFrameScheduler::HasReached( millis(), m_merge_expiry_next_ms ) ) {
+    this->ExpireMergeSources();
   }
 
-  m_WiFiUDP.read( m_data_buffer, ARTNET_PACKET_MAXSIZE );
+  if( m_is_synchronous && DMXFrameScheduler::HasReached( millis(), m_artnet_sync_last_ms + m_artnet_sync_timeout_ms ) ) {
+    m_is_synchronous = false;
+    m_receive_stats.m_sync_timeouts++;
+  }
 
-  if( packet_size_in_bytes < ARTNET_PACKET_MINSIZE_HEADER ) {
-    if( packet_size_in_bytes != 0 ) {
-      Serial.printf( "Packet ignored with data length = %i\n", packet_size_in_bytes );
+  // Synchronous, the frames wait for ArtSync.
+  if( !m_is_synchronous ) {
+    this->ApplyPendingFrames();
+  }
+
+  if( m_is_artnet_timeout_armed && DMXFrameScheduler::HasReached( millis(), m_artnet_timeout_next_ms ) ) {
+    m_is_artnet_timeout_armed = false;
+    // Only the started ports, the others have no frame to publish.
+    uint8_t started_ports = 0;
+    for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+      if( m_dmx_ports[ i ].IsStarted() ) {
+        m_dmx_ports[ i ].Clear();
+        started_ports |= 1 << i;
+      }
     }
+    m_changed_ports = started_ports;
+    m_stamped_ports = 0;
+    m_forced_ports  = started_ports;
+    memset( m_routing_through, 0, sizeof( m_routing_through ) );
+    m_routing_input_length = 0;
+  }
+
+  this->PublishChangedPorts();
+
+  // Controllers that polled are answered once their back-off is up.
+  if( m_ArtNetPollResponder.IsActive() ) {
+    this->UpdatePollReply();
+    m_ArtNetPollResponder.Send( m_WiFiUDP, micros() );
+  }
+
+  m_NodeTelemetry.OnReceive( m_receive_stats, m_sacn_receive_stats, start_us, micros(), millis() );
+
+  return is_packet;
+}
+
+// Brings the fields of the poll replies that change up to date, only those
+// that did are written.
+void ESP32Artnet2DMX::UpdatePollReply() {
+  uint32_t now_ms         = millis();
+  bool     is_blacked_out = ( m_artnet_timeout_ms != 0 && !m_is_artnet_timeout_armed );
+  uint8_t  merge_mode     = m_ArtNetMerger.IsLTP() ? ArtNetPollResponder::OUTPUT_LTP : 0;
+  size_t   live_count     = 0;
+  for( size_t i = 0; i < m_pending_frames.size(); i++ ) {
+    uint8_t sources     = is_blacked_out ? 0 : m_ArtNetMerger.GetSourceCount( i, now_ms );
+    uint8_t good_output = merge_mode;
+    if( sources > 0 ) {
+      good_output |= ArtNetPollResponder::OUTPUT_TRANSMITTING;
+      live_count++;
+    }
+    if( sources > 1 ) {
+      good_output |= ArtNetPollResponder::OUTPUT_MERGING;
+    }
+    m_ArtNetPollResponder.SetPortState( i, good_output );
+  }
+
+  char report[ 48 ];
+  if( is_blacked_out ) {
+    snprintf( report, sizeof( report ), "Art-Net timed out, DMX blacked out" );
+  } else {
+    snprintf( report, sizeof( report ), "Receiving %u of %u universes", (unsigned)live_count, (unsigned)m_pending_frames.size() );
+  }
+  m_ArtNetPollResponder.SetNodeReport( ArtNetPollResponder::REPORT_POWER_OK, report );
+  // A DHCP lease can move the node.
+  if( m_node_info.is_dhcp ) {
+    m_ArtNetPollResponder.SetIPAddress( WiFi.localIP(), true );
+  }
+}
+
+void ESP32Artnet2DMX::PublishChangedPorts() {
+  if( m_changed_ports == 0 ) {
     return;
   }
 
-  if( m_artnet_source_ipaddress != m_artnet_source_ipaddress_any ) {
-    if( m_artnet_source_ipaddress != m_WiFiUDP.remoteIP() ) {
-      Serial.printf( "Packet ignored from unexpected source IP.\n" );
-      return;
+  // Routing is done, each frame goes out stamped with when its data arrived.
+  DMXFrameStamp stamp = DMXFrameStamp();
+  stamp.m_routed_us = micros();
+  for( int i = 0; m_changed_ports != 0; i++, m_changed_ports >>= 1 ) {
+    if( m_changed_ports & 1 ) {
+      stamp.m_is_stamped  = ( m_stamped_ports >> i ) & 1;
+      stamp.m_received_us = m_port_received_us[ i ];
+      m_dmx_ports[ i ].Publish( stamp );
     }
   }
+  m_stamped_ports = 0;
+}
 
-  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)&m_data_buffer[ 0 ];
+// Transmit side : starts the newest frame on every port that is due and not
+// still sending, without waiting for it.  Returns false when no port was started.
+bool ESP32Artnet2DMX::TransmitDMX() {
+  uint32_t start_us      = micros();
+  uint8_t  started_ports = this->SendDMX( m_forced_ports.exchange( 0 ), start_us );
+  m_NodeTelemetry.OnTransmit( started_ports, start_us, micros(), m_dmx_ports );
+  return started_ports != 0;
+}
 
-  String art_net = String( (char*)ptr_header->m_ID );
-  if( !art_net.equals( ARTNET_HEADER_ID ) ) {
-    Serial.printf( "Header ID failed = %i\n", packet_size_in_bytes );
+void ESP32Artnet2DMX::HandleWebServerData() {
+  if( m_ptr_WebServer != nullptr && m_ptr_WebServer->uri() == String( "/stats" ) ) {
+    this->HandleStatsRequest();
     return;
   }
+  if( m_ptr_WebServer != nullptr && m_ptr_WebServer->uri() == String( "/latency" ) ) {
+    this->HandleLatencyRequest( false );
+    return;
+  }
+  if( m_ptr_WebServer != nullptr && m_ptr_WebServer->uri() == String( "/reset_latency" ) ) {
+    this->HandleLatencyRequest( true );
+    return;
+  }
+  m_ConfigServer.HandleWebServerData();
+}
+
+// The telemetry the tasks last published, read without stopping them.
+void ESP32Artnet2DMX::HandleStatsRequest() {
+  uint8_t started_ports = 0;
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    started_ports |= m_dmx_ports[ i ].IsStarted() << i;
+  }
+
+  char json[ STATS_JSON_MAXSIZE ];
+  m_NodeTelemetry.FormatJSON( json, sizeof( json ), millis(), started_ports, ESP.getFreeHeap(), ESP.getMinFreeHeap() );
+  m_ptr_WebServer->send( 200, "application/json", json );
+}
+
+// The latency histograms so far, emptied after they are read when is_reset.
+void ESP32Artnet2DMX::HandleLatencyRequest( bool is_reset ) {
+  char json[ STATS_JSON_MAXSIZE ];
+  m_NodeTelemetry.FormatLatencyJSON( json, sizeof( json ) );
+  if( is_reset ) {
+    m_NodeTelemetry.ResetLatency();
+  }
+  m_ptr_WebServer->send( 200, "application/json", json );
+}
+
+bool ESP32Artnet2DMX::CheckForArtNetData() {
+  int packet_size_in_bytes = m_WiFiUDP.parsePacket();
+
+  if( packet_size_in_bytes == 0 ) {
+    return false;
+  }
+  uint32_t received_us = micros();
+  m_receive_stats.m_packets++;
+
+  // Read up to the end of the ArtDMX port-address first; the DMX data is only
+  // read for a subscribed universe.  parsePacket() discards anything left unread.
+  uint8_t* ptr_buffer         = m_ArtNetMerger.GetReceiveBuffer();
+  int      read_size_in_bytes = std::max( m_WiFiUDP.read( ptr_buffer, ArtNetParser::DMX_DATA_START ), 0 );
+
+  uint16_t opcode = 0;
+  ArtNetParser::Result result = ArtNetParser::ParseHeader( ptr_buffer, read_size_in_bytes, opcode );
+  if( result != ArtNetParser::PARSE_OK ) {
+    m_receive_stats.m_invalid_packets++;
+    if( result == ArtNetParser::PARSE_TOO_SHORT ) {
+      m_receive_stats.m_dropped_size++;
+    } else {
+      m_receive_stats.m_dropped_header++;
+    }
+    return true;
+  }
+
+  // ArtDMX and ArtSync from other sources are dropped before the rest of them
+  // is read.  Any controller may poll.
+  if( ( opcode == ARTNET_OPCODE_DMX || opcode == ARTNET_OPCODE_SYNC ) && m_artnet_source_ipaddress != m_artnet_source_ipaddress_any &&
+      m_artnet_source_ipaddress != m_WiFiUDP.remoteIP() ) {
+    m_receive_stats.m_rejected_packets++;
+    m_receive_stats.m_dropped_source_ip++;
+    return true;
+  }
 
-  switch( ptr_header->m_OpCode ) {
+  const ArtNetUniverseMap::Entry* ptr_entry = nullptr;
+  switch( opcode ) {
     case ARTNET_OPCODE_DMX: {
-      this->HandleArtNetDMX( (ArtNetPacketDMX*)&m_data_buffer[ ARTNET_PACKET_PAYLOAD_START ] );
+      // Art-Net is still arriving, even if it is for other universes.
+      if( m_artnet_timeout_ms != 0 ) {
+        m_is_artnet_timeout_armed = true;
+        m_artnet_timeout_next_ms  = millis() + m_artnet_timeout_ms;
+      }
+      uint16_t universe = 0;
+      if( ArtNetParser::PeekDMXUniverse( ptr_buffer, read_size_in_bytes, universe ) == ArtNetParser::PARSE_OK ) {
+        ptr_entry = m_ArtNetUniverseMap.Find( universe );
+        if( ptr_entry == nullptr ) {
+          m_receive_stats.m_rejected_packets++;
+          m_receive_stats.m_dropped_universe++;
+          return true;
+        }
+      }
+      break;
+    }
+    case ARTNET_OPCODE_POLL:
+    case ARTNET_OPCODE_POLLREPLY:
+    case ARTNET_OPCODE_SYNC: {
+      break;
+    }
+    default: {
+      m_receive_stats.m_rejected_packets++;
+      m_receive_stats.m_dropped_opcode++;
+      return true;
+    }
+  }
+
+  // Only what was actually read is parsed, longer datagrams are cut short.
+  if( read_size_in_bytes == ArtNetParser::DMX_DATA_START ) {
+    read_size_in_bytes += std::max( m_WiFiUDP.read( ptr_buffer + read_size_in_bytes, ARTNET_PACKET_MAXSIZE - read_size_in_bytes ), 0 );
+  }
+
+  switch( opcode ) {
+    case ARTNET_OPCODE_DMX: {
+      ArtNetDMXView dmx;
+      result = ArtNetParser::ParseDMX( ptr_buffer, read_size_in_bytes, dmx );
+      if( result != ArtNetParser::PARSE_OK ) {
+        m_receive_stats.m_invalid_packets++;
+        m_receive_stats.m_dropped_size++;
+        break;
+      }
+      uint8_t missed = 0;
+      ArtNetSequenceTracker::Result sequence = m_ArtNetSequenceTracker.Check( ptr_entry->m_index, m_WiFiUDP.remoteIP(), dmx.sequence, millis(), missed );
+      if( sequence == ArtNetSequenceTracker::SEQUENCE_STALE ) {
+        m_receive_stats.m_stale_frames++;
+        break;
+      }
+      if( sequence == ArtNetSequenceTracker::SEQUENCE_GAP ) {
+        m_receive_stats.m_sequence_gaps++;
+        m_receive_stats.m_missed_frames += missed;
+      }
+      m_receive_stats.m_accepted_packets++;
+      this->HandleArtNetDMX( *ptr_entry, dmx, m_WiFiUDP.remoteIP(), received_us );
       break;
     }
     case ARTNET_OPCODE_POLL: {
+      if( !m_ArtNetPollResponder.HandlePoll( ptr_buffer, read_size_in_bytes, m_WiFiUDP.remoteIP(), micros() ) ) {
+        m_receive_stats.m_invalid_packets++;
+        m_receive_stats.m_dropped_size++;
+        break;
+      }
+      m_receive_stats.m_accepted_packets++;
       break;
     }
-    case ARTNET_OPCODE_POLLREPLY: {
+    case ARTNET_OPCODE_SYNC: {
+      if( read_size_in_bytes < ARTNET_PACKET_MINSIZE_SYNC ) {
+        m_receive_stats.m_invalid_packets++;
+        m_receive_stats.m_dropped_size++;
+        break;
+      }
+      m_receive_stats.m_accepted_packets++;
+      this->HandleArtSync( m_WiFiUDP.remoteIP() );
       break;
     }
     default: {
-      Serial.printf( "Unhandled OpCode %i\n", ptr_header->m_OpCode );
+      m_receive_stats.m_accepted_packets++;
+      break;
+    }
+  }
+
+  return true;
+}
+
+bool ESP32Artnet2DMX::CheckForSACNData() {
+  int packet_size_in_bytes = m_sACNUDP.parsePacket();
+
+  if( packet_size_in_bytes == 0 ) {
+    return false;
+  }
+  uint32_t received_us = micros();
+  m_sacn_receive_stats.m_packets++;
+
+  // As for Art-Net, the DMX data is only read for a subscribed universe.
+  uint8_t* ptr_buffer         = m_ArtNetMerger.GetReceiveBuffer();
+  int      read_size_in_bytes = std::max( m_sACNUDP.read( ptr_buffer, E131Parser::DMX_DATA_START ), 0 );
+
+  uint16_t universe = 0;
+  E131Parser::Result result = E131Parser::PeekUniverse( ptr_buffer, read_size_in_bytes, universe );
+  if( result == E131Parser::PARSE_NOT_DATA ) {
+    m_sacn_receive_stats.m_rejected_packets++;
+    return true;
+  }
+  if( result != E131Parser::PARSE_OK ) {
+    m_sacn_receive_stats.m_invalid_packets++;
+    return true;
+  }
+  const ArtNetUniverseMap::Entry* ptr_entry = m_ArtNetUniverseMap.Find( universe );
+  if( ptr_entry == nullptr ) {
+    m_sacn_receive_stats.m_rejected_packets++;
+    return true;
+  }
+
+  if( read_size_in_bytes == E131Parser::DMX_DATA_START ) {
+    read_size_in_bytes += std::max( m_sACNUDP.read( ptr_buffer + read_size_in_bytes, E131_PACKET_MAXSIZE - read_size_in_bytes ), 0 );
+  }
+
+  E131DataView view;
+  result = E131Parser::Parse( ptr_buffer, read_size_in_bytes, view );
+  if( result != E131Parser::PARSE_OK ) {
+    m_sacn_receive_stats.m_invalid_packets++;
+    return true;
+  }
+  // Preview data is for visualisers, other START codes aren't levels.
+  if( view.start_code != 0 || ( view.options & E131_OPTION_PREVIEW ) ) {
+    m_sacn_receive_stats.m_rejected_packets++;
+    return true;
+  }
+
+  // sACN keeps the Art-Net timeout from blacking out, as Art-Net does.
+  if( m_artnet_timeout_ms != 0 ) {
+    m_is_artnet_timeout_armed = true;
+    m_artnet_timeout_next_ms  = millis() + m_artnet_timeout_ms;
+  }
+
+  uint32_t source_id = 0;
+  E131SourceTracker::Dropped dropped;
+  E131SourceTracker::Result source = m_E131SourceTracker.Check( ptr_entry->m_index, view, millis(), source_id, dropped );
+  for( uint8_t i = 0; i < dropped.m_count; i++ ) {
+    m_ArtNetMerger.RemoveSource( ptr_entry->m_index, dropped.m_ids[ i ] );
+  }
+  switch( source ) {
+    case E131SourceTracker::SOURCE_ACCEPTED: {
       break;
     }
+    case E131SourceTracker::SOURCE_STALE: {
+      m_sacn_receive_stats.m_stale_frames++;
+      return true;
+    }
+    case E131SourceTracker::SOURCE_OUTRANKED: {
+      m_sacn_receive_stats.m_outranked_frames++;
+      return true;
+    }
+    case E131SourceTracker::SOURCE_TERMINATED: {
+      m_sacn_receive_stats.m_terminated_packets++;
+      return true;
+    }
+    default: {
+      m_sacn_receive_stats.m_ignored_frames++;
+      return true;
+    }
   }
+
+  m_sacn_receive_stats.m_accepted_packets++;
+  ArtNetDMXView dmx;
+  dmx.universe = view.universe;
+  dmx.sequence = view.sequence;
+  dmx.physical = 0;
+  dmx.length   = view.length;
+  dmx.data     = view.data;
+  this->HandleArtNetDMX( *ptr_entry, dmx, source_id, received_us );
+  return true;
 }
 
-void ESP32Artnet2DMX::HandleArtNetDMX(ArtNetPacketDMX* ptr_packetdmx) {
-  uint16_t protocol = ptr_packetdmx->m_ProtocolLo | ptr_packetdmx->m_ProtocolHi << 8;
-  uint16_t universe_in = ptr_packetdmx->m_SubUni | ptr_packetdmx->m_Net << 8;
-  uint16_t number_of_channels = ptr_packetdmx->m_Length | ptr_packetdmx->m_LengthHi << 8;
+// Joins, or leaves, the multicast group of every subscribed sACN universe,
+// 239.255.hi.lo.  WiFiUDP only joins one group per socket, so the groups are
+// joined on the interface, which the socket bound to the port then hears.
+void ESP32Artnet2DMX::SetSACNGroups( bool is_member ) {
+  if( is_member ) {
+    m_sacn_groups.clear();
+    for( uint16_t universe : m_ArtNetUniverseMap.GetUniverses() ) {
+      if( universe >= E131_UNIVERSE_MIN && universe <= E131_UNIVERSE_MAX ) {
+        m_sacn_groups.push_back( IPAddress( 239, 255, universe >> 8, universe & 0xFF ) );
+      }
+    }
+  }
 
-  if (m_ConfigServer.m_artnet_timeout_ms != 0) {
-    m_artnet_timeout_next_ms = millis() + m_ConfigServer.m_artnet_timeout_ms;
+  ip4_addr_t interface_address = { IPADDR_ANY };
+  for( IPAddress group : m_sacn_groups ) {
+    ip4_addr_t group_address = { (uint32_t)group };
+#if LWIP_TCPIP_CORE_LOCKING
+    LOCK_TCPIP_CORE();
+#endif
+    err_t error = is_member ? igmp_joingroup( &interface_address, &group_address ) : igmp_leavegroup( &interface_address, &group_address );
+#if LWIP_TCPIP_CORE_LOCKING
+    UNLOCK_TCPIP_CORE();
+#endif
+    if( error != ERR_OK ) {
+      Serial.printf( "Failed to %s sACN multicast group %s\n", is_member ? "join" : "leave", group.toString().c_str() );
+    }
   }
 
-  if (universe_in != m_ConfigServer.m_artnet_universe) {
+  if( !is_member ) {
+    m_sacn_groups.clear();
+  }
+}
+
+void ESP32Artnet2DMX::HandleArtNetDMX( const ArtNetUniverseMap::Entry& entry, const ArtNetDMXView& dmx, uint32_t source_ip, uint32_t received_us ) {
+  // A jitter buffer wants every frame of a burst, so one still waiting goes
+  // out before Merge() reuses its buffer.  Not one staged for ArtSync.
+  if( m_is_jitter_buffered && !m_is_synchronous && m_pending_frames[ entry.m_index ].m_is_pending ) {
+    this->ApplyPendingFrames();
+    this->PublishChangedPorts();
+  }
+
+  const ArtNetDMXView* ptr_dmx = m_ArtNetMerger.Merge( entry.m_index, source_ip, millis(), dmx );
+  if( ptr_dmx == nullptr ) {
     return;
   }
 
-  // Copy incoming Art-Net data to the corresponding DMX channels
-  for (int i = 0; i < number_of_channels; i++) {
-    m_dmx_buffer[i + 1] = ptr_packetdmx->m_Data[i];
+  // Latest frame wins : an older one of the same universe still waiting is dropped.
+  PendingFrame& pending = m_pending_frames[ entry.m_index ];
+  if( pending.m_is_pending ) {
+    m_receive_stats.m_coalesced_frames++;
+  } else {
+    pending.m_is_pending = true;
+    m_pending_count++;
   }
+  pending.m_ptr_entry   = &entry;
+  pending.m_ptr_dmx     = ptr_dmx;
+  pending.m_received_us = received_us;
+}
 
-  // Apply routing configurations
-  for (const DMXRoutingConfig& config : m_ConfigServer.m_dmx_routing_configs) {
-    if (config.input_channel <= number_of_channels) {
-      uint8_t value = ptr_packetdmx->m_Data[config.input_channel - 1];
-      for (uint8_t output_channel : config.output_channels) {
-        if (output_channel > 0 && output_channel < 513) {
-          // Merge new value with existing value
-          if (m_dmx_buffer[output_channel] == 0) {
-            m_dmx_buffer[output_channel] = value;
-          } else {
-            m_dmx_buffer[output_channel] = std::max(m_dmx_buffer[output_channel], value);
-          }
+// A merging source that went silent drops out though no more packets come for
+// its universe, and the universe goes back to the other source's frame, staged
+// like a new one; a frame still waiting would be the stale merge.
+void ESP32Artnet2DMX::ExpireMergeSources() {
+  uint32_t now_ms = millis();
+  m_merge_expiry_next_ms = now_ms + ARTNET_MERGE_EXPIRY_INTERVAL_MS;
+  for( size_t i = 0; i < m_pending_frames.size(); i++ ) {
+    const ArtNetDMXView* ptr_dmx = m_ArtNetMerger.Expire( i, now_ms );
+    PendingFrame&        pending = m_pending_frames[ i ];
+    if( ptr_dmx == nullptr || pending.m_ptr_entry == nullptr ) {
+      continue;
+    }
+    if( !pending.m_is_pending ) {
+      pending.m_is_pending  = true;
+      pending.m_received_us = micros();
+      m_pending_count++;
+    }
+    pending.m_ptr_dmx = ptr_dmx;
+  }
+}
+
+// The frames staged since the last ArtSync go to the ports together, and the
+// ports start sending them at once rather than at their next refresh, so that
+// every node the controller synchronises changes at the same time.
+void ESP32Artnet2DMX::HandleArtSync( uint32_t source_ip ) {
+  // Sources merging can't be in step with each other's ArtSync, and only a
+  // source the node takes ArtDMX from may sync it.
+  uint32_t now_ms    = millis();
+  bool     is_source = false;
+  for( size_t i = 0; i < m_pending_frames.size(); i++ ) {
+    if( m_ArtNetMerger.GetSourceCount( i, now_ms ) > 1 ) {
+      m_receive_stats.m_sync_ignored++;
+      return;
+    }
+    is_source |= m_ArtNetMerger.IsSource( i, source_ip, now_ms );
+  }
+  if( !is_source ) {
+    m_receive_stats.m_sync_ignored++;
+    return;
+  }
+
+  m_is_synchronous      = true;
+  m_artnet_sync_last_ms = now_ms;
+  m_receive_stats.m_sync_commits++;
+
+  this->ApplyPendingFrames();
+  uint8_t committed_ports = m_changed_ports;
+  this->PublishChangedPorts();
+  m_forced_ports |= committed_ports;
+}
+
+void ESP32Artnet2DMX::ApplyPendingFrames() {
+  for( size_t i = 0; m_pending_count > 0 && i < m_pending_frames.size(); i++ ) {
+    PendingFrame& pending = m_pending_frames[ i ];
+    if( pending.m_is_pending ) {
+      uint8_t ports = this->ApplyArtNetDMX( *pending.m_ptr_entry, *pending.m_ptr_dmx );
+      // A port frame carrying several universes is as late as the oldest.
+      for( int port = 0; ports != 0; port++, ports >>= 1 ) {
+        bool is_older = !( ( m_stamped_ports >> port ) & 1 ) || (int32_t)( pending.m_received_us - m_port_received_us[ port ] ) < 0;
+        if( ( ports & 1 ) && is_older ) {
+          m_port_received_us[ port ] = pending.m_received_us;
+          m_stamped_ports |= 1 << port;
         }
       }
+      pending.m_is_pending = false;
+      m_pending_count--;
+      m_receive_stats.m_dmx_frames++;
+    }
+  }
+
+  // After every slice, so the routes merge onto whichever universe put a
+  // channel on port 1 and no slice copied later overwrites what they wrote.
+  if( ( m_changed_ports & 1 ) && m_DMXRouter.GetHighestOutputChannel() != 0 ) {
+    m_DMXRouter.Apply( m_routing_input, m_routing_input_length, m_routing_through, m_dmx_ports[ 0 ].GetBuffer() );
+  }
+}
+
+uint8_t ESP32Artnet2DMX::ApplyArtNetDMX( const ArtNetUniverseMap::Entry& entry, const ArtNetDMXView& dmx ) {
+  uint8_t ports          = 0;
+  bool    is_port_routed = m_DMXRouter.GetHighestOutputChannel() != 0;
+
+  // Copy the patched slices of the incoming Art-Net data to their DMX channels
+  const ArtNetUniverseSlice* ptr_slice = m_ArtNetUniverseMap.GetSlices() + entry.m_slice_first;
+  for( uint8_t i = 0; i < entry.m_slice_count; i++, ptr_slice++ ) {
+    if( ptr_slice->input_channel > dmx.length ) {
+      continue;
     }
+    uint16_t count = std::min<uint16_t>( ptr_slice->count, dmx.length - ( ptr_slice->input_channel - 1 ) );
+    DMXPort& dmx_port = m_dmx_ports[ ptr_slice->port ];
+    memcpy( &dmx_port.GetBuffer()[ ptr_slice->output_channel ], &dmx.data[ ptr_slice->input_channel - 1 ], count );
+    dmx_port.MarkUsed( ptr_slice->output_channel + count - 1 );
+    ports |= 1 << ptr_slice->port;
+    if( ptr_slice->port == 0 && is_port_routed ) {
+      memcpy( &m_routing_through[ ptr_slice->output_channel ], &dmx.data[ ptr_slice->input_channel - 1 ], count );
+    }
+  }
+
+  // Kept for the routes, which ApplyPendingFrames() runs last.
+  if( entry.m_is_routed ) {
+    if( is_port_routed ) {
+      memcpy( m_routing_input, dmx.data, dmx.length );
+      m_routing_input_length = dmx.length;
+    }
+    ports |= 1;
   }
+
+  m_changed_ports |= ports;
+  return ports;
 }
 
 
-void ESP32Artnet2DMX::SendDMX()
+uint8_t ESP32Artnet2DMX::SendDMX( uint8_t forced_ports, uint32_t now_us )
 {
-  dmx_write( DMX_NUM_1, m_dmx_buffer, DMX_PACKET_SIZE );
-  dmx_send_num( DMX_NUM_1, DMX_PACKET_SIZE );
-  dmx_wait_sent( DMX_NUM_1, DMX_TIMEOUT_TICK );
-  m_dmx_update_time_next_ms += m_ConfigServer.m_dmx_update_interval_ms;
+  uint8_t started_ports = 0;
+  uint8_t pending_ports = 0;
+
+  // Synchronous, refreshing at the update interval could have a port busy
+  // just as ArtSync commits, so the ports keep to the controller's pace.
+  bool is_synchronous = m_is_synchronous;
+
+  // Ports still busy with a frame are left alone, writing to them now would
+  // tear the frame on the wire.  The others all start together so the UARTs
+  // transmit side by side.
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    DMXPort& dmx_port = m_dmx_ports[ i ];
+    bool is_forced = ( forced_ports >> i ) & 1;
+    if( !dmx_port.IsStarted() ) {
+      continue;
+    }
+    if( dmx_port.IsSending() ) {
+      pending_ports |= is_forced << i;
+      continue;
+    }
+    bool is_due = is_synchronous ? dmx_port.IsIdleFor( now_us, DMX_SYNC_KEEPALIVE_US ) : dmx_port.IsFrameDue( now_us );
+    if( is_forced || is_due ) {
+      dmx_port.BeginFrame( now_us );
+      started_ports |= 1 << i;
+      const DMXFrameStamp& stamp = dmx_port.GetSentStamp();
+      if( stamp.m_is_stamped ) {
+        m_NodeTelemetry.OnFrameSent( stamp );
+      }
+    }
+  }
+
+  // A forced send waits for the ports that were busy.
+  if( pending_ports != 0 ) {
+    m_forced_ports |= pending_ports;
+  }
+
+  return started_ports;
 }
@@ -4,13 +4,24 @@
 //
 #include <iostream>
 #include <string>
+#include <atomic>
 //
 #include <WiFi.h>   // WiFi Ref. : https://www.arduino.cc/reference/en/libraries/wifi/
 #include <WebServer.h>
 #include <esp_dmx.h>
 //
 #include "ConfigServer.h"
+#include "DMXRouter.h"
+#include "DMXCurves.h"
+#include "ArtNetUniverseMap.h"
+#include "ArtNetSequenceTracker.h"
+#include "ArtNetMerger.h"
+#include "ArtNetPollResponder.h"
+#include "E131SourceTracker.h"
+#include "DMXPort.h"
+#include "ArtNetParser.h"
 #include "ArtNet_Spec.h"
+#include "NodeTelemetry.h"
 
 class ESP32Artnet2DMX {
 public:
@@ -28,28 +39,146 @@ public:
 
   void Stop();
 
+  // With tasks (the default) Start() runs Art-Net receive and DMX transmit in
+  // their own FreeRTOS tasks, one per core, and Update() only serves the web
+  // pages.  Without, Update() runs both in turn.  Set before Start().
+  void SetUseTasks( bool use_tasks );
+
+  DMXPort& GetDMXPort( int port_index );
+
+  const ArtNetReceiveStats& GetReceiveStats() const;
+
+  const SACNReceiveStats& GetSACNReceiveStats() const;
+
+  const ArtNetMerger::Stats& GetMergeStats() const;
+
+  const ArtNetPollResponder& GetPollResponder() const;
+
+  const NodeTelemetry& GetTelemetry() const;
+
   void HandleWebServerData();
 
 private:  
-  void SendDMX();
+  static void ReceiveTask( void* ptr_parameter );
+
+  static void TransmitTask( void* ptr_parameter );
+
+  bool ReceiveArtNet();
+
+  bool TransmitDMX();
+
+  // Returns the ports that started a frame.
+  uint8_t SendDMX( uint8_t forced_ports, uint32_t now_us );
+
+  bool CheckForArtNetData();
+
+  bool CheckForSACNData();
+
+  void SetSACNGroups( bool is_member );
+
+  void HandleArtNetDMX( const ArtNetUniverseMap::Entry& entry, const ArtNetDMXView& dmx, uint32_t source_ip, uint32_t received_us );
+
+  void HandleArtSync( uint32_t source_ip );
+
+  void ExpireMergeSources();
+
+  void ApplyPendingFrames();
+
+  void PublishChangedPorts();
+
+  // Returns the ports it wrote to.
+  uint8_t ApplyArtNetDMX( const ArtNetUniverseMap::Entry& entry, const ArtNetDMXView& dmx );
 
-  void CheckForArtNetData();
+  void UpdatePollReply();
 
-  void HandleArtNetDMX( ArtNetPacketDMX* ptr_packetdmx );
+  void HandleStatsRequest();
+
+  void HandleLatencyRequest( bool is_reset );
 
   bool          m_is_started;
-  
+
+  bool          m_use_tasks;
+
+  std::atomic<bool> m_is_tasks_running;
+  std::atomic<int>  m_task_count;
+
+  // Ports the receive side wants sent at once rather than when due, e.g. the blackout on timeout.
+  std::atomic<uint8_t> m_forced_ports;
+
+  // Ports whose frame changed since the last Publish().
+  uint8_t       m_changed_ports;
+
+  // Of those, the ports with received data in their frame, and when the
+  // oldest of it was read, for the frame's DMXFrameStamp.
+  uint8_t       m_stamped_ports;
+  uint32_t      m_port_received_us[ DMX_PORT_MAX ];
+
+  // The ports queue every frame, a universe's frames aren't coalesced.
+  bool          m_is_jitter_buffered;
+
+  // Once ArtSync has been seen frames are staged until the next one, until
+  // none has come for m_artnet_sync_timeout_ms.  The ports then only send
+  // what ArtSync commits, and a keep-alive.
+  std::atomic<bool> m_is_synchronous;
+  unsigned long m_artnet_sync_timeout_ms;
+  unsigned long m_artnet_sync_last_ms;
+
+  unsigned long m_merge_expiry_next_ms;
+
+  unsigned long m_artnet_timeout_ms;
   unsigned long m_artnet_timeout_next_ms;
+  bool          m_is_artnet_timeout_armed;
 
-  unsigned long m_dmx_update_time_next_ms;
+  // The newest ArtDMX frame of each subscribed universe, by Entry::m_index,
+  // waiting for the receive queue to be drained, or for ArtSync, before it is applied.
+  struct PendingFrame {
+    const ArtNetUniverseMap::Entry* m_ptr_entry;
+    const ArtNetDMXView*            m_ptr_dmx;    // Held by m_ArtNetMerger.
+    bool                            m_is_pending;
+    uint32_t                        m_received_us;
+  };
 
-  uint8_t       m_data_buffer[ ARTNET_PACKET_MAXSIZE ];
+  std::vector<PendingFrame> m_pending_frames;
+  size_t                    m_pending_count;
 
-  uint8_t       m_dmx_buffer[ 513 ];
+  // Port 1 as the universe slices assembled it, which the routes start from,
+  // and the last frame of the routed universe, which they read.  The routes
+  // run over port 1 once every slice of a drain is on it.
+  uint8_t                   m_routing_through[ DMX_PACKET_SIZE ];
+  uint8_t                   m_routing_input[ DMX_PACKET_SIZE - 1 ];
+  uint16_t                  m_routing_input_length;
+
+  ArtNetReceiveStats        m_receive_stats;
+
+  DMXPort       m_dmx_ports[ DMX_PORT_MAX ];
 
   WiFiUDP       m_WiFiUDP;
 
+  // sACN is read from its own socket into the same merge stage.  Every
+  // subscribed universe's multicast group is joined on the interface.
+  bool          m_is_sacn_enabled;
+  WiFiUDP       m_sACNUDP;
+  std::vector<IPAddress> m_sacn_groups;
+  E131SourceTracker m_E131SourceTracker;
+  SACNReceiveStats  m_sacn_receive_stats;
+
   ConfigServer  m_ConfigServer;
+  WebServer*    m_ptr_WebServer;
+
+  // Published by the tasks for /stats.
+  NodeTelemetry m_NodeTelemetry;
+
+  DMXRouter     m_DMXRouter;
+  DMXCurves     m_DMXCurves;
+
+  ArtNetUniverseMap m_ArtNetUniverseMap;
+
+  ArtNetSequenceTracker m_ArtNetSequenceTracker;
+
+  ArtNetMerger  m_ArtNetMerger;
+
+  ArtNetPollResponder m_ArtNetPollResponder;
+  ArtNetPollResponder::NodeInfo m_node_info;
 
   IPAddress     m_artnet_source_ipaddress;
   IPAddress     m_artnet_source_ipaddress_any;
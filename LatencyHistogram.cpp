@@ -0,0 +1,65 @@
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram() {
+  m_is_reset_requested = false;
+  this->Reset();
+}
+
+void LatencyHistogram::Reset() {
+  for( std::atomic<uint32_t>& bucket : m_buckets ) {
+    bucket.store( 0, std::memory_order_relaxed );
+  }
+  m_max_us.store( 0, std::memory_order_relaxed );
+  m_is_reset_requested.store( false, std::memory_order_release );
+}
+
+void LatencyHistogram::RequestReset() {
+  m_is_reset_requested.store( true, std::memory_order_release );
+}
+
+uint32_t LatencyHistogram::GetBucketUpperBound( uint16_t bucket ) {
+  if( bucket < ( 1u << SUB_BUCKET_BITS ) ) {
+    return bucket;
+  }
+  uint8_t  shift = bucket / ( 1u << SUB_BUCKET_BITS ) - 1;
+  uint32_t lower = ( ( 1u << SUB_BUCKET_BITS ) + bucket % ( 1u << SUB_BUCKET_BITS ) ) << shift;
+  return lower + ( 1u << shift ) - 1;
+}
+
+LatencyHistogram::Summary LatencyHistogram::GetSummary() const {
+  Summary summary = {};
+  if( m_is_reset_requested.load( std::memory_order_acquire ) ) {
+    return summary;
+  }
+
+  uint32_t counts[ BUCKETS ];
+  for( uint16_t i = 0; i < BUCKETS; i++ ) {
+    counts[ i ] = m_buckets[ i ].load( std::memory_order_relaxed );
+    summary.m_count += counts[ i ];
+  }
+  summary.m_max_us = m_max_us.load( std::memory_order_relaxed );
+  if( summary.m_count == 0 ) {
+    return summary;
+  }
+
+  // The smallest duration at least pct percent of the counts are at or under.
+  struct Percentile {
+    uint32_t  m_pct;
+    uint32_t* m_ptr_us;
+  };
+  const Percentile percentiles[] = {
+    { 50, &summary.m_p50_us },
+    { 95, &summary.m_p95_us },
+    { 99, &summary.m_p99_us },
+  };
+  uint32_t cumulative = 0;
+  uint16_t bucket     = 0;
+  for( const Percentile& percentile : percentiles ) {
+    uint32_t rank = (uint32_t)( ( (uint64_t)summary.m_count * percentile.m_pct + 99 ) / 100 );
+    while( bucket < BUCKETS - 1 && cumulative + counts[ bucket ] < rank ) {
+      cumulative += counts[ bucket++ ];
+    }
+    *percentile.m_ptr_us = std::min( GetBucketUpperBound( bucket ), summary.m_max_us );
+  }
+  return summary;
+}
@@ -0,0 +1,75 @@
+#ifndef _LATENCYHISTOGRAM_H_
+#define _LATENCYHISTOGRAM_H_
+
+#include <Arduino.h>
+#include <atomic>
+
+// Counts of durations in fixed buckets, for percentiles that can be read while
+// they are being recorded.
+//
+// Durations up to 7 us each have their own bucket; above that every power of
+// two is split into 8 buckets, so a bucket is never more than 12.5% wide.
+// Durations past MAX_US all go in the last bucket.  A percentile is the upper
+// bound of the bucket it falls in, never more than the exact max.
+//
+// One task records, any other reads.  Each bucket is a relaxed atomic the
+// recording task alone writes, so recording is a bucket index from the
+// leading zeros, a load and a store.  A reset asked for by a reader is done
+// by the recording task on its next Record(); until then readers see it as
+// empty.
+class LatencyHistogram {
+public:
+  static const uint8_t  SUB_BUCKET_BITS = 3;
+  static const uint16_t BUCKETS         = 160;
+  static const uint32_t MAX_US          = ( 1u << 22 ) - 1;   // 4.2 s
+
+  struct Summary {
+    uint32_t m_count;
+    uint32_t m_p50_us;
+    uint32_t m_p95_us;
+    uint32_t m_p99_us;
+    uint32_t m_max_us;
+  };
+
+  LatencyHistogram();
+
+  // Empties it.  Nothing may be recording.
+  void Reset();
+
+  void Record( uint32_t duration_us ) {
+    if( m_is_reset_requested.load( std::memory_order_acquire ) ) {
+      this->Reset();
+    }
+    std::atomic<uint32_t>& bucket = m_buckets[ GetBucket( duration_us ) ];
+    bucket.store( bucket.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    if( duration_us > m_max_us.load( std::memory_order_relaxed ) ) {
+      m_max_us.store( duration_us, std::memory_order_relaxed );
+    }
+  }
+
+  // Any task, the recording task empties it on its next Record().
+  void RequestReset();
+
+  Summary GetSummary() const;
+
+  static uint16_t GetBucket( uint32_t duration_us ) {
+    if( duration_us < ( 1u << SUB_BUCKET_BITS ) ) {
+      return duration_us;
+    }
+    if( duration_us > MAX_US ) {
+      duration_us = MAX_US;
+    }
+    uint8_t msb = 31 - __builtin_clz( duration_us );
+    return ( msb - SUB_BUCKET_BITS + 1 ) * ( 1u << SUB_BUCKET_BITS ) + ( ( duration_us >> ( msb - SUB_BUCKET_BITS ) ) & ( ( 1u << SUB_BUCKET_BITS ) - 1 ) );
+  }
+
+  // The longest duration that goes in bucket.
+  static uint32_t GetBucketUpperBound( uint16_t bucket );
+
+private:
+  std::atomic<uint32_t> m_buckets[ BUCKETS ];
+  std::atomic<uint32_t> m_max_us;
+  std::atomic<bool>     m_is_reset_requested;
+};
+
+#endif
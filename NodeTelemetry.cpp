@@ -0,0 +1,263 @@
+#include "NodeTelemetry.h"
+
+#include <stdarg.h>
+
+#include "DMXFrameScheduler.h"
+
+// Appends to the JSON being written, as far as it fits.
+static void Append( char* buffer, size_t size, size_t& length, const char* format, ... ) {
+  if( length + 1 >= size ) {
+    return;
+  }
+  va_list arguments;
+  va_start( arguments, format );
+  int written = vsnprintf( buffer + length, size - length, format, arguments );
+  va_end( arguments );
+  if( written > 0 ) {
+    length = std::min( length + (size_t)written, size - 1 );
+  }
+}
+
+static void AppendLoop( char* buffer, size_t size, size_t& length, const char* name, const LoopStats& loop ) {
+  Append( buffer, size, length, ",\"%s\":{\"min\":%u,\"avg\":%u,\"max\":%u,\"n\":%u}",
+          name, (unsigned)loop.m_min_us, (unsigned)loop.m_avg_us, (unsigned)loop.m_max_us, (unsigned)loop.m_iterations );
+}
+
+static void AppendSince( char* buffer, size_t size, size_t& length, bool is_heard, uint32_t now_ms, uint32_t last_ms ) {
+  if( is_heard ) {
+    Append( buffer, size, length, ",\"since_ms\":%u}", (unsigned)( now_ms - last_ms ) );
+  } else {
+    Append( buffer, size, length, ",\"since_ms\":null}" );
+  }
+}
+
+void NodeTelemetry::LoopTimer::Reset() {
+  m_iterations = 0;
+  m_min_us     = UINT32_MAX;
+  m_max_us     = 0;
+  m_sum_us     = 0;
+}
+
+LoopStats NodeTelemetry::LoopTimer::Get() const {
+  LoopStats stats;
+  stats.m_iterations = m_iterations;
+  stats.m_min_us     = m_iterations ? m_min_us : 0;
+  stats.m_avg_us     = m_iterations ? (uint32_t)( m_sum_us / m_iterations ) : 0;
+  stats.m_max_us     = m_max_us;
+  return stats;
+}
+
+NodeTelemetry::NodeTelemetry() {
+  this->Reset( 0 );
+}
+
+void NodeTelemetry::Reset( uint32_t now_us ) {
+  m_receive_timer.Reset();
+  m_receive = ReceiveTelemetry();
+  m_receive_published_us = now_us;
+
+  m_transmit_timer.Reset();
+  m_transmit = TransmitTelemetry();
+  m_transmit_published_us = now_us;
+  m_window_start_us = now_us;
+  memset( m_window_frames, 0, sizeof( m_window_frames ) );
+  memset( m_window_first_us, 0, sizeof( m_window_first_us ) );
+  memset( m_window_last_us, 0, sizeof( m_window_last_us ) );
+
+  m_published_receive.Publish( m_receive );
+  m_published_transmit.Publish( m_transmit );
+
+  for( LatencyHistogram& latency : m_latency ) {
+    latency.Reset();
+  }
+}
+
+void NodeTelemetry::OnReceive( const ArtNetReceiveStats& artnet, const SACNReceiveStats& sacn, uint32_t start_us, uint32_t end_us, uint32_t now_ms ) {
+  m_receive_timer.Record( end_us - start_us );
+
+  // Whatever was accepted since the last iteration arrived during this one.
+  if( artnet.m_accepted_packets != m_receive.m_artnet.m_accepted_packets ) {
+    m_receive.m_artnet.m_accepted_packets = artnet.m_accepted_packets;
+    m_receive.m_artnet_last_ms = now_ms;
+    m_receive.m_heard |= HEARD_ARTNET;
+  }
+  if( sacn.m_accepted_packets != m_receive.m_sacn.m_accepted_packets ) {
+    m_receive.m_sacn.m_accepted_packets = sacn.m_accepted_packets;
+    m_receive.m_sacn_last_ms = now_ms;
+    m_receive.m_heard |= HEARD_SACN;
+  }
+
+  if( !DMXFrameScheduler::HasReached( end_us, m_receive_published_us + PUBLISH_INTERVAL_US ) ) {
+    return;
+  }
+  m_receive_published_us = end_us;
+  m_receive.m_artnet = artnet;
+  m_receive.m_sacn   = sacn;
+  m_receive.m_loop   = m_receive_timer.Get();
+  m_published_receive.Publish( m_receive );
+}
+
+void NodeTelemetry::OnTransmit( uint8_t started_ports, uint32_t start_us, uint32_t end_us, const DMXPort* ptr_dmx_ports ) {
+  m_transmit_timer.Record( end_us - start_us );
+
+  for( int i = 0; started_ports != 0; i++, started_ports >>= 1 ) {
+    if( started_ports & 1 ) {
+      m_transmit.m_frames[ i ]++;
+      if( m_window_frames[ i ]++ == 0 ) {
+        m_window_first_us[ i ] = start_us;
+      }
+      m_window_last_us[ i ] = start_us;
+    }
+  }
+
+  // Counting frames over a window would be a whole frame out either way, the
+  // spacing of the first and last gives the rate to a fraction of a Hz.
+  uint32_t window_us = end_us - m_window_start_us;
+  if( window_us >= RATE_WINDOW_US ) {
+    for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+      uint32_t span_us = m_window_last_us[ i ] - m_window_first_us[ i ];
+      if( m_window_frames[ i ] >= 2 && span_us != 0 ) {
+        m_transmit.m_refresh_mhz[ i ] = (uint32_t)( (uint64_t)( m_window_frames[ i ] - 1 ) * 1000000000ull / span_us );
+      } else {
+        m_transmit.m_refresh_mhz[ i ] = (uint32_t)( (uint64_t)m_window_frames[ i ] * 1000000000ull / window_us );
+      }
+      m_window_frames[ i ] = 0;
+    }
+    m_window_start_us = end_us;
+  }
+
+  if( !DMXFrameScheduler::HasReached( end_us, m_transmit_published_us + PUBLISH_INTERVAL_US ) ) {
+    return;
+  }
+  m_transmit_published_us = end_us;
+  m_transmit.m_loop = m_transmit_timer.Get();
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    const DMXFrameScheduler&        scheduler = ptr_dmx_ports[ i ].GetScheduler();
+    const DMXFrameScheduler::Stats& stats     = scheduler.GetStats();
+    uint32_t      intervals = stats.m_frames > 1 ? stats.m_frames - 1 : 0;
+    RefreshStats& refresh   = m_transmit.m_refresh[ i ];
+    refresh.m_interval_us     = scheduler.GetIntervalMicros();
+    refresh.m_interval_min_us = intervals ? stats.m_interval_min_us : 0;
+    refresh.m_interval_max_us = stats.m_interval_max_us;
+    refresh.m_jitter_avg_us   = intervals ? (uint32_t)( stats.m_jitter_sum_us / intervals ) : 0;
+    refresh.m_jitter_max_us   = stats.m_jitter_max_us;
+    refresh.m_late            = stats.m_late;
+
+    const DMXJitterBuffer&        jitter_buffer = ptr_dmx_ports[ i ].GetJitterBuffer();
+    const DMXJitterBuffer::Stats& buffer_stats  = jitter_buffer.GetStats();
+    JitterBufferStats& buffer = m_transmit.m_jitter_buffer[ i ];
+    buffer.m_delay_us    = jitter_buffer.GetDelayMicros();
+    buffer.m_frames      = buffer_stats.m_frames;
+    buffer.m_played      = buffer_stats.m_played;
+    buffer.m_underruns   = buffer_stats.m_underruns;
+    buffer.m_overruns    = buffer_stats.m_overruns;
+    buffer.m_skipped     = buffer_stats.m_skipped;
+    buffer.m_depth_max   = buffer_stats.m_depth_max;
+    buffer.m_wait_avg_us = buffer_stats.m_played ? (uint32_t)( buffer_stats.m_wait_sum_us / buffer_stats.m_played ) : 0;
+    buffer.m_wait_max_us = buffer_stats.m_wait_max_us;
+    buffer.m_cadence_us  = buffer_stats.m_cadence_us;
+  }
+  m_published_transmit.Publish( m_transmit );
+}
+
+const LatencyHistogram& NodeTelemetry::GetLatency( Latency latency ) const {
+  return m_latency[ latency ];
+}
+
+void NodeTelemetry::ResetLatency() {
+  for( LatencyHistogram& latency : m_latency ) {
+    latency.RequestReset();
+  }
+}
+
+ReceiveTelemetry NodeTelemetry::GetReceive() const {
+  return m_published_receive.Read();
+}
+
+TransmitTelemetry NodeTelemetry::GetTransmit() const {
+  return m_published_transmit.Read();
+}
+
+size_t NodeTelemetry::FormatJSON( char* buffer, size_t size, uint32_t now_ms, uint8_t started_ports, uint32_t free_heap, uint32_t min_free_heap ) const {
+  if( size == 0 ) {
+    return 0;
+  }
+  buffer[ 0 ] = '\0';
+
+  ReceiveTelemetry  receive  = this->GetReceive();
+  TransmitTelemetry transmit = this->GetTransmit();
+  const ArtNetReceiveStats& artnet = receive.m_artnet;
+  const SACNReceiveStats&   sacn   = receive.m_sacn;
+
+  size_t length = 0;
+  Append( buffer, size, length, "{\"uptime_ms\":%u,\"heap\":{\"free\":%u,\"min_free\":%u}",
+          (unsigned)now_ms, (unsigned)free_heap, (unsigned)min_free_heap );
+
+  Append( buffer, size, length, ",\"artnet\":{\"packets\":%u,\"accepted\":%u,\"dropped\":{\"size\":%u,\"header\":%u,\"source_ip\":%u,\"universe\":%u,\"opcode\":%u}",
+          (unsigned)artnet.m_packets, (unsigned)artnet.m_accepted_packets, (unsigned)artnet.m_dropped_size,
+          (unsigned)artnet.m_dropped_header, (unsigned)artnet.m_dropped_source_ip, (unsigned)artnet.m_dropped_universe,
+          (unsigned)artnet.m_dropped_opcode );
+  Append( buffer, size, length, ",\"stale\":%u,\"gaps\":%u,\"missed\":%u,\"coalesced\":%u,\"dmx_frames\":%u,\"budget_exceeded\":%u",
+          (unsigned)artnet.m_stale_frames, (unsigned)artnet.m_sequence_gaps, (unsigned)artnet.m_missed_frames,
+          (unsigned)artnet.m_coalesced_frames, (unsigned)artnet.m_dmx_frames, (unsigned)artnet.m_budget_exceeded );
+  Append( buffer, size, length, ",\"sync\":{\"commits\":%u,\"ignored\":%u,\"timeouts\":%u}",
+          (unsigned)artnet.m_sync_commits, (unsigned)artnet.m_sync_ignored, (unsigned)artnet.m_sync_timeouts );
+  AppendSince( buffer, size, length, receive.m_heard & HEARD_ARTNET, now_ms, receive.m_artnet_last_ms );
+
+  Append( buffer, size, length, ",\"sacn\":{\"packets\":%u,\"accepted\":%u,\"rejected\":%u,\"invalid\":%u,\"stale\":%u,\"outranked\":%u,\"terminated\":%u,\"ignored\":%u",
+          (unsigned)sacn.m_packets, (unsigned)sacn.m_accepted_packets, (unsigned)sacn.m_rejected_packets, (unsigned)sacn.m_invalid_packets,
+          (unsigned)sacn.m_stale_frames, (unsigned)sacn.m_outranked_frames, (unsigned)sacn.m_terminated_packets,
+          (unsigned)sacn.m_ignored_frames );
+  AppendSince( buffer, size, length, receive.m_heard & HEARD_SACN, now_ms, receive.m_sacn_last_ms );
+
+  AppendLoop( buffer, size, length, "receive_loop_us", receive.m_loop );
+  AppendLoop( buffer, size, length, "transmit_loop_us", transmit.m_loop );
+
+  Append( buffer, size, length, ",\"dmx\":[" );
+  const char* separator = "";
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    if( ( started_ports >> i ) & 1 ) {
+      uint32_t            mhz     = transmit.m_refresh_mhz[ i ];
+      const RefreshStats& refresh = transmit.m_refresh[ i ];
+      Append( buffer, size, length, "%s{\"port\":%d,\"frames\":%u,\"refresh_hz\":%u.%02u",
+              separator, i + 1, (unsigned)( transmit.m_frames[ i ] ), (unsigned)( mhz / 1000 ), (unsigned)( ( mhz % 1000 ) / 10 ) );
+      Append( buffer, size, length, ",\"interval_us\":{\"nominal\":%u,\"min\":%u,\"max\":%u},\"jitter_us\":{\"avg\":%u,\"max\":%u},\"late\":%u",
+              (unsigned)refresh.m_interval_us, (unsigned)refresh.m_interval_min_us, (unsigned)refresh.m_interval_max_us,
+              (unsigned)refresh.m_jitter_avg_us, (unsigned)refresh.m_jitter_max_us, (unsigned)refresh.m_late );
+      const JitterBufferStats& jitter_buffer = transmit.m_jitter_buffer[ i ];
+      if( jitter_buffer.m_delay_us != 0 ) {
+        Append( buffer, size, length, ",\"jitter_buffer\":{\"delay_us\":%u,\"frames\":%u,\"played\":%u,\"underruns\":%u,\"overruns\":%u,\"skipped\":%u",
+                (unsigned)jitter_buffer.m_delay_us, (unsigned)jitter_buffer.m_frames, (unsigned)jitter_buffer.m_played,
+                (unsigned)jitter_buffer.m_underruns, (unsigned)jitter_buffer.m_overruns, (unsigned)jitter_buffer.m_skipped );
+        Append( buffer, size, length, ",\"depth_max\":%u,\"wait_us\":{\"avg\":%u,\"max\":%u},\"cadence_us\":%u}}",
+                (unsigned)jitter_buffer.m_depth_max, (unsigned)jitter_buffer.m_wait_avg_us, (unsigned)jitter_buffer.m_wait_max_us,
+                (unsigned)jitter_buffer.m_cadence_us );
+      } else {
+        Append( buffer, size, length, ",\"jitter_buffer\":null}" );
+      }
+      separator = ",";
+    }
+  }
+  Append( buffer, size, length, "]}" );
+
+  return length;
+}
+
+size_t NodeTelemetry::FormatLatencyJSON( char* buffer, size_t size ) const {
+  if( size == 0 ) {
+    return 0;
+  }
+  buffer[ 0 ] = '\0';
+
+  static const char* const names[ LATENCY_MAX ] = { "parse_to_route_us", "route_to_send_us", "parse_to_send_us" };
+  size_t length = 0;
+  for( uint8_t i = 0; i < LATENCY_MAX; i++ ) {
+    LatencyHistogram::Summary summary = m_latency[ i ].GetSummary();
+    Append( buffer, size, length, "%s\"%s\":{\"n\":%u,\"p50\":%u,\"p95\":%u,\"p99\":%u,\"max\":%u}",
+            i == 0 ? "{" : ",", names[ i ], (unsigned)summary.m_count, (unsigned)summary.m_p50_us, (unsigned)summary.m_p95_us,
+            (unsigned)summary.m_p99_us, (unsigned)summary.m_max_us );
+  }
+  Append( buffer, size, length, "}" );
+
+  return length;
+}
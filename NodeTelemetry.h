@@ -0,0 +1,236 @@
+#ifndef _NODETELEMETRY_H_
+#define _NODETELEMETRY_H_
+
+#include <Arduino.h>
+#include <atomic>
+#include <algorithm>
+
+#include "DMXPort.h"
+#include "LatencyHistogram.h"
+
+// Counts kept by the Art-Net receive side since Start().
+struct ArtNetReceiveStats {
+  uint32_t m_packets;             // Datagrams received.
+  uint32_t m_accepted_packets;    // Read in full and passed on.
+  uint32_t m_rejected_packets;    // Dropped from the header alone : other source, unsubscribed universe or unhandled OpCode.
+  uint32_t m_invalid_packets;     // Malformed.
+  uint32_t m_dropped_size;        // Of the invalid : too short, or a DMX length over what was received,
+  uint32_t m_dropped_header;      // or not starting with "Art-Net\0".
+  uint32_t m_dropped_source_ip;   // Of the rejected : from other than the Art-Net source IP,
+  uint32_t m_dropped_universe;    // for a universe not subscribed,
+  uint32_t m_dropped_opcode;      // or an OpCode the node doesn't handle.
+  uint32_t m_stale_frames;        // ArtDMX dropped for arriving after a newer frame from the same source.
+  uint32_t m_sequence_gaps;       // ArtDMX arriving with frames before it missing,
+  uint32_t m_missed_frames;       // and how many were missing, lost or still to come out of order.
+  uint32_t m_dmx_frames;          // ArtDMX frames applied to the DMX ports.
+  uint32_t m_coalesced_frames;    // ArtDMX frames dropped for a newer one of the same universe read in the same drain.
+  uint32_t m_budget_exceeded;     // Drains cut short by ARTNET_RECEIVE_BUDGET_US with packets possibly still queued.
+  uint32_t m_sync_commits;        // ArtSync that sent the frames staged before it.
+  uint32_t m_sync_ignored;        // ArtSync while merging, which Art-Net has nodes ignore, or from no source of ArtDMX.
+  uint32_t m_sync_timeouts;       // Falls back to sending frames as they arrive, for want of ArtSync.
+};
+
+// Counts kept by the sACN (E1.31) receive side since Start(), when it is enabled.
+struct SACNReceiveStats {
+  uint32_t m_packets;             // Datagrams received.
+  uint32_t m_accepted_packets;    // Data packets passed on to the merge stage.
+  uint32_t m_rejected_packets;    // Unsubscribed universe, preview data, other START codes, sync and discovery.
+  uint32_t m_invalid_packets;     // Malformed.
+  uint32_t m_stale_frames;        // Out of sequence.
+  uint32_t m_outranked_frames;    // From a source below the universe's highest priority.
+  uint32_t m_terminated_packets;  // Stream terminated, which a source sends three times as it stops.
+  uint32_t m_ignored_frames;      // From sources beyond E131SourceTracker::SOURCES_PER_UNIVERSE.
+};
+
+// Duration of the iterations of one of the node's loops since Start().
+struct LoopStats {
+  uint32_t m_iterations;
+  uint32_t m_min_us;
+  uint32_t m_avg_us;
+  uint32_t m_max_us;
+};
+
+// What the receive side publishes.
+struct ReceiveTelemetry {
+  ArtNetReceiveStats m_artnet;
+  SACNReceiveStats   m_sacn;
+  LoopStats          m_loop;
+  uint32_t           m_artnet_last_ms;  // millis() of the last Art-Net packet accepted,
+  uint32_t           m_sacn_last_ms;    // and sACN packet,
+  uint32_t           m_heard;           // HEARD_ bits, whether there was one at all.
+};
+
+// Refresh timing of a port since its interval was last set, from DMXFrameScheduler::Stats.
+struct RefreshStats {
+  uint32_t m_interval_us;       // Nominal.
+  uint32_t m_interval_min_us;
+  uint32_t m_interval_max_us;
+  uint32_t m_jitter_avg_us;
+  uint32_t m_jitter_max_us;
+  uint32_t m_late;
+};
+
+// A port's jitter buffer since it was configured, from DMXJitterBuffer::Stats.
+struct JitterBufferStats {
+  uint32_t m_delay_us;          // 0 with the buffer off.
+  uint32_t m_frames;
+  uint32_t m_played;
+  uint32_t m_underruns;
+  uint32_t m_overruns;
+  uint32_t m_skipped;
+  uint32_t m_depth_max;
+  uint32_t m_wait_avg_us;
+  uint32_t m_wait_max_us;
+  uint32_t m_cadence_us;
+};
+
+// What the transmit side publishes.
+struct TransmitTelemetry {
+  uint32_t          m_frames[ DMX_PORT_MAX ];       // DMX frames started.
+  uint32_t          m_refresh_mhz[ DMX_PORT_MAX ];  // Frames per second over the last RATE_WINDOW_US, in mHz, from the frames' spacing.
+  RefreshStats      m_refresh[ DMX_PORT_MAX ];
+  JitterBufferStats m_jitter_buffer[ DMX_PORT_MAX ];
+  LoopStats         m_loop;
+};
+
+// Copies of a struct of uint32_t fields that one task publishes and any task
+// reads.  Each field is a relaxed atomic, on the ESP32 a plain 32 bit load or
+// store, so neither side locks or waits and no field is ever torn; fields
+// may come from two publishes.
+template <typename Stats>
+class TelemetrySnapshot {
+public:
+  static_assert( sizeof( Stats ) % sizeof( uint32_t ) == 0, "Telemetry is published as 32 bit words" );
+
+  TelemetrySnapshot() {
+    this->Publish( Stats() );
+  }
+
+  void Publish( const Stats& stats ) {
+    uint32_t words[ WORDS ];
+    memcpy( words, &stats, sizeof( stats ) );
+    for( size_t i = 0; i < WORDS; i++ ) {
+      m_words[ i ].store( words[ i ], std::memory_order_relaxed );
+    }
+  }
+
+  Stats Read() const {
+    uint32_t words[ WORDS ];
+    for( size_t i = 0; i < WORDS; i++ ) {
+      words[ i ] = m_words[ i ].load( std::memory_order_relaxed );
+    }
+    Stats stats;
+    memcpy( &stats, words, sizeof( stats ) );
+    return stats;
+  }
+
+private:
+  static const size_t WORDS = sizeof( Stats ) / sizeof( uint32_t );
+
+  std::atomic<uint32_t> m_words[ WORDS ];
+};
+
+// Telemetry of the running node for the web server's /stats and /latency,
+// read while the tasks keep running.
+//
+// The receive and transmit tasks keep counting in their own plain structs,
+// nothing is added per packet or per frame.  Once per iteration each task
+// hands them here with the iteration's start and end, which keeps the loop
+// timing, and every PUBLISH_INTERVAL_US they are published for readers.
+//
+// The transmit task also hands over the stamp of each frame it starts that
+// carries newly received data, which goes in the latency histograms.
+class NodeTelemetry {
+public:
+  // Stages of the way from the socket to the cable.
+  enum Latency : uint8_t {
+    LATENCY_ROUTE,      // Read from the socket to routed to the port.
+    LATENCY_QUEUE,      // Routed to handed to dmx_send_num().
+    LATENCY_TOTAL,      // Read from the socket to handed to dmx_send_num().
+    LATENCY_MAX
+  };
+
+  static const uint32_t PUBLISH_INTERVAL_US = 100000;
+  static const uint32_t RATE_WINDOW_US      = 1000000;
+
+  static const uint32_t HEARD_ARTNET = 0x01;
+  static const uint32_t HEARD_SACN   = 0x02;
+
+  NodeTelemetry();
+
+  // Forgets everything.  Neither task may be running.
+  void Reset( uint32_t now_us );
+
+  // Receive task, after each iteration.
+  void OnReceive( const ArtNetReceiveStats& artnet, const SACNReceiveStats& sacn, uint32_t start_us, uint32_t end_us, uint32_t now_ms );
+
+  // Transmit task, after each iteration, with the ports that started a frame.
+  // The ports' refresh timing and jitter buffers are published from
+  // ptr_dmx_ports, DMX_PORT_MAX of them.
+  void OnTransmit( uint8_t started_ports, uint32_t start_us, uint32_t end_us, const DMXPort* ptr_dmx_ports );
+
+  // Transmit task, for each stamped frame started.
+  void OnFrameSent( const DMXFrameStamp& stamp ) {
+    m_latency[ LATENCY_ROUTE ].Record( stamp.m_routed_us - stamp.m_received_us );
+    m_latency[ LATENCY_QUEUE ].Record( stamp.m_sent_us - stamp.m_routed_us );
+    m_latency[ LATENCY_TOTAL ].Record( stamp.m_sent_us - stamp.m_received_us );
+  }
+
+  const LatencyHistogram& GetLatency( Latency latency ) const;
+
+  // Any task, the histograms empty before the next frame is counted.
+  void ResetLatency();
+
+  ReceiveTelemetry GetReceive() const;
+
+  TransmitTelemetry GetTransmit() const;
+
+  // The last published values as one line of JSON, cut short if size is too
+  // small.  Returns the length written.
+  size_t FormatJSON( char* buffer, size_t size, uint32_t now_ms, uint8_t started_ports, uint32_t free_heap, uint32_t min_free_heap ) const;
+
+  // The latency histograms' percentiles, the same way.
+  size_t FormatLatencyJSON( char* buffer, size_t size ) const;
+
+private:
+  // Kept by the task that owns it, published as LoopStats.
+  struct LoopTimer {
+    uint32_t m_iterations;
+    uint32_t m_min_us;
+    uint32_t m_max_us;
+    uint64_t m_sum_us;
+
+    void Reset();
+
+    void Record( uint32_t duration_us ) {
+      m_iterations++;
+      m_sum_us += duration_us;
+      m_min_us = std::min( m_min_us, duration_us );
+      m_max_us = std::max( m_max_us, duration_us );
+    }
+
+    LoopStats Get() const;
+  };
+
+  // Receive task.
+  LoopTimer         m_receive_timer;
+  ReceiveTelemetry  m_receive;
+  uint32_t          m_receive_published_us;
+
+  // Transmit task.
+  LoopTimer         m_transmit_timer;
+  TransmitTelemetry m_transmit;
+  uint32_t          m_transmit_published_us;
+  uint32_t          m_window_start_us;
+  uint32_t          m_window_frames[ DMX_PORT_MAX ];
+  uint32_t          m_window_first_us[ DMX_PORT_MAX ];
+  uint32_t          m_window_last_us[ DMX_PORT_MAX ];
+
+  TelemetrySnapshot<ReceiveTelemetry>  m_published_receive;
+  TelemetrySnapshot<TransmitTelemetry> m_published_transmit;
+
+  // Recorded by the transmit task.
+  LatencyHistogram  m_latency[ LATENCY_MAX ];
+};
+
+#endif
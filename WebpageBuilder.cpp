@@ -163,6 +163,25 @@ void WebpageBuilder::AddEnabledSelection(const String& name, const String& id, b
   m_html += ">Disabled</option></select>";
 }
 
+void WebpageBuilder::AddMergeOperatorSelection(const String& name, const String& id, uint8_t merge_operator) {
+  static const char* const descriptions[DMX_MERGE_MAX] = {
+    "HTP : highest wins",
+    "LTP : input replaces",
+    "Add : added, up to 255",
+    "Scale : scaled by input",
+    "Priority : input replaces when above 0"
+  };
+  m_html += "<select name=\"" + name + "\" id=\"" + id + "\">";
+  for (uint8_t i = 0; i < DMX_MERGE_MAX; i++) {
+    m_html += "<option value=\"" + String(DMXRoutingTable::GetMergeOperatorName(i)) + "\"";
+    if (i == merge_operator) {
+      m_html += " selected";
+    }
+    m_html += ">" + String(descriptions[i]) + "</option>";
+  }
+  m_html += "</select>";
+}
+
 void WebpageBuilder::AddSpace(int amount) {
   for (int i = 0; i < amount; i++) {
     m_html += "&nbsp";
@@ -179,24 +198,31 @@ void WebpageBuilder::AddStandardViewportScale() {
   m_html += "<meta charset=\"UTF-8\"><meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">";
 }
 
-void WebpageBuilder::AddDMXRoutingConfigTable(const std::vector<DMXRoutingConfig>& routing_configs) {
+void WebpageBuilder::AddDMXRoutingConfigTable(const DMXRoutingTable& routing_table) {
   StartPage();
   AddTitle("DMX Routing Configuration");
   StartBody();
   StartCenter();
   AddHeading("DMX Routing Configuration");
 
-  m_html += "<table border='1'><tr><th>Input Channel</th><th>Output Channels</th><th>Actions</th></tr>";
-  for (size_t i = 0; i < routing_configs.size(); ++i) {
-    const auto& config = routing_configs[i];
-    m_html += "<tr><td>" + String(config.input_channel) + "</td><td>";
-    for (size_t j = 0; j < config.output_channels.size(); ++j) {
-      m_html += String(config.output_channels[j]);
-      if (j < config.output_channels.size() - 1) {
-        m_html += ", ";
+  m_html += "<table border='1'><tr><th>Input Channel</th><th>Output Channels</th><th>Merge</th><th>Actions</th></tr>";
+  for (size_t i = 0; i < routing_table.Size(); ++i) {
+    const DMXRoutingConfig& config = routing_table.GetRoute(i);
+    const uint16_t* ptr_output_channels = routing_table.GetOutputChannels(i);
+    if (config.input_count > 1) {
+      String block_str = routing_table.FormatBlock(i);
+      int separator = block_str.indexOf('>');
+      m_html += "<tr><td>" + block_str.substring(0, separator - 1) + "</td><td>" + block_str.substring(separator + 2);
+    } else {
+      m_html += "<tr><td>" + String(config.input_channel) + "</td><td>";
+      for (uint16_t j = 0; j < config.output_count; ++j) {
+        m_html += String(ptr_output_channels[j]);
+        if (j < config.output_count - 1) {
+          m_html += ", ";
+        }
       }
     }
-    m_html += "</td><td>";
+    m_html += "</td><td>" + String(DMXRoutingTable::GetMergeOperatorName(config.merge_operator)) + "</td><td>";
     m_html += "<form action='/edit_dmx_routing' method='POST' style='display:inline;'><input type='hidden' name='index' value='" + String(i) + "'><input type='submit' value='Edit'></form>";
     m_html += " ";
     m_html += "<form action='/delete_dmx_routing' method='POST' style='display:inline;'><input type='hidden' name='index' value='" + String(i) + "'><input type='submit' value='Delete'></form>";
@@ -205,11 +231,17 @@ void WebpageBuilder::AddDMXRoutingConfigTable(const std::vector<DMXRoutingConfig
   m_html += "</table>";
 
   AddFormAction("/setup_dmx_routing", "POST");
-  AddLabel("input_channel", "Input DMX Channel:");
-  AddInputType("number", "input_channel", "input_channel", "", "", true);
+  AddLabel("input_channel", "Input DMX Channel (1-512):");
+  AddInputType("number", "input_channel", "input_channel", "", "", false);
+  AddBreak(2);
+  AddLabel("output_channels", "Output DMX Channels (1-512, comma-separated):");
+  AddInputType("text", "output_channels", "output_channels", "", "", false);
+  AddBreak(2);
+  AddLabel("block", "Or a block of DMX Channels (first-last > output, /n for every n-th output):");
+  AddInputType("text", "block", "block", "", "1-100 > 201-300", false);
   AddBreak(2);
-  AddLabel("output_channels", "Output DMX Channels (comma-separated):");
-  AddInputType("text", "output_channels", "output_channels", "", "", true);
+  AddLabel("merge", "Merge with the output channel:");
+  AddMergeOperatorSelection("merge", "merge", DMX_MERGE_HTP);
   AddBreak(3);
 
   AddButton("submit", "ADD ROUTE");
@@ -4,8 +4,8 @@
 #include "Arduino.h"
 #include <vector>
 
-// Forward declaration of DMXRoutingConfig
-struct DMXRoutingConfig;
+// Forward declaration of DMXRoutingTable
+class DMXRoutingTable;
 
 class WebpageBuilder
 {
@@ -69,6 +69,8 @@ public:
   void AddGridEntryTextCell(const String& name, const String& value, bool required);
   
   void AddEnabledSelection(const String& name, const String& id, bool enabled);
+
+  void AddMergeOperatorSelection(const String& name, const String& id, uint8_t merge_operator);
   
   void AddSpace(int amount);
   
@@ -76,7 +78,7 @@ public:
   
   void AddStandardViewportScale();
 
-  void AddDMXRoutingConfigTable(const std::vector<DMXRoutingConfig>& routing_configs);
+  void AddDMXRoutingConfigTable(const DMXRoutingTable& routing_table);
 
   String m_html;
 
@@ -0,0 +1,158 @@
+// Host-side replay driver and benchmarks for ESP32Artnet2DMX.
+//
+//   artnet_replay synthetic [--universes N] [--rate HZ] [--seconds S] [--channels C] [--universe U]
+//                           [--reorder P] [--loss P] [--seed N]
+//   artnet_replay pcap FILE
+//   artnet_replay routing [--iterations N]
+//   artnet_replay universes [--iterations N]
+//   artnet_replay triplebuffer [--seconds S]
+//   artnet_replay latency [--rate HZ] [--seconds S] [--gap-us US]
+//   artnet_replay fuzz [--iterations N] [--seed N]
+//   artnet_replay parse [--iterations N]
+//   artnet_replay merge [--iterations N]
+//   artnet_replay curves [--iterations N]
+//   artnet_replay interpolate [--iterations N]
+//   artnet_replay jitter [--seconds S] [--jitter-ms MS] [--seed N]
+//   artnet_replay poll [--polls N] [--iterations N]
+//   artnet_replay sync [--seconds S]
+//   artnet_replay sacn [--iterations N] [--pcap FILE]
+//   artnet_replay stats [--seconds S] [--iterations N]
+//
+// Common options :
+//   --loop-us US    Simulated device time one loop() iteration costs (default 50).
+//   --queue N       UDP receive queue depth in datagrams (default 16).
+//   --config FILE   JSON config loaded as /config.json before Init().
+//   --serial        Echo Serial output to stderr.
+//   --start-us US   Simulated time at start, e.g. 4294000000 to cross the micros() wrap.
+//   --stall-ms MS --stall-every-ms MS
+//                   Block one loop() iteration for MS every so often.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static Arguments ParseArguments( int argc, char** argv ) {
+  Arguments arguments;
+  for( int i = 2; i < argc; i++ ) {
+    if( strncmp( argv[ i ], "--", 2 ) == 0 ) {
+      std::string name = argv[ i ] + 2;
+      if( i + 1 < argc && strncmp( argv[ i + 1 ], "--", 2 ) != 0 ) {
+        arguments.m_options[ name ] = argv[ ++i ];
+      } else {
+        arguments.m_options[ name ] = "1";
+      }
+    } else {
+      arguments.m_positional.push_back( argv[ i ] );
+    }
+  }
+  return arguments;
+}
+
+static ReplayHarness::Options HarnessOptions( const Arguments& arguments ) {
+  ReplayHarness::Options options;
+  options.m_loop_us     = (uint64_t)arguments.Number( "loop-us", 50 );
+  options.m_queue_depth = (size_t)arguments.Number( "queue", 16 );
+  options.m_serial      = arguments.Has( "serial" );
+  options.m_start_us    = (uint64_t)arguments.Number( "start-us", 0 );
+  options.m_stall_us    = (uint64_t)( arguments.Number( "stall-ms", 0 ) * 1000 );
+  options.m_stall_period_us = (uint64_t)( arguments.Number( "stall-every-ms", 0 ) * 1000 );
+  return options;
+}
+
+static std::string ConfigJson( const Arguments& arguments ) {
+  if( !arguments.Has( "config" ) ) {
+    return std::string();
+  }
+  std::ifstream file( arguments.Text( "config", "" ) );
+  std::stringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+
+static int RunEvents( const Arguments& arguments, const char* name, const std::vector<ReplayHarness::Event>& events ) {
+  ReplayHarness harness( HarnessOptions( arguments ) );
+  std::string config = ConfigJson( arguments );
+  harness.Setup( config.empty() ? nullptr : config.c_str() );
+
+  ReplayHarness::Result result = harness.Run( events, 100000 );
+  ReplayHarness::PrintResult( name, result );
+  return 0;
+}
+
+static int ScenarioSynthetic( const Arguments& arguments ) {
+  int      universes = (int)arguments.Number( "universes", 1 );
+  double   rate_hz   = arguments.Number( "rate", 44 );
+  double   seconds   = arguments.Number( "seconds", 10 );
+  uint16_t channels  = (uint16_t)arguments.Number( "channels", 512 );
+  uint16_t universe  = (uint16_t)arguments.Number( "universe", 1 );
+
+  std::vector<ReplayHarness::Event> events = ReplayHarness::SyntheticStream( universe, universes, rate_hz, seconds, channels, IPAddress( 192, 168, 1, 100 ) );
+  ReplayHarness::Impair( events, arguments.Number( "reorder", 0 ), arguments.Number( "loss", 0 ), (uint32_t)arguments.Number( "seed", 1 ) );
+
+  char name[ 128 ];
+  snprintf( name, sizeof( name ), "synthetic: %d universe(s) x %.0f Hz x %u channels, %.1f s", universes, rate_hz, channels, seconds );
+  return RunEvents( arguments, name, events );
+}
+
+static int ScenarioPcap( const Arguments& arguments ) {
+  if( arguments.m_positional.empty() ) {
+    fprintf( stderr, "pcap: capture file required\n" );
+    return 2;
+  }
+
+  std::vector<ReplayHarness::Event> events;
+  if( !ReplayHarness::LoadPcap( arguments.m_positional[ 0 ].c_str(), events ) ) {
+    fprintf( stderr, "pcap: failed to read %s\n", arguments.m_positional[ 0 ].c_str() );
+    return 1;
+  }
+
+  std::string name = "pcap: " + arguments.m_positional[ 0 ];
+  return RunEvents( arguments, name.c_str(), events );
+}
+
+struct Scenario {
+  const char*                           m_name;
+  std::function<int( const Arguments& )> m_function;
+};
+
+static const Scenario g_scenarios[] = {
+  { "synthetic", ScenarioSynthetic },
+  { "pcap",      ScenarioPcap },
+  { "routing",   BenchRouting },
+  { "universes", BenchUniverses },
+  { "triplebuffer", StressTripleBuffer },
+  { "latency",   BenchLatency },
+  { "fuzz",      FuzzArtNetParser },
+  { "parse",     BenchParser },
+  { "merge",     BenchMerge },
+  { "curves",    BenchCurves },
+  { "interpolate", BenchInterpolation },
+  { "jitter",    BenchJitter },
+  { "poll",      BenchPoll },
+  { "sync",      BenchSync },
+  { "sacn",      BenchSACN },
+  { "stats",     BenchStats },
+};
+
+int main( int argc, char** argv ) {
+  if( argc >= 2 ) {
+    for( const Scenario& scenario : g_scenarios ) {
+      if( strcmp( argv[ 1 ], scenario.m_name ) == 0 ) {
+        return scenario.m_function( ParseArguments( argc, argv ) );
+      }
+    }
+  }
+
+  fprintf( stderr, "usage: %s <scenario> [options]\nscenarios:", argv[ 0 ] );
+  for( const Scenario& scenario : g_scenarios ) {
+    fprintf( stderr, " %s", scenario.m_name );
+  }
+  fprintf( stderr, "\n" );
+  return 2;
+}
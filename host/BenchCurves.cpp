@@ -0,0 +1,130 @@
+// Response curves : the lookup tables checked against what each curve should
+// do, the cost of the lookup pass per frame against the plain copy it
+// replaces, and a curve applied through the node.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "DMXCurves.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static bool CheckTables() {
+  uint8_t table[ 256 ];
+  bool is_ok = true;
+
+  DMXCurve linear = { 100, 100, false, 0, 255 };
+  DMXCurves::BuildTable( linear, table );
+  for( int i = 0; i < 256; i++ ) {
+    is_ok &= ( table[ i ] == i );
+  }
+
+  DMXCurve invert = { 100, 100, true, 0, 255 };
+  DMXCurves::BuildTable( invert, table );
+  for( int i = 0; i < 256; i++ ) {
+    is_ok &= ( table[ i ] == 255 - i );
+  }
+
+  DMXCurve clamp = { 100, 100, false, 20, 200 };
+  DMXCurves::BuildTable( clamp, table );
+  for( int i = 0; i < 256; i++ ) {
+    is_ok &= ( table[ i ] == std::max( 20, std::min( 200, i ) ) );
+  }
+
+  DMXCurve half = { 100, 50, false, 0, 255 };
+  DMXCurves::BuildTable( half, table );
+  is_ok &= ( table[ 0 ] == 0 && table[ 100 ] == 50 && table[ 255 ] == 128 );
+
+  // Gamma keeps both ends, rises all the way and sits below linear in between.
+  DMXCurve gamma = { 220, 100, false, 0, 255 };
+  DMXCurves::BuildTable( gamma, table );
+  is_ok &= ( table[ 0 ] == 0 && table[ 255 ] == 255 && table[ 128 ] < 64 );
+  for( int i = 1; i < 256; i++ ) {
+    is_ok &= ( table[ i ] >= table[ i - 1 ] ) && ( table[ i ] <= i );
+  }
+
+  // Three assignments with two different curves share the identity and two tables.
+  DMXCurves curves;
+  curves.Compile( { { 0, 1, 16, gamma }, { 0, 100, 4, invert }, { 1, 1, 512, gamma } } );
+  is_ok &= ( curves.GetTableCount() == 3 );
+  const uint8_t* ptr_port_1 = curves.GetCurveIndexes( 0 );
+  const uint8_t* ptr_port_2 = curves.GetCurveIndexes( 1 );
+  is_ok &= ( ptr_port_1 != nullptr && ptr_port_2 != nullptr && ptr_port_1[ 0 ] == 0 && ptr_port_1[ 16 ] == ptr_port_2[ 512 ] &&
+             ptr_port_1[ 17 ] == 0 && ptr_port_1[ 100 ] != 0 && ptr_port_1[ 100 ] != ptr_port_1[ 1 ] );
+  if( DMX_PORT_MAX > 2 ) {
+    is_ok &= ( curves.GetCurveIndexes( 2 ) == nullptr );
+  }
+
+  printf( "curves: tables for linear, invert, clamp, scale and gamma, shared between channels : %s\n", is_ok ? "as expected" : "WRONG" );
+  return is_ok;
+}
+
+// Channel 1 inverted and channel 2 clamped at 100 on the way out of the node.
+static bool CheckNodeCurves() {
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+                 "\"dmx_curves\":[{\"port\":0,\"channel\":1,\"count\":1,\"gamma\":100,\"scale\":100,\"invert\":true,\"min\":0,\"max\":255},"
+                 "{\"port\":0,\"channel\":2,\"count\":1,\"max\":100}]}" );
+
+  uint8_t data[ 512 ] = { 10, 200, 50 };
+  std::vector<ReplayHarness::Event> events;
+  for( uint64_t time_us = 50000; time_us < 300000; time_us += 25000 ) {
+    ReplayHarness::Event event;
+    event.m_time_us    = time_us;
+    event.m_data       = ReplayHarness::BuildArtDMX( 1, 0, data, 512 );
+    event.m_source_ip  = IPAddress( 192, 168, 1, 100 );
+    event.m_local_port = ARTNET_UDP_PORT;
+    event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+    events.push_back( event );
+  }
+
+  uint8_t last_frame[ 4 ] = {};
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    memcpy( last_frame, frame, std::min( size, sizeof( last_frame ) ) );
+  };
+  harness.Run( events, 100000 );
+  HostDMX::s_send_hook = nullptr;
+
+  bool is_ok = ( last_frame[ 1 ] == 245 && last_frame[ 2 ] == 100 && last_frame[ 3 ] == 50 );
+  printf( "curves: node sends 10 200 50 as %u %u %u : %s\n", last_frame[ 1 ], last_frame[ 2 ], last_frame[ 3 ], is_ok ? "as expected" : "WRONG" );
+  return is_ok;
+}
+
+int BenchCurves( const Arguments& arguments ) {
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 200000 );
+
+  bool is_ok = CheckTables();
+
+  // Every channel with one of four curves, the worst case.
+  std::vector<DMXCurveAssignment> assignments;
+  for( uint16_t channel = 1; channel <= 512; channel++ ) {
+    assignments.push_back( { 0, channel, 1, { (uint16_t)( 100 + 40 * ( channel % 4 ) ), 100, false, 0, 255 } } );
+  }
+  DMXCurves curves;
+  curves.Compile( assignments );
+
+  uint8_t input[ DMX_PACKET_SIZE ];
+  uint8_t output[ DMX_PACKET_SIZE ];
+  for( int i = 0; i < DMX_PACKET_SIZE; i++ ) {
+    input[ i ] = (uint8_t)( i * 37 );
+  }
+
+  double copy_ns = MeasureNs( [&]() {
+    memcpy( output, input, DMX_PACKET_SIZE );
+    KeepAlive( output );
+  }, iterations );
+  double lookup_ns = MeasureNs( [&]() {
+    DMXCurves::Apply( curves.GetTables(), curves.GetCurveIndexes( 0 ), input, output, DMX_PACKET_SIZE );
+    KeepAlive( output );
+  }, iterations );
+
+  printf( "curves: 513 slot frame, %zu tables, ns per frame\n", curves.GetTableCount() );
+  printf( "  copy only     : %8.1f\n", copy_ns );
+  printf( "  curve lookups : %8.1f  (%.2f ns per channel)\n", lookup_ns, lookup_ns / DMX_PACKET_SIZE );
+
+  is_ok &= CheckNodeCurves();
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+// Interpolation : a 25 Hz source upsampled to the 44 Hz DMX refresh, the size
+// of the steps a moving head makes with and without it, a 16 bit pan kept in
+// one piece, a snap channel that must never pass through in between values,
+// and the cost per DMX frame by how many channels are in motion.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "DMXInterpolator.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static const uint32_t SOURCE_INTERVAL_US = 40000;   // 25 Hz
+static const uint32_t DMX_INTERVAL_US    = 22676;   // 44 Hz
+
+// The source at frame n : a 16 bit pan on 1/2 sweeping up, an 8 bit dimmer
+// on 3 fading up, a gobo on 5 switching between two slots and a slow 16 bit
+// tilt on 7/8, whose coarse channel only moves every few frames.
+static void BuildSourceFrame( uint32_t n, uint8_t* frame ) {
+  uint32_t pan  = std::min<uint32_t>( n * 1300, 65000 );
+  uint32_t tilt = 1000 + n * 37;
+  frame[ 1 ] = pan >> 8;
+  frame[ 2 ] = pan & 0xFF;
+  frame[ 3 ] = (uint8_t)std::min<uint32_t>( n * 5, 255 );
+  frame[ 5 ] = ( ( n / 12 ) % 2 ) ? 200 : 10;
+  frame[ 7 ] = tilt >> 8;
+  frame[ 8 ] = tilt & 0xFF;
+}
+
+struct Motion {
+  uint32_t m_max_step;      // Largest pan change from one DMX frame to the next.
+  uint32_t m_stalls;        // DMX frames the pan didn't move while sweeping.
+  uint32_t m_reversals;     // DMX frames the pan or tilt went backwards.
+  uint32_t m_snap_wrong;    // DMX frames with the gobo between its two slots.
+  uint32_t m_last_pan;
+};
+
+// Two seconds of the source, sent out at the DMX refresh.
+static Motion Simulate( bool is_interpolating, bool is_paired ) {
+  std::vector<DMXInterpolationAssignment> assignments;
+  if( is_paired ) {
+    assignments.push_back( { 0, 1, 1, 2 } );
+    assignments.push_back( { 0, 7, 1, 8 } );
+  }
+  assignments.push_back( { 0, 5, 1, 0 } );
+  DMXInterpolator interpolator;
+  interpolator.Configure( true, 0, assignments );
+
+  Motion  motion = {};
+  uint8_t frame[ DMX_PACKET_SIZE ] = {};
+  uint32_t source_frame = 0;
+  uint32_t next_source_us = 0;
+  int32_t  last_pan  = -1;
+  int32_t  last_tilt = -1;
+  for( uint32_t now_us = 0; now_us < 2500000; now_us += DMX_INTERVAL_US ) {
+    bool is_new = false;
+    while( next_source_us <= now_us ) {
+      BuildSourceFrame( source_frame++, frame );
+      next_source_us += SOURCE_INTERVAL_US;
+      is_new = true;
+    }
+
+    const uint8_t* ptr_output = frame;
+    if( is_interpolating ) {
+      if( is_new ) {
+        interpolator.SetTarget( frame, DMX_PACKET_SIZE, now_us );
+      }
+      ptr_output = interpolator.Render( now_us );
+    }
+
+    int32_t pan  = ( ptr_output[ 1 ] << 8 ) | ptr_output[ 2 ];
+    int32_t tilt = ( ptr_output[ 7 ] << 8 ) | ptr_output[ 8 ];
+    if( last_pan != -1 ) {
+      motion.m_max_step   = std::max<uint32_t>( motion.m_max_step, std::abs( pan - last_pan ) );
+      motion.m_reversals += ( pan < last_pan ) + ( tilt < last_tilt );
+      motion.m_stalls    += ( pan == last_pan && pan > 0 && pan < 65000 );
+    }
+    motion.m_snap_wrong += ( ptr_output[ 5 ] != 10 && ptr_output[ 5 ] != 200 );
+    last_pan  = pan;
+    last_tilt = tilt;
+  }
+  motion.m_last_pan = (uint32_t)last_pan;
+  return motion;
+}
+
+static bool CheckMotion() {
+  Motion stepping     = Simulate( false, true );
+  Motion interpolated = Simulate( true, true );
+  Motion unpaired     = Simulate( true, false );
+
+  printf( "interpolate: 16 bit pan and tilt at 25 Hz sent at 44 Hz, over the sweep\n" );
+  printf( "  %-26s : largest step %5u, %3u stalls, %3u reversals, gobo between slots %u times\n", "stepping to each frame",
+          stepping.m_max_step, stepping.m_stalls, stepping.m_reversals, stepping.m_snap_wrong );
+  printf( "  %-26s : largest step %5u, %3u stalls, %3u reversals, gobo between slots %u times\n", "interpolated",
+          interpolated.m_max_step, interpolated.m_stalls, interpolated.m_reversals, interpolated.m_snap_wrong );
+  printf( "  %-26s : largest step %5u, %3u stalls, %3u reversals, gobo between slots %u times\n", "pairs as 2 x 8 bit",
+          unpaired.m_max_step, unpaired.m_stalls, unpaired.m_reversals, unpaired.m_snap_wrong );
+
+  return interpolated.m_max_step < stepping.m_max_step && interpolated.m_stalls == 0 && interpolated.m_reversals == 0 &&
+         interpolated.m_snap_wrong == 0 && interpolated.m_last_pan == 65000 && unpaired.m_reversals > 0;
+}
+
+// Alternates between two targets, rendering halfway to each.
+static double MeasureFrame( uint16_t moving_channels, uint64_t iterations ) {
+  DMXInterpolator interpolator;
+  interpolator.Configure( true, 0, std::vector<DMXInterpolationAssignment>() );
+
+  uint8_t frames[ 2 ][ DMX_PACKET_SIZE ] = {};
+  for( uint16_t channel = 1; channel <= moving_channels; channel++ ) {
+    frames[ 1 ][ channel * 512 / std::max<uint16_t>( moving_channels, 1 ) ] = 255;
+  }
+
+  uint64_t frame  = 0;
+  uint32_t now_us = 0;
+  uint32_t sum    = 0;
+  interpolator.SetTarget( frames[ 0 ], DMX_PACKET_SIZE, now_us );
+  return MeasureNs( [&]() {
+    now_us += 2 * DMX_INTERVAL_US;
+    interpolator.SetTarget( frames[ ++frame & 1 ], DMX_PACKET_SIZE, now_us );
+    sum += interpolator.Render( now_us + DMX_INTERVAL_US )[ 256 ];
+    KeepAlive( sum );
+  }, iterations );
+}
+
+// The same sweep through the node, at the 23 ms update interval.
+static bool CheckNode( bool is_interpolating, uint32_t& max_step, uint32_t& reversals ) {
+  std::vector<ReplayHarness::Event> events;
+  uint8_t frame[ DMX_PACKET_SIZE ] = {};
+  for( uint32_t n = 0; n <= 50; n++ ) {
+    BuildSourceFrame( n, frame );
+    ReplayHarness::Event event;
+    event.m_time_us    = 50000 + n * SOURCE_INTERVAL_US;
+    event.m_data       = ReplayHarness::BuildArtDMX( 1, 0, frame + 1, 512 );
+    event.m_source_ip  = IPAddress( 192, 168, 1, 100 );
+    event.m_local_port = ARTNET_UDP_PORT;
+    event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+    events.push_back( event );
+  }
+
+  char config[ 384 ];
+  snprintf( config, sizeof( config ),
+            "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+            "\"dmx_interpolate\":%s,\"dmx_interpolation_channels\":[{\"port\":0,\"channel\":1,\"count\":1,\"fine_channel\":2},"
+            "{\"port\":0,\"channel\":5,\"count\":1,\"fine_channel\":0}]}", is_interpolating ? "true" : "false" );
+
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( config );
+
+  int32_t  last_pan   = -1;
+  uint32_t snap_wrong = 0;
+  max_step  = 0;
+  reversals = 0;
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    int32_t pan = ( frame[ 1 ] << 8 ) | frame[ 2 ];
+    if( last_pan != -1 ) {
+      max_step   = std::max<uint32_t>( max_step, std::abs( pan - last_pan ) );
+      reversals += ( pan < last_pan );
+    }
+    snap_wrong += ( frame[ 5 ] != 0 && frame[ 5 ] != 10 && frame[ 5 ] != 200 );
+    last_pan = pan;
+  };
+  harness.Run( events, 200000 );
+  HostDMX::s_send_hook = nullptr;
+
+  const DMXInterpolator::Stats& stats = harness.Node().GetDMXPort( 0 ).GetInterpolator().GetStats();
+  printf( "  node, %-12s : largest step %5u, %u reversals, ends at %d; %u targets, %llu channel steps over %u frames\n",
+          is_interpolating ? "interpolated" : "stepping", max_step, reversals, last_pan,
+          stats.m_targets, (unsigned long long)stats.m_channel_steps, stats.m_renders );
+  return last_pan == 65000 && snap_wrong == 0;
+}
+
+int BenchInterpolation( const Arguments& arguments ) {
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 200000 );
+
+  bool is_ok = CheckMotion();
+
+  printf( "interpolate: ns per DMX frame, a new target then a render\n" );
+  for( uint16_t moving : { 0, 16, 128, 512 } ) {
+    printf( "  %3u channels in motion : %6.1f\n", moving, MeasureFrame( moving, iterations ) );
+  }
+
+  uint32_t stepping_step, stepping_reversals, interpolated_step, interpolated_reversals;
+  is_ok &= CheckNode( false, stepping_step, stepping_reversals );
+  is_ok &= CheckNode( true, interpolated_step, interpolated_reversals );
+  is_ok &= interpolated_step < stepping_step && interpolated_reversals == 0;
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+// Jitter buffer : a 50 Hz source arriving over WiFi in bursts of three
+// packets within 2 ms, every 60 ms and a random few ms late on top, replayed
+// without a jitter buffer and with a few delays.  Reports how evenly the
+// frames come out of DMX, how many make it, what the delay costs in latency
+// and the buffer's own underrun and overrun counts.  Then fills the buffer with
+// nothing read, to check it drops the oldest frames for new ones.
+
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static const uint32_t SOURCE_INTERVAL_US = 20000;   // 50 Hz
+static const uint32_t BURST_FRAMES       = 3;
+
+struct Playout {
+  uint32_t m_sent;
+  uint32_t m_delivered;       // Frames seen on DMX.
+  double   m_interval_mean_us;
+  uint64_t m_deviation_p95_us; // | interval between new frames - source interval |
+  uint64_t m_gap_max_us;
+  double   m_latency_mean_us; // Arrival to the break of the first DMX frame carrying it.
+  uint64_t m_latency_max_us;
+  DMXJitterBuffer::Stats m_stats;
+};
+
+static Playout Replay( const std::vector<ReplayHarness::Event>& events, const std::vector<uint64_t>& arrivals_us, uint32_t delay_ms ) {
+  char config[ 320 ];
+  snprintf( config, sizeof( config ),
+            "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,"
+            "\"dmx_update_interval_ms\":23,\"dmx_send_on_receive\":true,\"dmx_jitter_delay_ms\":%u}", delay_ms );
+
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( config );
+
+  // Channels 1 and 2 carry the source's frame number.
+  std::map<uint32_t, uint64_t> first_break_us;
+  std::vector<uint64_t> change_us;
+  int32_t last_frame = -1;
+  uint64_t start_us  = HostClock::NowMicros();
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    int32_t number = ( frame[ 1 ] << 8 ) | frame[ 2 ];
+    if( number == 0 || number == last_frame ) {
+      return;
+    }
+    first_break_us.emplace( number, break_us - start_us );
+    change_us.push_back( break_us - start_us );
+    last_frame = number;
+  };
+  ReplayHarness::Result result = harness.Run( events, 200000 );
+  HostDMX::s_send_hook = nullptr;
+
+  Playout playout = {};
+  playout.m_sent      = (uint32_t)events.size();
+  playout.m_delivered = (uint32_t)first_break_us.size();
+  playout.m_stats     = result.m_jitter_stats[ 0 ];
+
+  std::vector<uint64_t> deviations;
+  for( size_t i = 1; i < change_us.size(); i++ ) {
+    uint64_t interval_us = change_us[ i ] - change_us[ i - 1 ];
+    playout.m_interval_mean_us += interval_us;
+    playout.m_gap_max_us = std::max( playout.m_gap_max_us, interval_us );
+    deviations.push_back( interval_us > SOURCE_INTERVAL_US ? interval_us - SOURCE_INTERVAL_US : SOURCE_INTERVAL_US - interval_us );
+  }
+  playout.m_interval_mean_us /= std::max<size_t>( deviations.size(), 1 );
+  std::sort( deviations.begin(), deviations.end() );
+  playout.m_deviation_p95_us = deviations.empty() ? 0 : deviations[ deviations.size() * 95 / 100 ];
+
+  for( const auto& delivered : first_break_us ) {
+    uint64_t latency_us = delivered.second - arrivals_us[ delivered.first - 1 ];
+    playout.m_latency_mean_us += latency_us;
+    playout.m_latency_max_us   = std::max( playout.m_latency_max_us, latency_us );
+  }
+  playout.m_latency_mean_us /= std::max<size_t>( first_break_us.size(), 1 );
+  return playout;
+}
+
+// Twice the queue and more published while the first frame is still being
+// sent : the oldest frames make room until the write buffer would reach the
+// frame being sent, then the new ones are dropped.
+static bool CheckOverrun() {
+  const uint32_t INTERVAL_US = DMXJitterBuffer::MAX_CADENCE_US + 1;   // No cadence, frames play as they come.
+  const uint32_t PUBLISHED   = 2 * DMXJitterBuffer::DEPTH + 4;
+  const uint32_t KEPT_LAST   = 2 * DMXJitterBuffer::DEPTH;           // The last published before the buffer stalled.
+
+  DMXJitterBuffer jitter_buffer;
+  jitter_buffer.Configure( 1000 );
+  for( uint32_t number = 1; number <= PUBLISHED; number++ ) {
+    jitter_buffer.GetWriteBuffer()[ 1 ] = (uint8_t)number;
+    jitter_buffer.Publish( DMX_PACKET_SIZE, number * INTERVAL_US );
+  }
+
+  std::vector<uint32_t> played;
+  while( jitter_buffer.Acquire( ( PUBLISHED + 1 ) * INTERVAL_US ) ) {
+    played.push_back( jitter_buffer.GetReadBuffer()[ 1 ] );
+  }
+
+  bool is_ok = played.size() == DMXJitterBuffer::DEPTH && played.front() == KEPT_LAST - DMXJitterBuffer::DEPTH + 1 &&
+               played.back() == KEPT_LAST && jitter_buffer.GetStats().m_overruns == PUBLISHED - DMXJitterBuffer::DEPTH;
+  printf( "  overrun : %u frames published unread, %zu played, %u - %u, %u overruns\n", PUBLISHED, played.size(),
+          played.empty() ? 0 : played.front(), played.empty() ? 0 : played.back(), jitter_buffer.GetStats().m_overruns );
+  return is_ok;
+}
+
+int BenchJitter( const Arguments& arguments ) {
+  double   seconds   = arguments.Number( "seconds", 10 );
+  uint32_t jitter_us = (uint32_t)( arguments.Number( "jitter-ms", 15 ) * 1000 );
+  uint32_t seed      = (uint32_t)arguments.Number( "seed", 1 );
+
+  // Each burst leaves as its last frame is made, then WiFi holds it back a little more.
+  std::mt19937 random( seed );
+  std::vector<ReplayHarness::Event> events;
+  std::vector<uint64_t> arrivals_us;
+  uint8_t data[ 100 ] = {};
+  uint32_t frames = (uint32_t)( seconds * 1e6 / SOURCE_INTERVAL_US ) / BURST_FRAMES * BURST_FRAMES;
+  uint64_t burst_us = 0;
+  for( uint32_t number = 1; number <= frames; number++ ) {
+    uint32_t in_burst = ( number - 1 ) % BURST_FRAMES;
+    if( in_burst == 0 ) {
+      burst_us = 50000 + (uint64_t)( number - 1 + BURST_FRAMES - 1 ) * SOURCE_INTERVAL_US + ( jitter_us ? random() % jitter_us : 0 );
+    }
+    data[ 0 ] = number >> 8;
+    data[ 1 ] = number & 0xFF;
+    ReplayHarness::Event event;
+    event.m_time_us    = burst_us + in_burst * 1000;
+    event.m_data       = ReplayHarness::BuildArtDMX( 1, 0, data, sizeof( data ) );
+    event.m_source_ip  = IPAddress( 192, 168, 1, 100 );
+    event.m_local_port = ARTNET_UDP_PORT;
+    event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+    events.push_back( event );
+    arrivals_us.push_back( event.m_time_us );
+  }
+
+  printf( "jitter: 50 Hz source in bursts of %u within 2 ms plus up to %u ms late, %u frames, sent on receive\n",
+          BURST_FRAMES, jitter_us / 1000, frames );
+  printf( "  delay   delivered  interval mean  |dev| p95  gap max   latency mean  max    underruns overruns skipped\n" );
+
+  bool is_ok = true;
+  Playout unbuffered = {};
+  for( uint32_t delay_ms : { 0, 10, 30, 60 } ) {
+    Playout playout = Replay( events, arrivals_us, delay_ms );
+    printf( "  %3u ms  %5u/%-5u  %6.1f ms      %5.1f ms   %5.1f ms  %6.1f ms  %6.1f ms  %6u %8u %7u\n", delay_ms,
+            playout.m_delivered, playout.m_sent, playout.m_interval_mean_us / 1e3, playout.m_deviation_p95_us / 1e3, playout.m_gap_max_us / 1e3,
+            playout.m_latency_mean_us / 1e3, playout.m_latency_max_us / 1e3,
+            playout.m_stats.m_underruns, playout.m_stats.m_overruns, playout.m_stats.m_skipped );
+    if( delay_ms == 0 ) {
+      unbuffered = playout;
+    } else if( delay_ms >= 30 ) {
+      // Long enough to cover the burst and the WiFi delay : every frame, close to the source's pace.
+      is_ok &= playout.m_delivered == playout.m_sent && playout.m_deviation_p95_us < unbuffered.m_deviation_p95_us &&
+               playout.m_stats.m_overruns == 0;
+    }
+  }
+
+  is_ok &= CheckOverrun();
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
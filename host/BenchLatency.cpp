@@ -0,0 +1,158 @@
+// Packet to DMX break latency : the same Art-Net stream replayed with DMX sent
+// at the update interval and with DMX sent on receive.  The node's own latency
+// histograms, read over /latency, are checked against the latency the replay
+// measures on the simulated clock, and reset over /reset_latency.
+
+#include <stdio.h>
+#include <algorithm>
+
+#include <ArduinoJson.h>
+
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static void PrintSummary( const char* name, const LatencyHistogram::Summary& summary ) {
+  printf( "  %-20s: p50 %u, p95 %u, p99 %u, max %u over %u frames\n", name, (unsigned)summary.m_p50_us, (unsigned)summary.m_p95_us,
+          (unsigned)summary.m_p99_us, (unsigned)summary.m_max_us, (unsigned)summary.m_count );
+}
+
+static LatencyHistogram::Summary ReadSummary( JsonVariant histogram ) {
+  LatencyHistogram::Summary summary;
+  summary.m_count  = histogram[ "n" ].as<uint32_t>();
+  summary.m_p50_us = histogram[ "p50" ].as<uint32_t>();
+  summary.m_p95_us = histogram[ "p95" ].as<uint32_t>();
+  summary.m_p99_us = histogram[ "p99" ].as<uint32_t>();
+  summary.m_max_us = histogram[ "max" ].as<uint32_t>();
+  return summary;
+}
+
+// Every percentile of a at most that of b.
+static bool IsWithin( const LatencyHistogram::Summary& a, const LatencyHistogram::Summary& b ) {
+  return a.m_p50_us <= b.m_p50_us && a.m_p95_us <= b.m_p95_us && a.m_p99_us <= b.m_p99_us && a.m_max_us <= b.m_max_us;
+}
+
+// Each frame's total is its route plus its queue, so a percentile of the total
+// is that of the queue plus a route no longer than the longest, give or take
+// the eighth a bucket can add to each.
+static bool IsSum( const LatencyHistogram::Summary& route, const LatencyHistogram::Summary& queue,
+                   const LatencyHistogram::Summary& total ) {
+  auto is_near = [&]( uint32_t sum_us, uint32_t total_us ) {
+    uint32_t slack_us = std::max( sum_us, total_us ) / 8 + route.m_max_us;
+    return sum_us <= total_us + slack_us && total_us <= sum_us + slack_us;
+  };
+  return route.m_count == total.m_count && queue.m_count == total.m_count &&
+         is_near( route.m_p50_us + queue.m_p50_us, total.m_p50_us ) &&
+         is_near( route.m_p95_us + queue.m_p95_us, total.m_p95_us ) &&
+         is_near( route.m_p99_us + queue.m_p99_us, total.m_p99_us ) &&
+         is_near( route.m_max_us + queue.m_max_us, total.m_max_us );
+}
+
+static bool GetJSON( WebServer& server, ESP32Artnet2DMX& node, const char* uri, JsonDocument& doc ) {
+  server.HostRequest( HTTP_GET, uri );
+  node.Update();
+  return server.m_host_response_code == 200 && !deserializeJson( doc, server.m_host_response_body );
+}
+
+// What the transmit task adds per frame it starts with newly received data.
+static void MeasureCost( uint64_t iterations ) {
+  NodeTelemetry telemetry;
+  DMXFrameStamp stamp = { true, 0, 0, 0 };
+  double frame_ns = MeasureNs( [&]() {
+    stamp.m_routed_us += 7;
+    stamp.m_sent_us   += 23000;
+    telemetry.OnFrameSent( stamp );
+    stamp.m_received_us = stamp.m_sent_us - ( stamp.m_sent_us & 0xFFFF );
+  }, iterations );
+
+  double summary_ns = MeasureNs( [&]() {
+    KeepAlive( telemetry.GetLatency( NodeTelemetry::LATENCY_TOTAL ).GetSummary() );
+  }, iterations / 1000 );
+
+  printf( "  ns to record a frame's latencies : %.1f, ns to read a histogram's percentiles : %.0f\n", frame_ns, summary_ns );
+}
+
+int BenchLatency( const Arguments& arguments ) {
+  double   rate_hz    = arguments.Number( "rate", 30 );
+  double   seconds    = arguments.Number( "seconds", 10 );
+  int      gap_us     = (int)arguments.Number( "gap-us", 100 );
+  uint64_t loop_us    = (uint64_t)arguments.Number( "loop-us", 50 );
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 1000000 );
+  uint64_t read_us    = (uint64_t)arguments.Number( "read-us", 1 );
+
+  std::vector<ReplayHarness::Event> events = ReplayHarness::SyntheticStream( 1, 1, rate_hz, seconds, 512, IPAddress( 192, 168, 1, 100 ) );
+  // Each packet arrives on a loop iteration, so the node reads it at the
+  // moment it arrived, and after the first, which restarts the node.
+  for( ReplayHarness::Event& event : events ) {
+    event.m_time_us = ( event.m_time_us / loop_us + 1 ) * loop_us;
+  }
+
+  struct Mode {
+    const char* m_name;
+    bool        m_is_send_on_receive;
+    int         m_interval_ms;
+  };
+  const Mode modes[] = {
+    { "interval (23 ms)",                 false, 23 },
+    { "send on receive (1 s keep-alive)", true,  1000 },
+  };
+
+  bool is_ok = true;
+  for( const Mode& mode : modes ) {
+    char config[ 256 ];
+    snprintf( config, sizeof( config ),
+              "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,"
+              "\"dmx_update_interval_ms\":%d,\"dmx_send_on_receive\":%s,\"dmx_min_frame_gap_us\":%d}",
+              mode.m_interval_ms, mode.m_is_send_on_receive ? "true" : "false", gap_us );
+
+    ReplayHarness::Options options;
+    options.m_loop_us      = loop_us;
+    options.m_read_step_us = read_us;
+    ReplayHarness harness( options );
+    harness.Setup( config );
+
+    char name[ 128 ];
+    snprintf( name, sizeof( name ), "latency: %s, %.0f Hz", mode.m_name, rate_hz );
+    ReplayHarness::Result result = harness.Run( events, 100000 );
+    ReplayHarness::PrintResult( name, result );
+
+    // The replay's latencies through the same buckets.
+    LatencyHistogram reference;
+    for( uint64_t latency_us : result.m_latency_us ) {
+      reference.Record( (uint32_t)latency_us );
+    }
+
+    JsonDocument doc;
+    if( !GetJSON( harness.Server(), harness.Node(), "/latency", doc ) ) {
+      printf( "  GET /latency failed\n  FAIL\n" );
+      return 1;
+    }
+    LatencyHistogram::Summary route = ReadSummary( doc[ "parse_to_route_us" ] );
+    LatencyHistogram::Summary queue = ReadSummary( doc[ "route_to_send_us" ] );
+    LatencyHistogram::Summary total = ReadSummary( doc[ "parse_to_send_us" ] );
+    PrintSummary( "node parse to route", route );
+    PrintSummary( "node route to send", queue );
+    PrintSummary( "node parse to send", total );
+    PrintSummary( "replay, bucketed", reference.GetSummary() );
+
+    // Each micros() the node calls takes read_us, so routing a packet takes
+    // time too.  The node stamps a packet once it has read it and a frame
+    // before its break, inside what the replay measures from arrival to break.
+    bool is_match = route.m_p50_us > 0 && IsSum( route, queue, total ) &&
+                    IsWithin( total, reference.GetSummary() ) && total.m_count == reference.GetSummary().m_count &&
+                    total.m_count == result.m_receive_stats.m_dmx_frames;
+
+    // Emptied, and stays so until the next frame is sent.
+    JsonDocument reset_doc;
+    is_match &= GetJSON( harness.Server(), harness.Node(), "/reset_latency", reset_doc ) &&
+                reset_doc[ "parse_to_send_us" ][ "n" ].as<uint32_t>() == total.m_count;
+    is_match &= GetJSON( harness.Server(), harness.Node(), "/latency", doc ) && doc[ "parse_to_send_us" ][ "n" ].as<uint32_t>() == 0;
+
+    printf( "  node against replay : %s\n", is_match ? "ok" : "WRONG" );
+    is_ok &= is_match;
+  }
+
+  MeasureCost( iterations );
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
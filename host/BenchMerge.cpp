@@ -0,0 +1,164 @@
+// Two source merge : the cost of ArtNetMerger::Merge() per frame, then two
+// consoles replayed into the node checking what reaches DMX.
+
+#include <stdio.h>
+
+#include "ArtNetMerger.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static const IPAddress SOURCE_A( 192, 168, 1, 100 );
+static const IPAddress SOURCE_B( 192, 168, 1, 101 );
+
+// Merge() on frames alternating between the sources, each a copy of one of packets.
+static double MeasureMerge( bool is_ltp, int sources, const std::vector<uint8_t>* packets, int packet_count, uint64_t iterations ) {
+  ArtNetMerger merger;
+  merger.Reset( 1, ARTNET_PACKET_MAXSIZE, is_ltp, 0 );
+
+  uint64_t frame = 0;
+  uint32_t sum   = 0;
+  return MeasureNs( [&]() {
+    const std::vector<uint8_t>& packet = packets[ frame % packet_count ];
+    uint8_t* ptr_buffer = merger.GetReceiveBuffer();
+    memcpy( ptr_buffer, packet.data(), packet.size() );
+    ArtNetDMXView dmx;
+    ArtNetParser::ParseDMX( ptr_buffer, packet.size(), dmx );
+    const ArtNetDMXView* ptr_dmx = merger.Merge( 0, ( frame % sources ) ? SOURCE_B : SOURCE_A, 0, dmx );
+    sum += ptr_dmx->data[ frame & 511 ];
+    frame++;
+    KeepAlive( sum );
+  }, iterations );
+}
+
+// A fades channel 1 and holds channel 2 at 200, B holds every channel at 100
+// and optionally stops after 2 s.  Every DMX frame must be either A alone,
+// before B first arrives or after it timed out, or the merge; output that
+// flips between them is the flicker merging is there to stop.  When A goes
+// quiet too, at 2.5 s, no packet comes when B times out and the merge must
+// still fall back to A's last frame.
+static bool ReplayTwoSources( bool is_ltp, bool is_b_stopping, bool is_a_stopping ) {
+  std::vector<ReplayHarness::Event> events;
+  uint8_t data_a[ 512 ] = {};
+  uint8_t data_b[ 512 ];
+  memset( data_b, 100, sizeof( data_b ) );
+  uint8_t sequence = 1;
+  // A starts once the node is up, so that it is the first source, just before
+  // the DMX frame at 46 ms sends it alone.
+  for( uint64_t time_us = 40000, frame = 0; time_us < 4000000; time_us += 25000, frame++ ) {
+    if( is_a_stopping && time_us >= 2500000 ) {
+      break;
+    }
+    data_a[ 0 ] = (uint8_t)( frame * 4 );
+    data_a[ 1 ] = 200;
+    ReplayHarness::Event event;
+    event.m_time_us    = time_us;
+    event.m_data       = ReplayHarness::BuildArtDMX( 1, sequence, data_a, 512 );
+    event.m_source_ip  = SOURCE_A;
+    event.m_local_port = ARTNET_UDP_PORT;
+    event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+    events.push_back( event );
+    if( !is_b_stopping || time_us < 2000000 ) {
+      event.m_time_us   = time_us + 12000;
+      event.m_data      = ReplayHarness::BuildArtDMX( 1, sequence, data_b, 512 );
+      event.m_source_ip = SOURCE_B;
+      events.push_back( event );
+    }
+    sequence = ( sequence == 255 ) ? 1 : sequence + 1;
+  }
+
+  char config[ 256 ];
+  snprintf( config, sizeof( config ),
+            "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,"
+            "\"dmx_update_interval_ms\":23,\"artnet_merge_ltp\":%s,\"artnet_merge_timeout_ms\":1000}", is_ltp ? "true" : "false" );
+
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( config );
+
+  // HTP keeps A's 200 on channel 2; with LTP B took it when it joined and A never changed it since.
+  const uint8_t merged_channel_2 = is_ltp ? 100 : 200;
+  uint64_t frames      = 0;
+  uint64_t wrong       = 0;
+  uint64_t transitions = 0;
+  int      last_state  = -1;
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    if( size < 4 || ( frame[ 2 ] == 0 && frame[ 3 ] == 0 ) ) {
+      return;
+    }
+    int state = 0;
+    if( frame[ 2 ] == merged_channel_2 && frame[ 3 ] == 100 && frame[ 1 ] >= ( is_ltp ? 0 : 100 ) ) {
+      state = 1;
+    } else if( frame[ 2 ] == 200 && frame[ 3 ] == 0 ) {
+      state = 2;
+    }
+    frames++;
+    wrong       += ( state == 0 );
+    transitions += ( last_state != -1 && state != last_state );
+    last_state   = state;
+  };
+
+  harness.Run( events, is_a_stopping ? 1600000 : 100000 );
+  HostDMX::s_send_hook = nullptr;
+
+  uint64_t expected_transitions = is_b_stopping ? 2 : 1;
+  const ArtNetMerger::Stats& stats = harness.Node().GetMergeStats();
+  printf( "  %s, B %-5s%s : %llu frames, %llu changes between A alone and merged (%llu expected), %llu wrong; %u merged, %u unchanged, %u timeouts\n",
+          is_ltp ? "LTP" : "HTP", is_b_stopping ? "stops" : "stays", is_a_stopping ? ", A stops" : "         ", (unsigned long long)frames, (unsigned long long)transitions,
+          (unsigned long long)expected_transitions, (unsigned long long)wrong, stats.m_merged_frames, stats.m_unchanged_frames, stats.m_source_timeouts );
+  return wrong == 0 && transitions == expected_transitions;
+}
+
+int BenchMerge( const Arguments& arguments ) {
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 200000 );
+
+  // Frames that change every time for each source, or the first one repeated.
+  std::vector<uint8_t> packets[ 4 ];
+  uint8_t data[ 512 ];
+  uint8_t copy[ ARTNET_PACKET_MAXSIZE ];
+  uint64_t copies = 0;
+  for( int p = 0; p < 4; p++ ) {
+    for( int channel = 0; channel < 512; channel++ ) {
+      data[ channel ] = (uint8_t)( channel * 7 + p * 13 );
+    }
+    packets[ p ] = ReplayHarness::BuildArtDMX( 1, 1, data, 512 );
+  }
+
+  // MaxBytes() and ChangedBytes() against a byte at a time, over every pair of byte values in each lane.
+  uint64_t mismatches = 0;
+  for( uint32_t x = 0; x < 256; x++ ) {
+    for( uint32_t y = 0; y < 256; y++ ) {
+      uint32_t a = x | ( y << 8 ) | ( ( x ^ 0x5A ) << 16 ) | ( ( 255 - y ) << 24 );
+      uint32_t b = y | ( x << 8 ) | ( ( y ^ 0xA5 ) << 16 ) | ( ( 255 - x ) << 24 );
+      uint32_t merged  = ArtNetMerger::MaxBytes( a, b );
+      uint32_t changed = ArtNetMerger::ChangedBytes( a, b );
+      for( int lane = 0; lane < 32; lane += 8 ) {
+        uint32_t byte_a = ( a >> lane ) & 0xFF;
+        uint32_t byte_b = ( b >> lane ) & 0xFF;
+        mismatches += ( ( merged >> lane ) & 0xFF ) != std::max( byte_a, byte_b );
+        mismatches += ( ( changed >> lane ) & 0xFF ) != ( byte_a != byte_b ? 0xFFu : 0u );
+      }
+    }
+  }
+  printf( "merge: byte max and compare, %llu mismatches over all byte pairs\n", (unsigned long long)mismatches );
+
+  printf( "merge: 512 channel frames, ns per frame including the copy into the receive buffer\n" );
+  printf( "  copy only                : %6.1f\n", MeasureNs( [&]() {
+    memcpy( copy, packets[ copies++ & 3 ].data(), packets[ 0 ].size() );
+    KeepAlive( copy );
+  }, iterations ) );
+  printf( "  one source               : %6.1f\n", MeasureMerge( false, 1, packets, 4, iterations ) );
+  printf( "  two sources HTP, changed : %6.1f\n", MeasureMerge( false, 2, packets, 4, iterations ) );
+  printf( "  two sources LTP, changed : %6.1f\n", MeasureMerge( true, 2, packets, 4, iterations ) );
+  printf( "  two sources, unchanged   : %6.1f\n", MeasureMerge( false, 2, packets, 1, iterations ) );
+
+  printf( "merge: two consoles on universe 1 replayed for 4 s, 1 s merge timeout\n" );
+  bool is_ok = ( mismatches == 0 );
+  for( bool is_ltp : { false, true } ) {
+    for( bool is_b_stopping : { false, true } ) {
+      is_ok &= ReplayTwoSources( is_ltp, is_b_stopping, false );
+    }
+    is_ok &= ReplayTwoSources( is_ltp, true, true );
+  }
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// Art-Net parse throughput : ArtNetParser against the checks CheckForArtNetData()
+// used to make, a String built from the header ID and the packed struct fields
+// read as they came.
+
+#include <stdio.h>
+
+#include "ArtNetParser.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+// The previous header check and field decoding, kept only for comparison.
+static uint16_t LegacyParse( const uint8_t* buffer, size_t size ) {
+  if( size < ARTNET_PACKET_MINSIZE_HEADER ) {
+    return 0;
+  }
+  ArtNetPacketHeader* ptr_header = (ArtNetPacketHeader*)buffer;
+  String art_net = String( (char*)ptr_header->m_ID );
+  if( !art_net.equals( ARTNET_HEADER_ID ) || ptr_header->m_OpCode != ARTNET_OPCODE_DMX ) {
+    return 0;
+  }
+  ArtNetPacketDMX* ptr_packetdmx = (ArtNetPacketDMX*)&buffer[ ARTNET_PACKET_PAYLOAD_START ];
+  uint16_t universe_in        = ptr_packetdmx->m_SubUni | ptr_packetdmx->m_Net << 8;
+  uint16_t number_of_channels = ptr_packetdmx->m_Length | ptr_packetdmx->m_LengthHi << 8;
+  return universe_in + number_of_channels + ptr_packetdmx->m_Data[ 0 ];
+}
+
+static uint16_t Parse( const uint8_t* buffer, size_t size ) {
+  uint16_t      opcode = 0;
+  ArtNetDMXView dmx;
+  if( ArtNetParser::ParseHeader( buffer, size, opcode ) != ArtNetParser::PARSE_OK || opcode != ARTNET_OPCODE_DMX ||
+      ArtNetParser::ParseDMX( buffer, size, dmx ) != ArtNetParser::PARSE_OK ) {
+    return 0;
+  }
+  return dmx.universe + dmx.length + dmx.data[ 0 ];
+}
+
+int BenchParser( const Arguments& arguments ) {
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 2000000 );
+
+  uint8_t data[ 512 ] = {};
+  std::vector<uint8_t> packets[ 4 ];
+  for( int p = 0; p < 4; p++ ) {
+    packets[ p ] = ReplayHarness::BuildArtDMX( p + 1, p + 1, data, 512 );
+  }
+
+  printf( "parse: ArtDMX header and fields, %llu packets\n", (unsigned long long)iterations );
+
+  uint64_t index = 0;
+  uint32_t sum   = 0;
+  double legacy_ns = MeasureNs( [&]() {
+    const std::vector<uint8_t>& packet = packets[ index++ & 3 ];
+    sum += LegacyParse( packet.data(), packet.size() );
+  }, iterations );
+  double parser_ns = MeasureNs( [&]() {
+    const std::vector<uint8_t>& packet = packets[ index++ & 3 ];
+    sum += Parse( packet.data(), packet.size() );
+  }, iterations );
+  KeepAlive( sum );
+
+  printf( "  String header check : %7.1f ns/packet, %6.1f M packets/s\n", legacy_ns, 1e3 / legacy_ns );
+  printf( "  ArtNetParser        : %7.1f ns/packet, %6.1f M packets/s\n", parser_ns, 1e3 / parser_ns );
+  return 0;
+}
@@ -0,0 +1,210 @@
+// ArtPoll : a controller polls the node every 1.5 s while it receives one of
+// its two universes, and a second one asks to hear of changes before the
+// Art-Net stops.  The node only takes ArtDMX from the source sending it, which
+// mustn't stop other controllers polling it.  A small poller decodes every
+// ArtPollReply from the spec's byte offsets, checks each field and the random
+// back-off, and the cost of building the replies is set against bringing them
+// up to date.
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include "HostNetwork.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static const uint16_t UNIVERSE_PATCHED = 5;
+static const uint16_t UNIVERSE_MAIN    = 0x123;    // Net 1, sub-net 2, universe 3.
+
+// An ArtPollReply as a controller reads it, by the spec's offsets rather than the node's struct.
+struct DecodedReply {
+  bool     m_is_valid;
+  IPAddress m_ip;
+  uint16_t m_port;
+  uint16_t m_universe;
+  uint8_t  m_good_output;
+  uint8_t  m_bind_index;
+  uint8_t  m_status2;
+  uint8_t  m_mac[ 6 ];
+  uint16_t m_report_code;
+  uint16_t m_report_counter;
+  char     m_report[ 65 ];
+  char     m_short_name[ 19 ];
+};
+
+static DecodedReply Decode( const std::vector<uint8_t>& data ) {
+  DecodedReply reply = {};
+  if( data.size() != 239 || memcmp( data.data(), "Art-Net\0", 8 ) != 0 || data[ 8 ] != 0x00 || data[ 9 ] != 0x21 ) {
+    return reply;
+  }
+  reply.m_ip          = IPAddress( data[ 10 ], data[ 11 ], data[ 12 ], data[ 13 ] );
+  reply.m_port        = data[ 14 ] | data[ 15 ] << 8;
+  reply.m_universe    = ( data[ 18 ] & 0x7F ) << 8 | ( data[ 19 ] & 0x0F ) << 4 | ( data[ 190 ] & 0x0F );
+  reply.m_good_output = data[ 182 ];
+  reply.m_bind_index  = data[ 211 ];
+  reply.m_status2     = data[ 212 ];
+  memcpy( reply.m_mac, &data[ 201 ], 6 );
+  memcpy( reply.m_short_name, &data[ 26 ], 18 );
+  memcpy( reply.m_report, &data[ 108 ], 64 );
+  unsigned code = 0, counter = 0;
+  bool is_ip_bound = memcmp( &data[ 10 ], &data[ 207 ], 4 ) == 0;
+  bool is_fillers_zero = std::all_of( data.begin() + 229, data.end(), []( uint8_t byte ) { return byte == 0; } );
+  reply.m_is_valid = sscanf( reply.m_report, "#%4x [%4u]", &code, &counter ) == 2 && data[ 173 ] == 1 && data[ 174 ] == 0x80 &&
+                     is_ip_bound && is_fillers_zero;
+  reply.m_report_code    = code;
+  reply.m_report_counter = counter;
+  return reply;
+}
+
+static ReplayHarness::Event MakeEvent( uint64_t time_us, const std::vector<uint8_t>& data, IPAddress source_ip ) {
+  ReplayHarness::Event event;
+  event.m_time_us    = time_us;
+  event.m_data       = data;
+  event.m_source_ip  = source_ip;
+  event.m_local_port = ARTNET_UDP_PORT;
+  event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+  return event;
+}
+
+static std::vector<uint8_t> BuildArtPoll( uint8_t flags ) {
+  std::vector<uint8_t> data = { 'A', 'r', 't', '-', 'N', 'e', 't', 0, 0x00, 0x20, 0, ARTNET_VERSION, flags, 0 };
+  return data;
+}
+
+// Build() against the patch calls UpdatePollReply() makes with nothing changed.
+static void MeasureCost( uint64_t iterations ) {
+  std::vector<uint16_t> universes = { UNIVERSE_PATCHED, UNIVERSE_MAIN };
+  ArtNetPollResponder::NodeInfo info = { IPAddress( 192, 168, 1, 1 ), { 2, 0, 0, 0, 0, 1 }, true, true, "ESP32-Artnet2DMX", "ESP32-Artnet2DMX" };
+  ArtNetPollResponder responder;
+
+  double build_ns = MeasureNs( [&]() {
+    responder.Build( info, universes );
+    KeepAlive( responder );
+  }, iterations );
+
+  double update_ns = MeasureNs( [&]() {
+    responder.SetPortState( 0, ArtNetPollResponder::OUTPUT_TRANSMITTING );
+    responder.SetPortState( 1, 0 );
+    responder.SetNodeReport( ArtNetPollResponder::REPORT_POWER_OK, "Receiving 1 of 2 universes" );
+    responder.SetIPAddress( info.ip, true );
+    KeepAlive( responder );
+  }, iterations );
+
+  printf( "  ns for both replies  : build %.0f, bring up to date with nothing changed %.0f\n", build_ns, update_ns );
+}
+
+int BenchPoll( const Arguments& arguments ) {
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 100000 );
+  uint32_t polls      = (uint32_t)arguments.Number( "polls", 40 );
+
+  const IPAddress controller( 192, 168, 1, 50 );
+  const IPAddress watcher( 192, 168, 1, 60 );
+
+  // Universe 0x123 arrives until 2 s before the end, then the 1 s Art-Net timeout blacks out.
+  std::vector<ReplayHarness::Event> events;
+  uint8_t data[ 512 ] = { 1, 2, 3 };
+  uint64_t end_us      = 1000000 + polls * 1500000ull;
+  uint64_t stop_us     = end_us - 2000000;
+  uint64_t blackout_us = stop_us + 1000000;
+  for( uint64_t time_us = 50000; time_us < stop_us; time_us += 25000 ) {
+    events.push_back( MakeEvent( time_us, ReplayHarness::BuildArtDMX( UNIVERSE_MAIN, 0, data, sizeof( data ) ), IPAddress( 192, 168, 1, 100 ) ) );
+  }
+  std::vector<uint64_t> poll_us;
+  for( uint32_t i = 0; i < polls; i++ ) {
+    poll_us.push_back( 1000000 + i * 1500000ull );
+    events.push_back( MakeEvent( poll_us.back(), BuildArtPoll( 0x00 ), controller ) );
+  }
+  events.push_back( MakeEvent( 1200000, BuildArtPoll( 0x02 ), watcher ) );
+  std::stable_sort( events.begin(), events.end(), []( const ReplayHarness::Event& a, const ReplayHarness::Event& b ) {
+    return a.m_time_us < b.m_time_us;
+  } );
+
+  char config[ 384 ];
+  snprintf( config, sizeof( config ),
+            "{\"artnet_source_ip\":\"192.168.1.100\",\"artnet_universe\":%u,\"artnet_timeout_ms\":1000,\"dmx_update_interval_ms\":23,"
+            "\"artnet_universe_slices\":[{\"universe\":%u,\"input_channel\":1,\"output_channel\":101,\"count\":100,\"port\":0}]}",
+            UNIVERSE_MAIN, UNIVERSE_PATCHED );
+
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( config );
+  HostNetwork::s_sent.clear();
+  uint64_t start_us = HostClock::NowMicros();
+  harness.Run( events, 500000 );
+
+  printf( "poll: %u ArtPolls 1.5 s apart from %s, a second controller watching for changes\n", polls, controller.toString().c_str() );
+
+  // The controller's replies : both universes, each poll answered once within the back-off.
+  bool is_ok = true;
+  std::vector<uint64_t> delays_us;
+  uint32_t watcher_replies = 0;
+  uint16_t last_counter    = 0;
+  bool     is_watcher_told_of_timeout = false;
+  for( const HostNetwork::Sent& sent : HostNetwork::s_sent ) {
+    if( sent.m_remote_port != ARTNET_UDP_PORT ) {
+      continue;
+    }
+    DecodedReply reply = Decode( sent.m_data );
+    bool is_expected_universe = ( reply.m_bind_index == 1 && reply.m_universe == UNIVERSE_PATCHED ) ||
+                                ( reply.m_bind_index == 2 && reply.m_universe == UNIVERSE_MAIN );
+    if( !reply.m_is_valid || !is_expected_universe || reply.m_ip != IPAddress( 192, 168, 1, 1 ) || reply.m_port != ARTNET_UDP_PORT ||
+        reply.m_mac[ 5 ] != 0x01 || strcmp( reply.m_short_name, "ESP32-Artnet2DMX" ) != 0 || reply.m_report_code != 0x0001 ) {
+      printf( "  bad reply to %s : %s\n", sent.m_remote_ip.toString().c_str(), reply.m_report );
+      is_ok = false;
+      continue;
+    }
+    // Both replies of a poll carry the same counter, one more than the last poll's.
+    if( reply.m_bind_index == 1 ) {
+      is_ok &= ( reply.m_report_counter == last_counter + 1 );
+      last_counter = reply.m_report_counter;
+    }
+
+    uint64_t time_us = sent.m_time_us - start_us;
+    if( sent.m_remote_ip == watcher ) {
+      watcher_replies++;
+      bool is_blacked_out = strstr( reply.m_report, "timed out" ) != nullptr;
+      if( reply.m_bind_index == 2 && is_blacked_out ) {
+        is_watcher_told_of_timeout = ( reply.m_good_output & ArtNetPollResponder::OUTPUT_TRANSMITTING ) == 0;
+      }
+      continue;
+    }
+    if( sent.m_remote_ip != controller ) {
+      is_ok = false;
+      continue;
+    }
+    if( reply.m_bind_index != 2 ) {
+      continue;
+    }
+    // The poll this answers is the last one before it.
+    auto poll = std::upper_bound( poll_us.begin(), poll_us.end(), time_us );
+    if( poll == poll_us.begin() ) {
+      is_ok = false;
+      continue;
+    }
+    delays_us.push_back( time_us - *( poll - 1 ) );
+
+    // Universe 0x123 is live until the timeout blacks it out.
+    bool is_live = ( reply.m_good_output & ArtNetPollResponder::OUTPUT_TRANSMITTING ) != 0;
+    if( time_us + 50000 < blackout_us || time_us > blackout_us + 50000 ) {
+      is_ok &= ( is_live == ( time_us < blackout_us ) );
+    }
+  }
+
+  std::sort( delays_us.begin(), delays_us.end() );
+  const ArtNetPollResponder::Stats& stats = harness.Node().GetPollResponder().GetStats();
+  printf( "  %zu polls answered, back-off %.0f - %.0f ms (median %.0f), %u replies sent, %u to the watcher, %u on change\n",
+          delays_us.size(), delays_us.empty() ? 0.0 : delays_us.front() / 1e3, delays_us.empty() ? 0.0 : delays_us.back() / 1e3,
+          delays_us.empty() ? 0.0 : delays_us[ delays_us.size() / 2 ] / 1e3, stats.m_replies, watcher_replies, stats.m_change_replies );
+  printf( "  fields patched %u times; watcher told of the timeout : %s\n", stats.m_patches, is_watcher_told_of_timeout ? "yes" : "no" );
+
+  // Every poll answered once, within the spec's window, and spread over it.
+  is_ok &= delays_us.size() == polls && !delays_us.empty() && delays_us.back() <= ArtNetPollResponder::MAX_DELAY_US + 1000 &&
+           delays_us.front() < ArtNetPollResponder::MAX_DELAY_US / 4 && delays_us.back() > ArtNetPollResponder::MAX_DELAY_US * 3 / 4;
+  is_ok &= is_watcher_told_of_timeout && stats.m_change_replies > 0 && harness.Node().GetReceiveStats().m_dropped_source_ip == 0;
+
+  MeasureCost( iterations );
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
@@ -0,0 +1,380 @@
+// Routing benchmark : the compiled DMXRouter against the per-packet walk over
+// m_dmx_routing_configs it replaced, for 1, 64 and 512 routes, then each merge
+// operator checked against a channel at a time reference and timed, and a
+// large patch as a block route against one route per channel.
+
+#include <stdio.h>
+#include <string.h>
+#include <random>
+
+#include "DMXRouter.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+// Routes as they were stored before DMXRoutingTable, one heap vector each.
+struct LegacyRoutingConfig {
+  uint16_t              input_channel;
+  std::vector<uint16_t> output_channels;
+};
+
+// The routing loop as HandleArtNetDMX ran it before routes were compiled.
+static void LegacyApplyRouting( const std::vector<LegacyRoutingConfig>& routing_configs, const uint8_t* data, uint16_t number_of_channels, uint8_t* dmx_buffer ) {
+  for( const LegacyRoutingConfig& config : routing_configs ) {
+    if( config.input_channel <= number_of_channels ) {
+      uint8_t value = data[ config.input_channel - 1 ];
+      for( auto output_channel : config.output_channels ) {
+        if( output_channel > 0 && output_channel < 513 ) {
+          if( dmx_buffer[ output_channel ] == 0 ) {
+            dmx_buffer[ output_channel ] = value;
+          } else {
+            dmx_buffer[ output_channel ] = std::max( dmx_buffer[ output_channel ], value );
+          }
+        }
+      }
+    }
+  }
+}
+
+static std::vector<LegacyRoutingConfig> MakeRoutes( int routes, int outputs_per_route ) {
+  std::vector<LegacyRoutingConfig> routing_configs;
+  for( int i = 0; i < routes; i++ ) {
+    LegacyRoutingConfig config;
+    config.input_channel = ( i % 512 ) + 1;
+    for( int j = 0; j < outputs_per_route; j++ ) {
+      config.output_channels.push_back( ( ( i * 7 + j * 61 ) % 512 ) + 1 );
+    }
+    routing_configs.push_back( config );
+  }
+  return routing_configs;
+}
+
+// One operator at a time with a switch, route by route in table order, as the
+// merge operators are defined.
+static uint8_t ReferenceMerge( uint8_t merge_operator, uint8_t value, uint8_t input ) {
+  switch( merge_operator ) {
+    case DMX_MERGE_HTP:      return std::max( value, input );
+    case DMX_MERGE_LTP:      return input;
+    case DMX_MERGE_ADD:      return (uint8_t)std::min( 255, value + input );
+    case DMX_MERGE_SCALE:    return (uint8_t)( ( value * input + 127 ) / 255 );
+    case DMX_MERGE_PRIORITY: return input ? input : value;
+  }
+  return value;
+}
+
+static void ReferenceApply( const DMXRoutingTable& routing_table, bool is_through, const uint8_t* data, uint16_t number_of_channels,
+                            const uint8_t* through, uint8_t* dmx_buffer ) {
+  // ( output, input ) for each route, blocks expanded.
+  std::vector<std::vector<std::pair<uint16_t, uint16_t>>> route_links( routing_table.Size() );
+  bool is_routed[ 513 ] = {};
+  for( size_t i = 0; i < routing_table.Size(); i++ ) {
+    const DMXRoutingConfig& config = routing_table.GetRoute( i );
+    for( uint16_t k = 0; k < config.input_count && config.input_channel + k <= 512; k++ ) {
+      for( uint16_t j = 0; j < config.output_count; j++ ) {
+        uint32_t channel = routing_table.GetOutputChannels( i )[ j ] + k * config.output_stride;
+        if( channel >= 1 && channel <= 512 ) {
+          route_links[ i ].push_back( std::make_pair( (uint16_t)channel, (uint16_t)( config.input_channel + k ) ) );
+          is_routed[ channel ] = true;
+        }
+      }
+    }
+    std::sort( route_links[ i ].begin(), route_links[ i ].end() );
+    route_links[ i ].erase( std::unique( route_links[ i ].begin(), route_links[ i ].end() ), route_links[ i ].end() );
+  }
+  for( uint16_t channel = 1; channel <= 512; channel++ ) {
+    if( is_routed[ channel ] ) {
+      dmx_buffer[ channel ] = is_through ? through[ channel ] : 0;
+    }
+  }
+  for( size_t i = 0; i < routing_table.Size(); i++ ) {
+    for( const auto& link : route_links[ i ] ) {
+      if( link.second <= number_of_channels ) {
+        dmx_buffer[ link.first ] = ReferenceMerge( routing_table.GetRoute( i ).merge_operator, dmx_buffer[ link.first ], data[ link.second - 1 ] );
+      }
+    }
+  }
+}
+
+// Random tables mixing every operator, single channels and blocks, through and
+// not, against ReferenceApply().
+static uint64_t CheckOperators( uint64_t tables ) {
+  std::mt19937 random( 1 );
+  uint64_t mismatches = 0;
+
+  for( uint32_t value = 0; value < 256; value++ ) {
+    for( uint32_t input = 0; input < 256; input++ ) {
+      for( uint8_t merge_operator = 0; merge_operator < DMX_MERGE_MAX; merge_operator++ ) {
+        mismatches += DMXRouter::Merge( merge_operator, value, input ) != ReferenceMerge( merge_operator, value, input );
+      }
+    }
+  }
+
+  uint8_t data[ 512 ];
+  uint8_t through[ 513 ];
+  std::vector<uint16_t> output_channels;
+  for( uint64_t t = 0; t < tables; t++ ) {
+    DMXRoutingTable routing_table;
+    int routes = 1 + random() % ( ( t & 1 ) ? 64 : 6 );
+    for( int i = 0; i < routes; i++ ) {
+      output_channels.clear();
+      uint8_t merge_operator = random() % DMX_MERGE_MAX;
+      if( random() % 3 == 0 ) {
+        // A block, sometimes running off the end of the channels.
+        output_channels.push_back( 1 + random() % 512 );
+        routing_table.Add( 1 + random() % 512, output_channels, merge_operator, 1 + random() % 128, ( random() & 1 ) ? 1 : 1 + random() % 4 );
+        continue;
+      }
+      int outputs = 1 + random() % 4;
+      for( int j = 0; j < outputs; j++ ) {
+        // Few distinct outputs, so that routes pile up on the same channels.
+        output_channels.push_back( 1 + random() % 48 );
+      }
+      routing_table.Add( 1 + random() % 64, output_channels, merge_operator );
+    }
+    for( uint8_t& byte : data ) {
+      byte = ( random() % 4 == 0 ) ? 0 : random();
+    }
+    for( uint8_t& byte : through ) {
+      byte = random();
+    }
+    bool     is_through         = random() & 1;
+    uint16_t number_of_channels = ( random() & 1 ) ? 512 : 1 + random() % 512;
+
+    DMXRouter router;
+    router.Compile( routing_table, is_through );
+
+    uint8_t reference_buffer[ 513 ];
+    uint8_t compiled_buffer[ 513 ];
+    memset( reference_buffer, 0xAA, sizeof( reference_buffer ) );
+    memset( compiled_buffer, 0xAA, sizeof( compiled_buffer ) );
+    ReferenceApply( routing_table, is_through, data, number_of_channels, through, reference_buffer );
+    router.Apply( data, number_of_channels, through, compiled_buffer );
+    mismatches += memcmp( reference_buffer, compiled_buffer, sizeof( reference_buffer ) ) != 0;
+  }
+  return mismatches;
+}
+
+// Channels 1 - 256 patched to 257 - 512 : the legacy walk over one route per
+// channel, the same routes compiled (merged per link with HTP, copied as a
+// block with LTP), and a single block route.
+static void BenchPatch( const uint8_t* data, const uint8_t* through, uint64_t iterations ) {
+  const uint16_t count = 256;
+  std::vector<LegacyRoutingConfig> routing_configs;
+  DMXRoutingTable htp_table;
+  DMXRoutingTable ltp_table;
+  DMXRoutingTable block_table;
+  for( uint16_t i = 0; i < count; i++ ) {
+    routing_configs.push_back( { (uint16_t)( i + 1 ), { (uint16_t)( count + i + 1 ) } } );
+    htp_table.Add( i + 1, routing_configs.back().output_channels, DMX_MERGE_HTP );
+    ltp_table.Add( i + 1, routing_configs.back().output_channels, DMX_MERGE_LTP );
+  }
+  uint16_t input_channel = 0, input_count = 0, output_channel = 0;
+  uint8_t  output_stride = 0;
+  DMXRoutingTable::ParseBlock( "1-256 > 257-512", input_channel, input_count, output_channel, output_stride );
+  block_table.Add( input_channel, { output_channel }, DMX_MERGE_LTP, input_count, output_stride );
+
+  printf( "routing: channels 1 - 256 to 257 - 512, 512 channel packet\n" );
+  printf( "  %-28s %6s %11s %6s %8s\n", "form", "routes", "table bytes", "blocks", "ns/pkt" );
+
+  uint8_t dmx_buffer[ 513 ] = {};
+  double legacy_ns = MeasureNs( [&]() {
+    LegacyApplyRouting( routing_configs, data, 512, dmx_buffer );
+    KeepAlive( dmx_buffer );
+  }, iterations );
+  printf( "  %-28s %6u %11zu %6s %8.1f\n", "per channel, legacy", count, count * ( sizeof( LegacyRoutingConfig ) + sizeof( uint16_t ) ), "-", legacy_ns );
+
+  const std::pair<const char*, const DMXRoutingTable*> tables[] = {
+    { "per channel, HTP", &htp_table }, { "per channel, LTP", &ltp_table }, { "one block route, LTP", &block_table } };
+  for( const auto& table : tables ) {
+    DMXRouter router;
+    router.Compile( *table.second );
+    double ns = MeasureNs( [&]() {
+      router.Apply( data, 512, through, dmx_buffer );
+      KeepAlive( dmx_buffer );
+    }, iterations );
+    size_t table_bytes = table.second->Size() * ( sizeof( DMXRoutingConfig ) + sizeof( uint16_t ) );
+    printf( "  %-28s %6zu %11zu %6zu %8.1f\n", table.first, table.second->Size(), table_bytes, router.GetBlockCount(), ns );
+  }
+}
+
+// "first-last > output" and its variants, blocks out of range refused, and
+// FormatBlock() reading back the same.
+static bool CheckBlockSyntax() {
+  struct Case {
+    const char* m_block_str;
+    bool        m_is_valid;
+    uint16_t    m_input_channel, m_input_count, m_output_channel;
+    uint8_t     m_output_stride;
+  };
+  const Case cases[] = {
+    { "1-100 > 201-300",             true,  1,   100, 201, 1 },
+    { " 1-100>201 ",                 true,  1,   100, 201, 1 },
+    { "1-100 > 413",                 true,  1,   100, 413, 1 },
+    { "1-10 > 1/3",                  true,  1,   10,  1,   3 },
+    { "1-10 > 1-28/3",               true,  1,   10,  1,   3 },
+    { "1-100 \xE2\x86\x92 201-300", false, 0,   0,   0,   0 },   // One spelling of the arrow only.
+    { "1-100 -> 201-300",            false, 0,   0,   0,   0 },
+    { "1-100 > 451",                 false, 0,   0,   0,   0 },   // Past channel 512.
+    { "1-100 > 201-250",             false, 0,   0,   0,   0 },   // Ending short of the inputs.
+    { "1-10 > 500/3",                false, 0,   0,   0,   0 },
+    { "1-100",                       false, 0,   0,   0,   0 },
+    { "0-100 > 1",                   false, 0,   0,   0,   0 },
+    { "100-1 > 1",                   false, 0,   0,   0,   0 },
+    { "1-100 > 1/0",                 false, 0,   0,   0,   0 },
+    { "1-513 > 1",                   false, 0,   0,   0,   0 },
+  };
+
+  bool is_ok = true;
+  for( const Case& test : cases ) {
+    uint16_t input_channel = 0, input_count = 0, output_channel = 0;
+    uint8_t  output_stride = 0;
+    bool is_valid = DMXRoutingTable::ParseBlock( test.m_block_str, input_channel, input_count, output_channel, output_stride );
+    bool is_case_ok = ( is_valid == test.m_is_valid );
+    if( is_valid && is_case_ok ) {
+      is_case_ok = input_channel == test.m_input_channel && input_count == test.m_input_count && output_channel == test.m_output_channel &&
+                   output_stride == test.m_output_stride;
+      // Formatted and parsed again, the block stays the same.
+      DMXRoutingTable routing_table;
+      routing_table.Add( input_channel, { output_channel }, DMX_MERGE_LTP, input_count, output_stride );
+      String block_str = routing_table.FormatBlock( 0 );
+      is_case_ok &= DMXRoutingTable::ParseBlock( block_str, input_channel, input_count, output_channel, output_stride ) &&
+                    input_channel == test.m_input_channel && input_count == test.m_input_count && output_channel == test.m_output_channel &&
+                    output_stride == test.m_output_stride;
+    }
+    if( !is_case_ok ) {
+      printf( "  block \"%s\" read wrongly\n", test.m_block_str );
+    }
+    is_ok &= is_case_ok;
+  }
+  return is_ok;
+}
+
+// Through the node : channel 1 overrides channel 2 with LTP, so a route lowers
+// a channel, and adds to channel 3, and channels 1 - 4 are copied to 9 - 12 as
+// a block.  Routed only, channel 4 isn't sent.
+static bool CheckNodeRouting( bool is_routing_only ) {
+  char config[ 512 ];
+  snprintf( config, sizeof( config ),
+            "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+            "\"dmx_routing_only\":%s,\"dmx_routing_configs\":[{\"input_channel\":1,\"output_channels\":[2],\"merge\":\"ltp\"},"
+            "{\"input_channel\":1,\"output_channels\":[3],\"merge\":\"add\"},{\"block\":\"1-4 > 9-12\",\"merge\":\"ltp\"}]}",
+            is_routing_only ? "true" : "false" );
+
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( config );
+
+  uint8_t data[ 512 ] = { 10, 200, 50, 77 };
+  std::vector<ReplayHarness::Event> events;
+  for( uint64_t time_us = 50000; time_us < 500000; time_us += 25000 ) {
+    ReplayHarness::Event event;
+    event.m_time_us    = time_us;
+    event.m_data       = ReplayHarness::BuildArtDMX( 1, 0, data, 512 );
+    event.m_source_ip  = IPAddress( 192, 168, 1, 100 );
+    event.m_local_port = ARTNET_UDP_PORT;
+    event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+    events.push_back( event );
+  }
+
+  uint8_t last_frame[ 13 ] = {};
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    memcpy( last_frame, frame, std::min( size, sizeof( last_frame ) ) );
+  };
+  harness.Run( events, 100000 );
+  HostDMX::s_send_hook = nullptr;
+
+  // Channel 3 : 50 + 10 through, 0 + 10 routed only.  Channel 1 isn't routed to.
+  const uint8_t expected[ 13 ] = { 0, (uint8_t)( is_routing_only ? 0 : 10 ), 10, (uint8_t)( is_routing_only ? 10 : 60 ), (uint8_t)( is_routing_only ? 0 : 77 ),
+                                   0, 0, 0, 0, 10, 200, 50, 77 };
+  bool is_ok = memcmp( last_frame, expected, sizeof( expected ) ) == 0;
+  printf( "  node, %-13s : channels 1 - 4 sent as %u %u %u %u, 9 - 12 as %u %u %u %u, %s\n", is_routing_only ? "routed only" : "through",
+          last_frame[ 1 ], last_frame[ 2 ], last_frame[ 3 ], last_frame[ 4 ], last_frame[ 9 ], last_frame[ 10 ], last_frame[ 11 ], last_frame[ 12 ],
+          is_ok ? "as expected" : "WRONG" );
+  return is_ok;
+}
+
+int BenchRouting( const Arguments& arguments ) {
+  uint64_t iterations        = (uint64_t)arguments.Number( "iterations", 20000 );
+  int      outputs_per_route = (int)arguments.Number( "outputs", 2 );
+
+  uint8_t data[ 512 ];
+  for( int i = 0; i < 512; i++ ) {
+    data[ i ] = (uint8_t)( i * 37 );
+  }
+  // The packet straight through, as the node's routes start from it.
+  uint8_t through[ 513 ] = {};
+  memcpy( &through[ 1 ], data, 512 );
+
+  printf( "routing: %d output(s) per route, 512 channel packet\n", outputs_per_route );
+  printf( "  %6s %8s %14s %14s %8s\n", "routes", "links", "legacy ns/pkt", "compiled ns/pkt", "speedup" );
+
+  const int route_counts[] = { 1, 64, 512 };
+  for( int routes : route_counts ) {
+    std::vector<LegacyRoutingConfig> routing_configs = MakeRoutes( routes, outputs_per_route );
+
+    DMXRoutingTable routing_table;
+    for( const LegacyRoutingConfig& config : routing_configs ) {
+      routing_table.Add( config.input_channel, config.output_channels );
+    }
+
+    DMXRouter router;
+    router.Compile( routing_table );
+
+    uint8_t legacy_buffer[ 513 ];
+    uint8_t compiled_buffer[ 513 ];
+
+    // Same result from both, starting from the straight-through copy.
+    memset( legacy_buffer, 0, sizeof( legacy_buffer ) );
+    memcpy( &legacy_buffer[ 1 ], data, 512 );
+    memcpy( compiled_buffer, legacy_buffer, sizeof( compiled_buffer ) );
+    LegacyApplyRouting( routing_configs, data, 512, legacy_buffer );
+    router.Apply( data, 512, through, compiled_buffer );
+    if( memcmp( legacy_buffer, compiled_buffer, sizeof( legacy_buffer ) ) != 0 ) {
+      printf( "  %6d MISMATCH between legacy and compiled routing\n", routes );
+      return 1;
+    }
+
+    double legacy_ns = MeasureNs( [&]() {
+      LegacyApplyRouting( routing_configs, data, 512, legacy_buffer );
+      KeepAlive( legacy_buffer );
+    }, iterations );
+
+    double compiled_ns = MeasureNs( [&]() {
+      router.Apply( data, 512, through, compiled_buffer );
+      KeepAlive( compiled_buffer );
+    }, iterations );
+
+    printf( "  %6d %8zu %14.1f %14.1f %7.1fx\n", routes, router.GetLinkCount(), legacy_ns, compiled_ns, legacy_ns / compiled_ns );
+  }
+
+  uint64_t mismatches = CheckOperators( 2000 );
+  printf( "routing: merge operators, %llu mismatches against the reference over all byte pairs and 2000 random tables\n", (unsigned long long)mismatches );
+
+  // 512 routes all with one operator, then with all of them in turn.
+  std::vector<LegacyRoutingConfig> routing_configs = MakeRoutes( 512, outputs_per_route );
+  printf( "  %-10s %14s\n", "operator", "ns/pkt" );
+  for( int merge_operator = 0; merge_operator <= DMX_MERGE_MAX; merge_operator++ ) {
+    DMXRoutingTable routing_table;
+    for( size_t i = 0; i < routing_configs.size(); i++ ) {
+      uint8_t route_operator = ( merge_operator == DMX_MERGE_MAX ) ? i % DMX_MERGE_MAX : merge_operator;
+      routing_table.Add( routing_configs[ i ].input_channel, routing_configs[ i ].output_channels, route_operator );
+    }
+    DMXRouter router;
+    router.Compile( routing_table );
+    uint8_t dmx_buffer[ 513 ] = {};
+    double ns = MeasureNs( [&]() {
+      router.Apply( data, 512, through, dmx_buffer );
+      KeepAlive( dmx_buffer );
+    }, iterations );
+    printf( "  %-10s %14.1f\n", ( merge_operator == DMX_MERGE_MAX ) ? "mixed" : DMXRoutingTable::GetMergeOperatorName( merge_operator ), ns );
+  }
+
+  BenchPatch( data, through, iterations );
+
+  bool is_ok = ( mismatches == 0 );
+  is_ok &= CheckBlockSyntax();
+  is_ok &= CheckNodeRouting( false );
+  is_ok &= CheckNodeRouting( true );
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+// sACN : a console sends universe 1 over sACN while a second controller sends
+// universe 2 over Art-Net.  A backup console takes over at a higher priority
+// and then terminates its stream, a third source merges at the same priority
+// and then goes silent, a visualiser sends preview data, a few packets arrive
+// out of order and a universe the node doesn't want is multicast and unicast.
+// The stream is written to a capture and replayed from it, the DMX output of
+// both ports is checked along the way, and the cost of an sACN packet is set
+// against an ArtDMX packet.
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#include "HostNetwork.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static const uint32_t SOURCE_INTERVAL_US = 25000;   // 40 Hz
+static const IPAddress NODE_IP( 192, 168, 1, 1 );
+
+struct Source {
+  uint8_t   m_cid[ 16 ];
+  IPAddress m_ip;
+  uint8_t   m_priority;
+  uint8_t   m_options;
+  uint8_t   m_sequence;
+  uint8_t   m_data[ 512 ];
+};
+
+static ReplayHarness::Event MakeSACN( uint64_t time_us, Source& source, uint16_t universe, IPAddress destination ) {
+  ReplayHarness::Event event;
+  event.m_time_us    = time_us;
+  event.m_data       = ReplayHarness::BuildE131( source.m_cid, universe, source.m_priority, source.m_sequence++, source.m_options, source.m_data, 512 );
+  event.m_source_ip  = source.m_ip;
+  event.m_local_port = E131_UDP_PORT;
+  event.m_local_ip   = destination;
+  return event;
+}
+
+// Source sends universe 1 at 40 Hz over [start_us, end_us).
+static void AddStream( std::vector<ReplayHarness::Event>& events, Source& source, uint64_t start_us, uint64_t end_us ) {
+  for( uint64_t time_us = start_us; time_us < end_us; time_us += SOURCE_INTERVAL_US ) {
+    events.push_back( MakeSACN( time_us, source, 1, IPAddress( 239, 255, 0, 1 ) ) );
+  }
+}
+
+static Source MakeSource( uint8_t id, uint8_t priority, std::initializer_list<uint8_t> channels ) {
+  Source source = {};
+  memset( source.m_cid, id, sizeof( source.m_cid ) );
+  source.m_ip       = IPAddress( 192, 168, 1, 100 + id );
+  source.m_priority = priority;
+  source.m_sequence = 250;    // Wraps through 0 early on.
+  std::copy( channels.begin(), channels.end(), source.m_data );
+  return source;
+}
+
+// sACN packet against ArtDMX packet, each parsed and checked against its source.
+static void MeasureCost( uint64_t iterations ) {
+  Source source = MakeSource( 1, 100, { 1, 2, 3 } );
+  std::vector<uint8_t> sacn   = ReplayHarness::BuildE131( source.m_cid, 1, 100, 0, 0, source.m_data, 512 );
+  std::vector<uint8_t> artnet = ReplayHarness::BuildArtDMX( 1, 1, source.m_data, 512 );
+
+  E131SourceTracker source_tracker;
+  source_tracker.Reset( 1 );
+  uint8_t  sequence = 0;
+  uint32_t now_ms   = 0;
+  double sacn_ns = MeasureNs( [&]() {
+    sacn[ E131_OFFSET_SEQUENCE ] = sequence++;
+    E131DataView view;
+    uint32_t source_id;
+    E131SourceTracker::Dropped dropped;
+    bool is_ok = E131Parser::Parse( sacn.data(), sacn.size(), view ) == E131Parser::PARSE_OK &&
+                 source_tracker.Check( 0, view, now_ms++ / 16, source_id, dropped ) == E131SourceTracker::SOURCE_ACCEPTED;
+    KeepAlive( is_ok );
+  }, iterations );
+
+  ArtNetSequenceTracker sequence_tracker;
+  sequence_tracker.Reset( 1 );
+  sequence = 1;
+  double artnet_ns = MeasureNs( [&]() {
+    artnet[ 12 ] = sequence;
+    sequence = sequence == 255 ? 1 : sequence + 1;
+    ArtNetDMXView dmx;
+    uint8_t missed;
+    bool is_ok = ArtNetParser::ParseDMX( artnet.data(), artnet.size(), dmx ) == ArtNetParser::PARSE_OK &&
+                 sequence_tracker.Check( 0, 0x6401A8C0, dmx.sequence, now_ms++ / 16, missed ) != ArtNetSequenceTracker::SEQUENCE_STALE;
+    KeepAlive( is_ok );
+  }, iterations );
+
+  printf( "  ns to parse and check the source : sACN %.0f, ArtDMX %.0f\n", sacn_ns, artnet_ns );
+}
+
+int BenchSACN( const Arguments& arguments ) {
+  uint64_t    iterations = (uint64_t)arguments.Number( "iterations", 200000 );
+  std::string path       = arguments.Text( "pcap", "/tmp/artnet_replay_sacn.pcap" );
+
+  Source console   = MakeSource( 1, 100, { 50, 60 } );
+  Source backup    = MakeSource( 2, 150, { 200, 0, 9 } );
+  Source merging   = MakeSource( 3, 100, { 80, 0, 0, 7 } );
+  Source preview   = MakeSource( 4, 200, { 255, 255, 255, 255 } );
+  Source unwanted  = MakeSource( 5, 100, { 1 } );
+  preview.m_options = E131_OPTION_PREVIEW;
+
+  std::vector<ReplayHarness::Event> events;
+  AddStream( events, console, 0, 8000000 );
+  AddStream( events, backup, 1000000 + 5000, 2000000 );
+  // The backup stops, saying so three times as E1.31 asks.
+  backup.m_options = E131_OPTION_TERMINATED;
+  AddStream( events, backup, 2000000 + 5000, 2000000 + 5000 + 3 * SOURCE_INTERVAL_US );
+  AddStream( events, preview, 2200000 + 10000, 2500000 );
+  // Merges at the same priority, then goes silent; gone E1.31's 2.5 s later.
+  AddStream( events, merging, 3000000 + 10000, 4000000 );
+  for( uint64_t time_us = 15000; time_us < 8000000; time_us += SOURCE_INTERVAL_US ) {
+    events.push_back( MakeSACN( time_us, unwanted, 9, IPAddress( 239, 255, 0, 9 ) ) );
+    events.push_back( MakeSACN( time_us, unwanted, 9, NODE_IP ) );
+  }
+  uint8_t artnet_data[ 512 ] = { 33 };
+  for( uint64_t time_us = 12000; time_us < 8000000; time_us += SOURCE_INTERVAL_US ) {
+    ReplayHarness::Event event;
+    event.m_time_us    = time_us;
+    event.m_data       = ReplayHarness::BuildArtDMX( 2, 0, artnet_data, sizeof( artnet_data ) );
+    event.m_source_ip  = IPAddress( 192, 168, 1, 50 );
+    event.m_local_port = ARTNET_UDP_PORT;
+    event.m_local_ip   = NODE_IP;
+    events.push_back( event );
+  }
+  std::stable_sort( events.begin(), events.end(), []( const ReplayHarness::Event& a, const ReplayHarness::Event& b ) {
+    return a.m_time_us < b.m_time_us;
+  } );
+  // A few of the console's packets overtake the one before.
+  uint32_t swapped = 0;
+  for( size_t i = 0, last = SIZE_MAX; i < events.size() && swapped < 3; i++ ) {
+    bool is_console = events[ i ].m_local_port == E131_UDP_PORT && events[ i ].m_source_ip == console.m_ip;
+    if( !is_console ) {
+      continue;
+    }
+    if( last != SIZE_MAX && events[ i ].m_time_us > 5000000 + swapped * 500000 ) {
+      std::swap( events[ last ].m_data, events[ i ].m_data );
+      swapped++;
+      last = SIZE_MAX;
+    } else {
+      last = i;
+    }
+  }
+
+  // Replayed from the capture, as a recording of a show would be.
+  std::vector<ReplayHarness::Event> replayed;
+  if( !ReplayHarness::SavePcap( path.c_str(), events ) || !ReplayHarness::LoadPcap( path.c_str(), replayed ) || replayed.size() != events.size() ) {
+    printf( "sacn: failed to write and read back %s\n", path.c_str() );
+    return 1;
+  }
+
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+                 "\"sacn_enabled\":true,"
+                 "\"dmx_extra_ports\":[{\"enabled\":true,\"gpio_enable\":18,\"gpio_transmit\":17,\"gpio_receive\":16,\"artnet_universe\":2}]}" );
+
+  // Channels 1 - 4 of each frame on the two ports.
+  struct Frame {
+    uint64_t m_time_us;
+    uint8_t  m_channels[ 4 ];
+  };
+  std::vector<Frame> frames[ 2 ];
+  uint64_t start_us = HostClock::NowMicros();
+  uint64_t dropped_start = HostNetwork::s_counters.m_dropped_no_socket;
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    if( ( dmx_num == DMX_NUM_1 || dmx_num == DMX_NUM_2 ) && size > 4 ) {
+      frames[ dmx_num == DMX_NUM_1 ? 0 : 1 ].push_back( { break_us - start_us, { frame[ 1 ], frame[ 2 ], frame[ 3 ], frame[ 4 ] } } );
+    }
+  };
+  ReplayHarness::Result result = harness.Run( replayed, 200000 );
+  HostDMX::s_send_hook = nullptr;
+  uint64_t dropped_multicast = HostNetwork::s_counters.m_dropped_no_socket - dropped_start;
+
+  ReplayHarness::PrintResult( "sacn: universe 1 over sACN from up to three sources, universe 2 over Art-Net, replayed from a capture", result );
+
+  // What each port was sending at a few moments of the show.
+  struct Check {
+    uint64_t    m_time_us;
+    int         m_port;
+    uint8_t     m_expected[ 4 ];
+    const char* m_what;
+  };
+  static const Check checks[] = {
+    {  500000, 0, {  50, 60, 0, 0 }, "the console alone" },
+    { 1500000, 0, { 200,  0, 9, 0 }, "the backup outranking it" },
+    { 2400000, 0, {  50, 60, 0, 0 }, "the console again, preview ignored" },
+    { 3500000, 0, {  80, 60, 0, 7 }, "two sources merging HTP" },
+    { 5500000, 0, {  80, 60, 0, 7 }, "the silent source not yet lost" },
+    { 7000000, 0, {  50, 60, 0, 0 }, "the console once it is lost" },
+    { 7000000, 1, {  33,  0, 0, 0 }, "Art-Net on port 2" },
+  };
+  bool is_ok = true;
+  for( const Check& check : checks ) {
+    const std::vector<Frame>& port_frames = frames[ check.m_port ];
+    auto after = std::upper_bound( port_frames.begin(), port_frames.end(), check.m_time_us, []( uint64_t time_us, const Frame& frame ) {
+      return time_us < frame.m_time_us;
+    } );
+    bool is_match = after != port_frames.begin() && memcmp( ( after - 1 )->m_channels, check.m_expected, 4 ) == 0;
+    printf( "  %4.1f s port %d : %-36s %s\n", check.m_time_us / 1e6, check.m_port + 1, check.m_what, is_match ? "ok" : "WRONG" );
+    is_ok &= is_match;
+  }
+
+  const SACNReceiveStats& stats = result.m_sacn_stats;
+  printf( "  %llu packets for universe 9 dropped by the interface, %u stale frames of %u swapped\n",
+          (unsigned long long)dropped_multicast, stats.m_stale_frames, swapped );
+  is_ok &= stats.m_stale_frames == swapped && swapped == 3 && stats.m_terminated_packets == 3 && stats.m_outranked_frames > 30 &&
+           stats.m_invalid_packets == 0 && stats.m_ignored_frames == 0 && dropped_multicast > 300 && stats.m_rejected_packets > 300 &&
+           result.m_receive_stats.m_accepted_packets > 300;
+
+  MeasureCost( iterations );
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
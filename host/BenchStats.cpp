@@ -0,0 +1,237 @@
+// Telemetry : a controller sends two universes at 40 Hz, mixed with packets the
+// node drops for each reason it has, then goes silent; a third port never gets
+// any.  /stats is read over the
+// web server and checked against what was sent, and the cost the telemetry adds
+// to each loop iteration is timed.  First, one universe through a jitter
+// buffer, whose counts /stats reports for each port.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <ArduinoJson.h>
+
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static const uint32_t SOURCE_INTERVAL_US = 25000;   // 40 Hz
+static const IPAddress NODE_IP( 192, 168, 1, 1 );
+static const IPAddress CONTROLLER_IP( 192, 168, 1, 100 );
+
+static ReplayHarness::Event MakeEvent( uint64_t time_us, const std::vector<uint8_t>& data, IPAddress source_ip ) {
+  ReplayHarness::Event event;
+  event.m_time_us    = time_us;
+  event.m_data       = data;
+  event.m_source_ip  = source_ip;
+  event.m_local_port = ARTNET_UDP_PORT;
+  event.m_local_ip   = NODE_IP;
+  return event;
+}
+
+// One universe at 40 Hz played out through a 30 ms jitter buffer : /stats
+// reports the counts the buffer kept, and the sender's cadence.
+static bool CheckJitterBuffer() {
+  uint8_t data[ 512 ] = {};
+  std::vector<ReplayHarness::Event> events;
+  uint8_t sequence = 1;
+  for( uint64_t time_us = 0; time_us < 2000000; time_us += SOURCE_INTERVAL_US ) {
+    events.push_back( MakeEvent( time_us, ReplayHarness::BuildArtDMX( 1, sequence, data, 512 ), CONTROLLER_IP ) );
+    sequence = sequence == 255 ? 1 : sequence + 1;
+  }
+
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"192.168.1.100\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+                 "\"dmx_jitter_delay_ms\":30}" );
+  ReplayHarness::Result result = harness.Run( events, 500000 );
+
+  WebServer& server = harness.Server();
+  server.HostRequest( HTTP_GET, "/stats" );
+  harness.Node().Update();
+
+  JsonDocument doc;
+  if( server.m_host_response_code != 200 || deserializeJson( doc, server.m_host_response_body ) ) {
+    printf( "  jitter buffer : /stats unreadable\n" );
+    return false;
+  }
+  JsonVariant                   jitter_buffer = doc[ "dmx" ][ 0 ][ "jitter_buffer" ];
+  const DMXJitterBuffer::Stats& stats         = result.m_jitter_stats[ 0 ];
+  uint32_t cadence_us  = jitter_buffer[ "cadence_us" ].as<uint32_t>();
+  uint32_t wait_avg_us = jitter_buffer[ "wait_us" ][ "avg" ].as<uint32_t>();
+  uint32_t wait_max_us = jitter_buffer[ "wait_us" ][ "max" ].as<uint32_t>();
+  bool is_ok = jitter_buffer[ "delay_us" ].as<uint32_t>() == 30000 && jitter_buffer[ "frames" ].as<uint32_t>() == stats.m_frames &&
+               jitter_buffer[ "played" ].as<uint32_t>() == stats.m_played && jitter_buffer[ "underruns" ].as<uint32_t>() == stats.m_underruns &&
+               jitter_buffer[ "overruns" ].as<uint32_t>() == stats.m_overruns && jitter_buffer[ "skipped" ].as<uint32_t>() == stats.m_skipped &&
+               jitter_buffer[ "depth_max" ].as<uint32_t>() == stats.m_depth_max && wait_max_us == stats.m_wait_max_us &&
+               stats.m_frames > 0 && wait_avg_us >= 30000 && wait_avg_us <= wait_max_us &&
+               cadence_us >= SOURCE_INTERVAL_US - 100 && cadence_us <= SOURCE_INTERVAL_US + 100;
+  printf( "stats: one universe at 40 Hz through a 30 ms jitter buffer\n  jitter buffer : %u frames (%u counted), %u played, %u underruns, %u overruns, %u skipped, depth max %u, wait %u us avg, %u max, "
+          "cadence %u us %s\n", jitter_buffer[ "frames" ].as<uint32_t>(), stats.m_frames, jitter_buffer[ "played" ].as<uint32_t>(),
+          jitter_buffer[ "underruns" ].as<uint32_t>(), jitter_buffer[ "overruns" ].as<uint32_t>(), jitter_buffer[ "skipped" ].as<uint32_t>(),
+          jitter_buffer[ "depth_max" ].as<uint32_t>(), wait_avg_us, wait_max_us, cadence_us, is_ok ? "ok" : "WRONG" );
+  return is_ok;
+}
+
+// OnReceive() and OnTransmit() as the tasks call them, once per iteration.
+static void MeasureCost( uint64_t iterations ) {
+  NodeTelemetry telemetry;
+  DMXPort       dmx_ports[ DMX_PORT_MAX ];
+  telemetry.Reset( 0 );
+  ArtNetReceiveStats artnet = {};
+  SACNReceiveStats   sacn   = {};
+  uint32_t now_us = 0;
+  double iteration_ns = MeasureNs( [&]() {
+    artnet.m_accepted_packets += now_us & 1;
+    telemetry.OnReceive( artnet, sacn, now_us, now_us + 20, now_us / 1000 );
+    telemetry.OnTransmit( ( now_us & 0x7FFF ) == 0 ? 0x03 : 0, now_us, now_us + 5, dmx_ports );
+    now_us += 50;
+  }, iterations );
+
+  char json[ 1536 ];
+  double format_ns = MeasureNs( [&]() {
+    KeepAlive( telemetry.FormatJSON( json, sizeof( json ), now_us / 1000, 0x03, 200000, 180000 ) );
+  }, iterations / 100 );
+
+  printf( "  ns per loop iteration to time it and publish : %.1f, ns to write /stats : %.0f\n", iteration_ns, format_ns );
+}
+
+int BenchStats( const Arguments& arguments ) {
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 1000000 );
+  double   seconds    = arguments.Number( "seconds", 5 );
+  uint64_t silence_us = 2000000;
+
+  // Before the node below is set up, which would take its packets.
+  bool is_jitter_buffer_ok = CheckJitterBuffer();
+
+  uint8_t data[ 512 ] = { 10, 20, 30 };
+  std::vector<uint8_t> too_short  = ReplayHarness::BuildArtDMX( 1, 0, data, 512 );
+  too_short.resize( 10 );
+  std::vector<uint8_t> bad_header = ReplayHarness::BuildArtDMX( 1, 0, data, 512 );
+  bad_header[ 0 ] = 'X';
+  std::vector<uint8_t> bad_length = ReplayHarness::BuildArtDMX( 1, 0, data, 512 );
+  bad_length.resize( ArtNetParser::DMX_DATA_START + 100 );
+  std::vector<uint8_t> unhandled  = ReplayHarness::BuildArtDMX( 1, 0, data, 512 );
+  unhandled[ 8 ] = 0x00;    // ArtAddress, 0x6000
+  unhandled[ 9 ] = 0x60;
+
+  std::vector<ReplayHarness::Event> events;
+  uint8_t  sequence = 1;
+  uint32_t sent     = 0;
+  for( uint64_t time_us = 0; time_us < (uint64_t)( seconds * 1000000 ); time_us += SOURCE_INTERVAL_US, sent++ ) {
+    events.push_back( MakeEvent( time_us, ReplayHarness::BuildArtDMX( 1, sequence, data, 512 ), CONTROLLER_IP ) );
+    events.push_back( MakeEvent( time_us + 1000, ReplayHarness::BuildArtDMX( 2, sequence, data, 512 ), CONTROLLER_IP ) );
+    sequence = sequence == 255 ? 1 : sequence + 1;
+  }
+
+  // How many of each the node should drop, sent 3 ms after a frame.
+  struct Drop {
+    const char*          m_reason;
+    std::vector<uint8_t> m_data;
+    IPAddress            m_source_ip;
+    uint32_t             m_count;
+  };
+  const Drop drops[] = {
+    { "size",      too_short,                                      CONTROLLER_IP,               7 },
+    { "header",    bad_header,                                     CONTROLLER_IP,               5 },
+    { "source_ip", ReplayHarness::BuildArtDMX( 1, 0, data, 512 ),  IPAddress( 192, 168, 1, 66 ), 11 },
+    { "universe",  ReplayHarness::BuildArtDMX( 7, 0, data, 512 ),  CONTROLLER_IP,               13 },
+    { "opcode",    unhandled,                                      CONTROLLER_IP,               3 },
+  };
+  uint64_t time_us = 3000;
+  for( const Drop& drop : drops ) {
+    for( uint32_t i = 0; i < drop.m_count; i++, time_us += SOURCE_INTERVAL_US ) {
+      events.push_back( MakeEvent( time_us, drop.m_data, drop.m_source_ip ) );
+    }
+  }
+  // Claims more DMX than it carries, which is a size too.
+  for( uint32_t i = 0; i < 2; i++, time_us += SOURCE_INTERVAL_US ) {
+    events.push_back( MakeEvent( time_us, bad_length, CONTROLLER_IP ) );
+  }
+  std::stable_sort( events.begin(), events.end(), []( const ReplayHarness::Event& a, const ReplayHarness::Event& b ) {
+    return a.m_time_us < b.m_time_us;
+  } );
+
+  // Each micros() the node calls takes 1 us, for loops that take time.
+  ReplayHarness::Options options;
+  options.m_read_step_us = 1;
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"192.168.1.100\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+                 "\"dmx_extra_ports\":[{\"enabled\":true,\"gpio_enable\":18,\"gpio_transmit\":17,\"gpio_receive\":16,\"artnet_universe\":2},"
+                 "{\"enabled\":true,\"gpio_enable\":15,\"gpio_transmit\":14,\"gpio_receive\":13,\"artnet_universe\":3}]}" );
+  ReplayHarness::Result result = harness.Run( events, silence_us );
+  ReplayHarness::PrintResult( "stats: two universes at 40 Hz with packets dropped for every reason, then 2 s of silence", result );
+
+  WebServer& server = harness.Server();
+  server.HostRequest( HTTP_GET, "/stats" );
+  harness.Node().Update();
+  printf( "  GET /stats %d %s, %u bytes\n  %s\n", server.m_host_response_code, server.m_host_response_type.c_str(),
+          server.m_host_response_body.length(), server.m_host_response_body.c_str() );
+
+  JsonDocument doc;
+  bool is_ok = server.m_host_response_code == 200 && server.m_host_response_type.equals( "application/json" ) &&
+               !deserializeJson( doc, server.m_host_response_body );
+  if( !is_ok ) {
+    printf( "  FAIL\n" );
+    return 1;
+  }
+
+  JsonVariant artnet = doc[ "artnet" ];
+  for( const Drop& drop : drops ) {
+    uint32_t expected = drop.m_count + ( strcmp( drop.m_reason, "size" ) == 0 ? 2 : 0 );
+    uint32_t dropped  = artnet[ "dropped" ][ drop.m_reason ].as<uint32_t>();
+    printf( "  dropped for %-9s : %3u of %3u %s\n", drop.m_reason, dropped, expected, dropped == expected ? "ok" : "WRONG" );
+    is_ok &= dropped == expected;
+  }
+  uint32_t accepted = artnet[ "accepted" ].as<uint32_t>();
+  uint32_t packets  = artnet[ "packets" ].as<uint32_t>();
+  uint32_t since_ms = artnet[ "since_ms" ].as<uint32_t>();
+  printf( "  %u packets, %u accepted of %u ArtDMX sent, last %u ms ago\n", packets, accepted, 2 * sent, since_ms );
+  // As the node counted them : its first Update() restarts it for the config Init() loaded, closing the socket on the first packet.
+  is_ok &= accepted == result.m_receive_stats.m_accepted_packets && packets == result.m_receive_stats.m_packets &&
+           accepted + 1 >= 2 * sent && since_ms >= 1900 && since_ms <= 2100;
+  is_ok &= doc[ "sacn" ][ "since_ms" ].isNull() && doc[ "heap" ][ "free" ].as<uint32_t>() == ESP.getFreeHeap();
+
+  // Each loop's iterations timed, over the whole run.  With the node's reads
+  // of the clock taking time, a loop iteration is the harness's plus theirs.
+  uint32_t iteration_max_us = options.m_loop_us;
+  for( const char* name : { "receive_loop_us", "transmit_loop_us" } ) {
+    JsonVariant loop       = doc[ name ];
+    uint32_t    count      = loop[ "n" ].as<uint32_t>();
+    uint32_t    min_us     = loop[ "min" ].as<uint32_t>();
+    uint32_t    avg_us     = loop[ "avg" ].as<uint32_t>();
+    uint32_t    max_us     = loop[ "max" ].as<uint32_t>();
+    bool        is_loop_ok = count > 0 && min_us <= avg_us && avg_us <= max_us && max_us > 0;
+    printf( "  %s : min %u, avg %u, max %u us over %u iterations %s\n", name, min_us, avg_us, max_us, count,
+            is_loop_ok ? "ok" : "WRONG" );
+    is_ok &= is_loop_ok;
+    iteration_max_us += max_us;
+  }
+
+  // Every port refreshes every 23 ms, 43.48 Hz, whether or not Art-Net arrives,
+  // within a loop iteration of it.  The idle one too, its short frames don't
+  // go out any faster.
+  for( int i = 0; i < 3; i++ ) {
+    JsonVariant port = doc[ "dmx" ][ i ];
+    double   refresh_hz  = port[ "refresh_hz" ].as<double>();
+    uint32_t frames      = port[ "frames" ].as<uint32_t>();
+    uint32_t nominal_us  = port[ "interval_us" ][ "nominal" ].as<uint32_t>();
+    uint32_t min_us      = port[ "interval_us" ][ "min" ].as<uint32_t>();
+    uint32_t max_us      = port[ "interval_us" ][ "max" ].as<uint32_t>();
+    uint32_t jitter_us   = port[ "jitter_us" ][ "max" ].as<uint32_t>();
+    printf( "  port %u : %u frames (%llu on the wire), %.2f Hz, interval %u us (%u - %u), jitter max %u us\n", port[ "port" ].as<uint32_t>(),
+            frames, (unsigned long long)result.m_port_frames[ DMXPort::GetDMXNum( i ) ], refresh_hz, nominal_us, min_us, max_us, jitter_us );
+    is_ok &= refresh_hz >= 43.4 && refresh_hz <= 43.5 && frames > 0 && frames <= result.m_port_frames[ DMXPort::GetDMXNum( i ) ];
+    is_ok &= nominal_us == 23000 && min_us <= nominal_us && max_us >= nominal_us && jitter_us <= iteration_max_us &&
+             port[ "jitter_us" ][ "avg" ].as<uint32_t>() <= jitter_us;
+  }
+
+  // The buffer is off, its counts left out.
+  for( int i = 0; i < 3; i++ ) {
+    is_ok &= doc[ "dmx" ][ i ][ "jitter_buffer" ].isNull();
+  }
+  is_ok &= is_jitter_buffer_ok;
+
+  MeasureCost( iterations );
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
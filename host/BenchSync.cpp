@@ -0,0 +1,153 @@
+// ArtSync : a controller sends three universes at 40 Hz, one to each DMX
+// port, a few ms apart as they would arrive over WiFi.  Replayed without
+// ArtSync, and with an ArtSync after each set of frames that then stops, so
+// the node falls back to sending frames as they arrive.  Reports how far apart
+// the ports pick up each frame, which is the tearing a wall of nodes shows,
+// and the time from ArtSync to the break of the first DMX frame carrying it.
+
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static const uint32_t SOURCE_INTERVAL_US = 25000;   // 40 Hz
+static const uint32_t UNIVERSE_SPACING_US = 4000;
+static const uint8_t  UNIVERSES           = 3;
+
+struct SyncRun {
+  uint32_t              m_frames;           // Sent by the controller.
+  uint32_t              m_complete;         // Seen on every port.
+  std::vector<uint64_t> m_spread_us;        // Per frame, first port to last to send it, while synchronised if at all.
+  std::vector<uint64_t> m_commit_us;        // Per frame and port, ArtSync's arrival to the break.
+  uint32_t              m_after_fallback;   // Frames seen on every port once the sync timeout passed.
+  ArtNetReceiveStats    m_receive_stats;
+};
+
+static uint64_t Percentile( std::vector<uint64_t> values, double fraction ) {
+  if( values.empty() ) {
+    return 0;
+  }
+  std::sort( values.begin(), values.end() );
+  return values[ std::min( values.size() - 1, (size_t)( values.size() * fraction ) ) ];
+}
+
+static ReplayHarness::Event MakeEvent( uint64_t time_us, const std::vector<uint8_t>& data,
+                                       IPAddress source_ip = IPAddress( 192, 168, 1, 100 ) ) {
+  ReplayHarness::Event event;
+  event.m_time_us    = time_us;
+  event.m_data       = data;
+  event.m_source_ip  = source_ip;
+  event.m_local_port = ARTNET_UDP_PORT;
+  event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+  return event;
+}
+
+// seconds of frames, ArtSync after each of the first sync_frames of them, and
+// before it an ArtSync from another host, which the node must ignore.
+static SyncRun Replay( double seconds, uint32_t sync_frames ) {
+  static const uint8_t art_sync[] = { 'A', 'r', 't', '-', 'N', 'e', 't', 0, 0x00, 0x52, 0, ARTNET_VERSION, 0, 0 };
+
+  SyncRun run = {};
+  run.m_frames = (uint32_t)( seconds * 1e6 / SOURCE_INTERVAL_US );
+
+  std::vector<ReplayHarness::Event> events;
+  std::vector<uint64_t> sync_us;
+  uint8_t data[ 512 ] = {};
+  for( uint32_t number = 1; number <= run.m_frames; number++ ) {
+    uint64_t start_us = 50000 + (uint64_t)( number - 1 ) * SOURCE_INTERVAL_US;
+    data[ 0 ] = number >> 8;
+    data[ 1 ] = number & 0xFF;
+    for( uint8_t universe = 1; universe <= UNIVERSES; universe++ ) {
+      events.push_back( MakeEvent( start_us + ( universe - 1 ) * UNIVERSE_SPACING_US, ReplayHarness::BuildArtDMX( universe, 0, data, sizeof( data ) ) ) );
+    }
+    if( number <= sync_frames ) {
+      sync_us.push_back( start_us + ( UNIVERSES - 1 ) * UNIVERSE_SPACING_US + 2000 );
+      events.push_back( MakeEvent( sync_us.back() - 1000, std::vector<uint8_t>( art_sync, art_sync + sizeof( art_sync ) ),
+                                   IPAddress( 192, 168, 1, 66 ) ) );
+      events.push_back( MakeEvent( sync_us.back(), std::vector<uint8_t>( art_sync, art_sync + sizeof( art_sync ) ) ) );
+    }
+  }
+  uint64_t fallback_us = sync_frames == 0 ? 0 : sync_us.back() + 4000000 + 50000;
+
+  // Each micros() the node calls takes 1 us, so that committing a frame on
+  // ArtSync takes time as it does on the ESP32.
+  ReplayHarness::Options options;
+  options.m_read_step_us = 1;
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+                 "\"dmx_extra_ports\":[{\"enabled\":true,\"gpio_enable\":18,\"gpio_transmit\":17,\"gpio_receive\":16,\"artnet_universe\":2},"
+                 "{\"enabled\":true,\"gpio_enable\":15,\"gpio_transmit\":14,\"gpio_receive\":13,\"artnet_universe\":3}]}" );
+
+  // Channels 1 and 2 carry the frame number.
+  std::map<uint32_t, std::vector<uint64_t>> first_breaks_us;
+  std::map<dmx_port_t, uint32_t> last_numbers;
+  uint64_t start_us = HostClock::NowMicros();
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    uint32_t number = ( frame[ 1 ] << 8 ) | frame[ 2 ];
+    if( number != 0 && number != last_numbers[ dmx_num ] ) {
+      first_breaks_us[ number ].push_back( break_us - start_us );
+      last_numbers[ dmx_num ] = number;
+    }
+  };
+  ReplayHarness::Result result = harness.Run( events, 200000 );
+  HostDMX::s_send_hook = nullptr;
+  run.m_receive_stats = result.m_receive_stats;
+
+  for( const auto& frame : first_breaks_us ) {
+    const std::vector<uint64_t>& breaks_us = frame.second;
+    if( breaks_us.size() != UNIVERSES ) {
+      continue;
+    }
+    run.m_complete++;
+    // The first frame goes out as it arrives, its ArtSync is the first seen.
+    bool is_synced = frame.first > 1 && frame.first <= sync_frames;
+    if( is_synced || sync_frames == 0 ) {
+      run.m_spread_us.push_back( *std::max_element( breaks_us.begin(), breaks_us.end() ) - *std::min_element( breaks_us.begin(), breaks_us.end() ) );
+    }
+    if( is_synced ) {
+      for( uint64_t break_us : breaks_us ) {
+        run.m_commit_us.push_back( break_us - sync_us[ frame.first - 1 ] );
+      }
+    }
+    if( sync_frames != 0 && breaks_us.front() > fallback_us ) {
+      run.m_after_fallback++;
+    }
+  }
+  return run;
+}
+
+int BenchSync( const Arguments& arguments ) {
+  double seconds = arguments.Number( "seconds", 10 );
+
+  uint32_t frames      = (uint32_t)( seconds * 1e6 / SOURCE_INTERVAL_US );
+  uint32_t sync_frames = frames / 2;
+  SyncRun  immediate   = Replay( seconds, 0 );
+  SyncRun  synced      = Replay( seconds, sync_frames );
+
+  printf( "sync: 40 Hz to %u ports, universes %u ms apart, DMX every 23 ms; ArtSync for the first %u of %u frames\n",
+          UNIVERSES, UNIVERSE_SPACING_US / 1000, sync_frames, frames );
+  printf( "  %-10s : %4u frames on every port, ports apart p95 %5.1f ms, max %5.1f ms\n", "no ArtSync", immediate.m_complete,
+          Percentile( immediate.m_spread_us, 0.95 ) / 1e3, Percentile( immediate.m_spread_us, 1.0 ) / 1e3 );
+  printf( "  %-10s : %4u frames on every port, ports apart p95 %5.1f ms, max %5.1f ms\n", "ArtSync", synced.m_complete,
+          Percentile( synced.m_spread_us, 0.95 ) / 1e3, Percentile( synced.m_spread_us, 1.0 ) / 1e3 );
+  printf( "  ArtSync to break : p50 %llu us, p95 %llu us, max %llu us\n", (unsigned long long)Percentile( synced.m_commit_us, 0.50 ),
+          (unsigned long long)Percentile( synced.m_commit_us, 0.95 ), (unsigned long long)Percentile( synced.m_commit_us, 1.0 ) );
+  printf( "  %u commits, %u ignored, %u timeouts; %u frames on every port after falling back\n",
+          synced.m_receive_stats.m_sync_commits, synced.m_receive_stats.m_sync_ignored, synced.m_receive_stats.m_sync_timeouts,
+          synced.m_after_fallback );
+
+  // Synchronised, every frame but the first reaches every port at once, the
+  // breaks only the node's clock reads between starting the ports apart,
+  // after its ArtSync arrives and at most a DMX frame later.  The other host's
+  // ArtSync never commits a frame.  Once ArtSync stops frames flow again.
+  bool is_ok = Percentile( synced.m_spread_us, 1.0 ) <= 50 && Percentile( immediate.m_spread_us, 1.0 ) > 0 &&
+               synced.m_commit_us.size() == ( sync_frames - 1 ) * UNIVERSES &&
+               Percentile( synced.m_commit_us, 0.0 ) > 0 && Percentile( synced.m_commit_us, 1.0 ) <= 23000 + 1000 &&
+               synced.m_receive_stats.m_sync_commits == sync_frames && synced.m_receive_stats.m_sync_ignored == sync_frames &&
+               synced.m_receive_stats.m_sync_timeouts == 1 && synced.m_after_fallback > 0;
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
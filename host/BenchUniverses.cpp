@@ -0,0 +1,157 @@
+// Universe dispatch benchmark : ArtNetUniverseMap lookups for a network
+// carrying 512 universes, with 1, 8 and 32 of them subscribed, then a slice of
+// one universe and the routes of another sharing port 1 through the node, and
+// the map at its limit of slices.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ArtNetUniverseMap.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static ReplayHarness::Event MakeArtDMX( uint64_t time_us, uint16_t universe, const uint8_t* data ) {
+  ReplayHarness::Event event;
+  event.m_time_us    = time_us;
+  event.m_data       = ReplayHarness::BuildArtDMX( universe, 0, data, 512 );
+  event.m_source_ip  = IPAddress( 192, 168, 1, 100 );
+  event.m_local_port = ARTNET_UDP_PORT;
+  event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+  return event;
+}
+
+// Universe 1 channels 1 - 8 on 1 - 8 and universe 2 channels 1 - 8 on 9 - 16,
+// with routes from universe 1 adding its channel 1 to channel 10 and copying 3 -
+// 4 to 20 - 21.  The two arrive in the same drain, in either order, and universe
+// 2 again alone in between; channel 10 is always universe 2's plus universe 1's.
+static bool CheckSliceAndRoutes() {
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23,"
+                 "\"artnet_universe_slices\":[{\"universe\":1,\"input_channel\":1,\"output_channel\":1,\"count\":8},"
+                 "{\"universe\":2,\"input_channel\":1,\"output_channel\":9,\"count\":8}],"
+                 "\"dmx_routing_configs\":[{\"input_channel\":1,\"output_channels\":[10],\"merge\":\"add\"},"
+                 "{\"block\":\"3-4 > 20-21\",\"merge\":\"ltp\"}]}" );
+
+  // Universe 1's own channel 10 isn't patched, the route mustn't start from it.
+  uint8_t universe_1[ 512 ] = { 10, 20, 30, 40, 50, 60, 70, 80 };
+  uint8_t universe_2[ 512 ] = { 1, 50, 3, 4, 5, 6, 7, 8 };
+  universe_1[ 9 ] = 99;
+
+  std::vector<ReplayHarness::Event> events;
+  for( uint64_t time_us = 50000, i = 0; time_us < 500000; time_us += 25000, i++ ) {
+    events.push_back( MakeArtDMX( time_us, ( i & 1 ) ? 2 : 1, ( i & 1 ) ? universe_2 : universe_1 ) );
+    events.push_back( MakeArtDMX( time_us, ( i & 1 ) ? 1 : 2, ( i & 1 ) ? universe_1 : universe_2 ) );
+    events.push_back( MakeArtDMX( time_us + 10000, 2, universe_2 ) );
+  }
+
+  uint8_t last_frame[ 22 ] = {};
+  bool    is_ok            = true;
+  uint8_t expected[ 22 ]   = {};
+  memcpy( &expected[ 1 ], universe_1, 8 );
+  memcpy( &expected[ 9 ], universe_2, 8 );
+  expected[ 10 ] = universe_2[ 1 ] + universe_1[ 0 ];
+  expected[ 20 ] = universe_1[ 2 ];
+  expected[ 21 ] = universe_1[ 3 ];
+  uint64_t frames = 0;
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    memcpy( last_frame, frame, std::min( size, sizeof( last_frame ) ) );
+    // Every frame once both universes are in.
+    if( break_us > 100000 ) {
+      is_ok &= memcmp( last_frame, expected, sizeof( expected ) ) == 0;
+      frames++;
+    }
+  };
+  harness.Run( events, 100000 );
+  HostDMX::s_send_hook = nullptr;
+
+  is_ok &= frames > 0;
+  printf( "universes: universe 2 sliced onto channel 10, universe 1 routed onto it, sent as %u (%u expected) over %llu frames, %s\n",
+          last_frame[ 10 ], expected[ 10 ], (unsigned long long)frames, is_ok ? "as expected" : "WRONG" );
+  return is_ok;
+}
+
+// MAX_SLICES slices of as many universes, and the routed one besides, each
+// found at its own index; one slice more is refused rather than left out.
+static bool CheckSliceLimit() {
+  std::vector<ArtNetUniverseSlice> slices;
+  for( uint16_t universe = 1; universe <= ArtNetUniverseMap::MAX_SLICES; universe++ ) {
+    slices.push_back( { universe, 1, 1, 512, 0 } );
+  }
+
+  ArtNetUniverseMap universe_map;
+  bool is_ok = universe_map.Compile( slices, 1000 ) && universe_map.GetUniverseCount() == ArtNetUniverseMap::MAX_SLICES + 1;
+  std::vector<uint16_t> universes = universe_map.GetUniverses();
+  std::vector<bool>     is_found( universes.size() );
+  for( uint16_t universe = 1; is_ok && universe <= ArtNetUniverseMap::MAX_SLICES + 1; universe++ ) {
+    uint16_t                       wanted    = universe <= ArtNetUniverseMap::MAX_SLICES ? universe : 1000;
+    const ArtNetUniverseMap::Entry* ptr_entry = universe_map.Find( wanted );
+    is_ok = ptr_entry != nullptr && ptr_entry->m_index < universes.size() && !is_found[ ptr_entry->m_index ] &&
+            universes[ ptr_entry->m_index ] == wanted;
+    if( is_ok ) {
+      is_found[ ptr_entry->m_index ] = true;
+    }
+  }
+  size_t universe_count = universe_map.GetUniverseCount();
+
+  slices.push_back( { 2000, 1, 1, 512, 1 } );
+  bool is_refused = !universe_map.Compile( slices, 1000 ) && universe_map.GetUniverseCount() == 1;
+  printf( "universes: %zu slices and the routed universe, %zu universes indexed %s; one slice more %s\n", slices.size() - 1,
+          universe_count, is_ok ? "apart" : "WRONG", is_refused ? "refused" : "WRONG" );
+  return is_ok && is_refused;
+}
+
+int BenchUniverses( const Arguments& arguments ) {
+  uint64_t iterations = (uint64_t)arguments.Number( "iterations", 2000 );
+  const int network_universes = 512;
+
+  printf( "universes: lookups for packets on %d universes\n", network_universes );
+  printf( "  %10s %14s %16s\n", "subscribed", "hash ns/pkt", "linear ns/pkt" );
+
+  const int subscription_counts[] = { 1, 8, 32 };
+  for( int subscriptions : subscription_counts ) {
+    std::vector<ArtNetUniverseSlice> slices;
+    for( int i = 0; i < subscriptions; i++ ) {
+      // Spread over the network, like a node patched into a large rig.
+      uint16_t universe = (uint16_t)( ( i * 37 ) % network_universes );
+      slices.push_back( { universe, 1, 1, 512, 0 } );
+    }
+
+    ArtNetUniverseMap universe_map;
+    universe_map.Compile( slices, slices[ 0 ].universe );
+
+    uint64_t hits = 0;
+    double hash_ns = MeasureNs( [&]() {
+      for( uint16_t universe = 0; universe < network_universes; universe++ ) {
+        hits += ( universe_map.Find( universe ) != nullptr );
+      }
+      KeepAlive( hits );
+    }, iterations ) / network_universes;
+
+    // What a scan over the patch would cost instead.
+    double linear_ns = MeasureNs( [&]() {
+      for( uint16_t universe = 0; universe < network_universes; universe++ ) {
+        for( const ArtNetUniverseSlice& slice : slices ) {
+          if( slice.universe == universe ) {
+            hits++;
+            break;
+          }
+        }
+      }
+      KeepAlive( hits );
+    }, iterations ) / network_universes;
+
+    if( hits != ( 2 * iterations ) * universe_map.GetUniverseCount() ) {
+      printf( "  %10d lookup results differ\n", subscriptions );
+      return 1;
+    }
+
+    printf( "  %10d %14.2f %16.2f\n", subscriptions, hash_ns, linear_ns );
+  }
+
+  bool is_ok = CheckSliceAndRoutes();
+  is_ok &= CheckSliceLimit();
+
+  printf( "  %s\n", is_ok ? "PASS" : "FAIL" );
+  return is_ok ? 0 : 1;
+}
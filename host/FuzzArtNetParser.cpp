@@ -0,0 +1,238 @@
+// Fuzz and property tests of ArtNetParser.
+//
+// Every input is copied to a heap buffer of exactly its own size, so a read
+// past the end is caught when built with make SANITIZE=1.  The global
+// operator new is counted to check that neither the parser nor the node's
+// receive path allocate.
+
+#include <stdio.h>
+#include <atomic>
+#include <new>
+#include <random>
+
+#include "ArtNetParser.h"
+#include "HostNetwork.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+static std::atomic<uint64_t> g_allocations( 0 );
+
+// AddressSanitizer brings its own operator new, allocations are only counted without it.
+#ifndef __SANITIZE_ADDRESS__
+static const bool IS_COUNTING_ALLOCATIONS = true;
+
+void* operator new( size_t size ) {
+  g_allocations.fetch_add( 1, std::memory_order_relaxed );
+  void* ptr = malloc( size ? size : 1 );
+  if( ptr == nullptr ) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete( void* ptr ) noexcept {
+  free( ptr );
+}
+
+void operator delete( void* ptr, size_t ) noexcept {
+  free( ptr );
+}
+#else
+static const bool IS_COUNTING_ALLOCATIONS = false;
+#endif
+
+namespace {
+
+struct Counters {
+  uint64_t m_inputs   = 0;
+  uint64_t m_accepted = 0;
+  uint64_t m_results[ ArtNetParser::PARSE_RESULT_MAX ] = {};
+  uint64_t m_failures = 0;
+};
+
+void Fail( Counters& counters, const char* what, size_t size ) {
+  if( counters.m_failures++ < 10 ) {
+    printf( "  FAIL %s (input of %zu bytes)\n", what, size );
+  }
+}
+
+// Parses one input the way CheckForArtNetData() does and checks the invariants.
+void Check( Counters& counters, const std::vector<uint8_t>& input ) {
+  uint8_t* buffer = new uint8_t[ input.size() ? input.size() : 1 ];
+  memcpy( buffer, input.data(), input.size() );
+
+  uint64_t allocations = g_allocations.load();
+
+  uint16_t      opcode = 0;
+  ArtNetDMXView dmx;
+  ArtNetParser::Result result = ArtNetParser::ParseHeader( buffer, input.size(), opcode );
+  if( result == ArtNetParser::PARSE_OK && opcode == ARTNET_OPCODE_DMX ) {
+    result = ArtNetParser::ParseDMX( buffer, input.size(), dmx );
+    if( result == ArtNetParser::PARSE_OK ) {
+      counters.m_accepted++;
+      if( dmx.length < 1 || dmx.length > 512 ) {
+        Fail( counters, "accepted length out of 1 - 512", input.size() );
+      }
+      if( ArtNetParser::DMX_DATA_START + dmx.length > input.size() ) {
+        Fail( counters, "accepted length past the end of the datagram", input.size() );
+      }
+      if( dmx.universe > 0x7FFF ) {
+        Fail( counters, "universe wider than 15 bits", input.size() );
+      }
+      if( dmx.data != buffer + ArtNetParser::DMX_DATA_START ) {
+        Fail( counters, "data doesn't point into the datagram", input.size() );
+      }
+      uint16_t universe = 0xFFFF;
+      if( ArtNetParser::PeekDMXUniverse( buffer, ArtNetParser::DMX_DATA_START, universe ) != ArtNetParser::PARSE_OK || universe != dmx.universe ) {
+        Fail( counters, "peeked universe differs from the parsed one", input.size() );
+      }
+      // Touch every byte the view claims, for the sanitizers.
+      uint32_t sum = 0;
+      for( uint16_t i = 0; i < dmx.length; i++ ) {
+        sum += dmx.data[ i ];
+      }
+      KeepAlive( sum );
+    }
+  }
+
+  if( g_allocations.load() != allocations ) {
+    Fail( counters, "parser allocated", input.size() );
+  }
+
+  counters.m_inputs++;
+  counters.m_results[ result ]++;
+  delete[] buffer;
+}
+
+// Valid packets parse back to what they were built from, and the same
+// packets truncated or claiming a bad length are rejected.
+void CheckRoundTrip( Counters& counters, std::mt19937& random, uint64_t iterations ) {
+  uint8_t data[ 512 ];
+  for( uint64_t i = 0; i < iterations; i++ ) {
+    uint16_t universe = random() & 0x7FFF;
+    uint8_t  sequence = random();
+    uint16_t length   = 1 + random() % 512;
+    for( uint16_t c = 0; c < length; c++ ) {
+      data[ c ] = random();
+    }
+
+    std::vector<uint8_t> packet = ReplayHarness::BuildArtDMX( universe, sequence, data, length );
+
+    uint16_t      opcode = 0;
+    ArtNetDMXView dmx;
+    if( ArtNetParser::ParseHeader( packet.data(), packet.size(), opcode ) != ArtNetParser::PARSE_OK || opcode != ARTNET_OPCODE_DMX ||
+        ArtNetParser::ParseDMX( packet.data(), packet.size(), dmx ) != ArtNetParser::PARSE_OK ) {
+      Fail( counters, "valid packet rejected", packet.size() );
+      continue;
+    }
+    if( dmx.universe != universe || dmx.sequence != sequence || dmx.length != length || memcmp( dmx.data, data, length ) != 0 ) {
+      Fail( counters, "valid packet parsed to different fields", packet.size() );
+    }
+
+    // Truncated anywhere, including in the middle of the data.
+    size_t cut = random() % packet.size();
+    std::vector<uint8_t> truncated( packet.begin(), packet.begin() + cut );
+    uint64_t accepted = counters.m_accepted;
+    Check( counters, truncated );
+    if( counters.m_accepted != accepted ) {
+      Fail( counters, "truncated packet accepted", truncated.size() );
+    }
+
+    // Claiming more, or other than 1 - 512, channels.
+    std::vector<uint8_t> bad_length( packet );
+    uint16_t claimed = ( random() & 1 ) ? length + 1 + random() % 600 : ( ( random() & 1 ) ? 0 : 513 + random() % 65000 );
+    bad_length[ 16 ] = claimed >> 8;
+    bad_length[ 17 ] = claimed & 0xFF;
+    accepted = counters.m_accepted;
+    Check( counters, bad_length );
+    if( counters.m_accepted != accepted ) {
+      Fail( counters, "bad DMX length accepted", bad_length.size() );
+    }
+  }
+}
+
+// Valid packets with random bytes flipped, cut or appended, and plain garbage.
+void CheckMutations( Counters& counters, std::mt19937& random, uint64_t iterations ) {
+  uint8_t data[ 512 ] = {};
+  for( uint64_t i = 0; i < iterations; i++ ) {
+    std::vector<uint8_t> input;
+    if( random() % 4 == 0 ) {
+      input.resize( random() % 600 );
+      for( uint8_t& byte : input ) {
+        byte = random();
+      }
+    } else {
+      input = ReplayHarness::BuildArtDMX( random() & 0x7FFF, random(), data, 1 + random() % 512 );
+      int mutations = 1 + random() % 4;
+      for( int m = 0; m < mutations; m++ ) {
+        switch( random() % 4 ) {
+          case 0: input[ random() % input.size() ] = random(); break;
+          case 1: input[ 16 + random() % 2 ] = random(); break;
+          case 2: input.resize( random() % ( input.size() + 1 ) ); break;
+          case 3: input.resize( input.size() + random() % 32, (uint8_t)random() ); break;
+        }
+        if( input.empty() ) {
+          break;
+        }
+      }
+    }
+    Check( counters, input );
+  }
+}
+
+// Valid packets through the whole node, nothing on the receive path may allocate.
+uint64_t CountNodeAllocations( uint64_t count ) {
+  ReplayHarness::Options options;
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":23}" );
+
+  std::vector<uint8_t> packets[ 4 ];
+  uint8_t data[ 512 ] = {};
+  for( int p = 0; p < 4; p++ ) {
+    data[ 0 ] = p;
+    packets[ p ] = ReplayHarness::BuildArtDMX( 1, p + 1, data, 512 );
+  }
+
+  // The first Update() may restart the node for the config Setup() wrote.
+  harness.Node().Update();
+
+  uint64_t allocations = 0;
+  for( uint64_t i = 0; i < count; i++ ) {
+    HostNetwork::Deliver( packets[ i % 4 ].data(), packets[ i % 4 ].size(), IPAddress( 192, 168, 1, 100 ), ARTNET_UDP_PORT, ARTNET_UDP_PORT );
+    HostClock::Advance( 1000 );
+    uint64_t before = g_allocations.load();
+    harness.Node().Update();
+    allocations += g_allocations.load() - before;
+  }
+  return allocations;
+}
+
+}
+
+int FuzzArtNetParser( const Arguments& arguments ) {
+  uint64_t     iterations = (uint64_t)arguments.Number( "iterations", 200000 );
+  uint32_t     seed       = (uint32_t)arguments.Number( "seed", 1 );
+  std::mt19937 random( seed );
+
+  printf( "fuzz: ArtNetParser, %llu iterations, seed %u\n", (unsigned long long)iterations, seed );
+
+  Counters counters;
+  CheckRoundTrip( counters, random, iterations / 4 );
+  CheckMutations( counters, random, iterations );
+
+  printf( "  inputs        : %llu, %llu accepted as ArtDMX\n", (unsigned long long)counters.m_inputs, (unsigned long long)counters.m_accepted );
+  for( int r = 0; r < ArtNetParser::PARSE_RESULT_MAX; r++ ) {
+    printf( "  %-14s: %llu\n", ArtNetParser::GetResultName( (ArtNetParser::Result)r ), (unsigned long long)counters.m_results[ r ] );
+  }
+
+  if( IS_COUNTING_ALLOCATIONS ) {
+    uint64_t node_allocations = CountNodeAllocations( 1000 );
+    printf( "  node Update() : %llu allocations over 1000 packets\n", (unsigned long long)node_allocations );
+    if( node_allocations != 0 ) {
+      Fail( counters, "receive path allocated", 0 );
+    }
+  }
+
+  printf( "  %s\n", counters.m_failures == 0 ? "PASS" : "FAIL" );
+  return counters.m_failures == 0 ? 0 : 1;
+}
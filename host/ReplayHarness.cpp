@@ -0,0 +1,514 @@
+#include "ReplayHarness.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+
+#include <LittleFS.h>
+
+#include "HostNetwork.h"
+
+ReplayHarness::ReplayHarness( const Options& options ) : m_options( options ) {
+  HostDMX::Reset();
+  HostClock::Set( options.m_start_us );
+  HostClock::SetReadStep( options.m_read_step_us );
+  WiFiUDP::s_host_queue_depth = options.m_queue_depth;
+  Serial.HostSetEcho( options.m_serial );
+}
+
+ReplayHarness::~ReplayHarness() {
+  m_node.reset();
+  HostDMX::s_send_hook = nullptr;
+  HostClock::SetReadStep( 0 );
+}
+
+void ReplayHarness::Setup( const char* config_json ) {
+  if( config_json != nullptr ) {
+    File config_file = LittleFS.open( "/config.json", "w" );
+    config_file.write( (const uint8_t*)config_json, strlen( config_json ) );
+    config_file.close();
+  }
+
+  m_node.reset( new ESP32Artnet2DMX() );
+
+  ESP32Artnet2DMX* ptr_node = m_node.get();
+  m_server.onNotFound( [ptr_node]() { ptr_node->HandleWebServerData(); } );
+
+  m_node->Init( &m_server );
+  m_node->SetUseTasks( m_options.m_use_tasks );
+  m_node->Start();
+}
+
+static uint64_t FramesSent( uint64_t* port_frames = nullptr ) {
+  uint64_t frames = 0;
+  for( int dmx_num = 0; dmx_num < DMX_NUM_MAX; dmx_num++ ) {
+    frames += HostDMX::Get( dmx_num ).m_frames_sent;
+    if( port_frames != nullptr ) {
+      port_frames[ dmx_num ] = HostDMX::Get( dmx_num ).m_frames_sent;
+    }
+  }
+  return frames;
+}
+
+static uint64_t WaitMicros() {
+  uint64_t wait_us = 0;
+  for( int dmx_num = 0; dmx_num < DMX_NUM_MAX; dmx_num++ ) {
+    wait_us += HostDMX::Get( dmx_num ).m_wait_us;
+  }
+  return wait_us;
+}
+
+static bool IsDMXBusy( uint64_t now_us ) {
+  for( int dmx_num = 0; dmx_num < DMX_NUM_MAX; dmx_num++ ) {
+    if( HostDMX::Get( dmx_num ).m_installed && now_us < HostDMX::Get( dmx_num ).m_busy_until_us ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ReplayHarness::Result ReplayHarness::Run( const std::vector<Event>& events, uint64_t tail_us ) {
+  Result result = {};
+
+  uint64_t start_us        = HostClock::NowMicros();
+  uint64_t end_us          = start_us + ( events.empty() ? 0 : events.back().m_time_us ) + tail_us;
+  uint64_t port_frames_start[ DMX_NUM_MAX ];
+  uint64_t frames_start    = FramesSent( port_frames_start );
+  uint64_t wait_start      = WaitMicros();
+  uint64_t dropped_start   = HostNetwork::s_counters.m_dropped_queue_full + HostNetwork::s_counters.m_dropped_no_socket;
+  uint64_t bytes_start     = HostNetwork::s_counters.m_bytes_read;
+  size_t   next_event      = 0;
+  uint64_t next_stall_us   = start_us + m_options.m_stall_period_us;
+
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    m_node->GetDMXPort( i ).GetScheduler().ResetStats();
+  }
+
+  // Arrival times of packets waiting in the socket, then of packets read by
+  // the node but not yet in a DMX frame.
+  std::deque<uint64_t>  queued_arrivals;
+  std::vector<uint64_t> read_arrivals;
+  size_t queued_before = 0;
+  size_t taken         = 0;
+
+  auto take_read_packets = [&]() {
+    size_t consumed = queued_before - std::min( queued_before, HostNetwork::Queued() );
+    for( ; taken < consumed && !queued_arrivals.empty(); taken++ ) {
+      read_arrivals.push_back( queued_arrivals.front() );
+      queued_arrivals.pop_front();
+    }
+  };
+
+  HostDMX::SendHook previous_hook = HostDMX::s_send_hook;
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    if( previous_hook ) {
+      previous_hook( dmx_num, break_us, frame, size );
+    }
+    // Whatever the node has read so far in this Update() is in this frame.
+    take_read_packets();
+    for( uint64_t arrival_us : read_arrivals ) {
+      result.m_latency_us.push_back( break_us - arrival_us );
+    }
+    read_arrivals.clear();
+  };
+
+  while( next_event < events.size() || HostClock::NowMicros() < end_us ) {
+    // Everything that arrived while the node was busy is delivered at once,
+    // the same way it would pile up in the lwIP receive queue.
+    uint64_t now_us = HostClock::NowMicros();
+    while( next_event < events.size() && start_us + events[ next_event ].m_time_us <= now_us ) {
+      const Event& event = events[ next_event++ ];
+      if( HostNetwork::Deliver( event.m_data.data(), event.m_data.size(), event.m_source_ip, ARTNET_UDP_PORT, event.m_local_port, event.m_local_ip ) ) {
+        queued_arrivals.push_back( start_us + event.m_time_us );
+      }
+      result.m_packets_offered++;
+    }
+
+    queued_before = HostNetwork::Queued();
+    taken         = 0;
+    bool is_dmx_busy = IsDMXBusy( now_us );
+
+    auto cpu_start = std::chrono::steady_clock::now();
+    m_node->Update();
+    auto cpu_end   = std::chrono::steady_clock::now();
+
+    uint64_t elapsed_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( cpu_end - cpu_start ).count();
+    size_t   consumed   = queued_before - std::min( queued_before, HostNetwork::Queued() );
+    take_read_packets();
+
+    result.m_update_ns_total += elapsed_ns;
+    result.m_loop_iterations++;
+    if( consumed > 0 ) {
+      result.m_packets_consumed += consumed;
+      for( size_t i = 0; i < consumed; i++ ) {
+        result.m_packet_ns.push_back( elapsed_ns / consumed );
+      }
+    }
+
+    HostClock::Advance( m_options.m_loop_us );
+    if( m_options.m_stall_period_us != 0 && HostClock::NowMicros() >= next_stall_us ) {
+      HostClock::Advance( m_options.m_stall_us );
+      next_stall_us += m_options.m_stall_period_us;
+    }
+
+    if( is_dmx_busy ) {
+      result.m_dmx_busy_us        += HostClock::NowMicros() - now_us;
+      result.m_packets_during_dmx += consumed;
+    }
+  }
+
+  HostDMX::s_send_hook = previous_hook;
+
+  result.m_sim_duration_us = HostClock::NowMicros() - start_us;
+  result.m_dmx_frames      = FramesSent( result.m_port_frames ) - frames_start;
+  for( int dmx_num = 0; dmx_num < DMX_NUM_MAX; dmx_num++ ) {
+    result.m_port_frames[ dmx_num ] -= port_frames_start[ dmx_num ];
+  }
+  result.m_dmx_wait_us     = WaitMicros() - wait_start;
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    result.m_port_started[ i ] = m_node->GetDMXPort( i ).IsStarted();
+    result.m_frame_stats[ i ]  = m_node->GetDMXPort( i ).GetScheduler().GetStats();
+    result.m_jitter_stats[ i ] = m_node->GetDMXPort( i ).GetJitterBuffer().GetStats();
+  }
+  result.m_receive_stats   = m_node->GetReceiveStats();
+  result.m_sacn_stats      = m_node->GetSACNReceiveStats();
+  result.m_bytes_read      = HostNetwork::s_counters.m_bytes_read - bytes_start;
+  result.m_packets_dropped = HostNetwork::s_counters.m_dropped_queue_full + HostNetwork::s_counters.m_dropped_no_socket - dropped_start;
+
+  return result;
+}
+
+static uint64_t Percentile( std::vector<uint64_t>& sorted, double fraction ) {
+  if( sorted.empty() ) {
+    return 0;
+  }
+  size_t index = (size_t)( fraction * ( sorted.size() - 1 ) + 0.5 );
+  return sorted[ std::min( index, sorted.size() - 1 ) ];
+}
+
+void ReplayHarness::PrintResult( const char* name, const Result& result ) {
+  std::vector<uint64_t> packet_ns = result.m_packet_ns;
+  std::sort( packet_ns.begin(), packet_ns.end() );
+
+  double sim_seconds    = result.m_sim_duration_us / 1e6;
+  double cpu_seconds    = result.m_update_ns_total / 1e9;
+  double packet_ns_mean = 0;
+  for( uint64_t ns : packet_ns ) {
+    packet_ns_mean += ns;
+  }
+  packet_ns_mean = packet_ns.empty() ? 0 : packet_ns_mean / packet_ns.size();
+
+  printf( "%s\n", name );
+  printf( "  simulated time      : %.3f s, %llu loop iterations\n", sim_seconds, (unsigned long long)result.m_loop_iterations );
+  printf( "  packets             : %llu offered, %llu consumed, %llu dropped\n",
+          (unsigned long long)result.m_packets_offered, (unsigned long long)result.m_packets_consumed, (unsigned long long)result.m_packets_dropped );
+  printf( "  packets/sec         : %.1f simulated, %.0f host CPU\n",
+          sim_seconds > 0 ? result.m_packets_consumed / sim_seconds : 0.0, cpu_seconds > 0 ? result.m_packets_consumed / cpu_seconds : 0.0 );
+  printf( "  CPU per packet (ns) : mean %.0f, p50 %llu, p99 %llu, max %llu\n", packet_ns_mean,
+          (unsigned long long)Percentile( packet_ns, 0.50 ), (unsigned long long)Percentile( packet_ns, 0.99 ),
+          (unsigned long long)( packet_ns.empty() ? 0 : packet_ns.back() ) );
+  std::vector<uint64_t> latency_us = result.m_latency_us;
+  std::sort( latency_us.begin(), latency_us.end() );
+  printf( "  packet to break (us): p50 %llu, p95 %llu, p99 %llu, max %llu\n",
+          (unsigned long long)Percentile( latency_us, 0.50 ), (unsigned long long)Percentile( latency_us, 0.95 ),
+          (unsigned long long)Percentile( latency_us, 0.99 ), (unsigned long long)( latency_us.empty() ? 0 : latency_us.back() ) );
+  printf( "  Art-Net filter      : %u accepted, %u rejected from the header, %u invalid; %.0f bytes read per packet\n",
+          result.m_receive_stats.m_accepted_packets, result.m_receive_stats.m_rejected_packets, result.m_receive_stats.m_invalid_packets,
+          result.m_packets_consumed > 0 ? (double)result.m_bytes_read / result.m_packets_consumed : 0.0 );
+  printf( "  Art-Net sequence    : %u stale frames dropped, %u gaps, %u frames missing\n",
+          result.m_receive_stats.m_stale_frames, result.m_receive_stats.m_sequence_gaps, result.m_receive_stats.m_missed_frames );
+  printf( "  Art-Net frames      : %u applied, %u coalesced, %u drains over budget\n",
+          result.m_receive_stats.m_dmx_frames, result.m_receive_stats.m_coalesced_frames, result.m_receive_stats.m_budget_exceeded );
+  if( result.m_receive_stats.m_sync_commits + result.m_receive_stats.m_sync_ignored != 0 ) {
+    printf( "  Art-Net sync        : %u commits, %u ignored while merging, %u timeouts\n",
+            result.m_receive_stats.m_sync_commits, result.m_receive_stats.m_sync_ignored, result.m_receive_stats.m_sync_timeouts );
+  }
+  if( result.m_sacn_stats.m_packets != 0 ) {
+    printf( "  sACN filter         : %u accepted, %u rejected, %u invalid\n",
+            result.m_sacn_stats.m_accepted_packets, result.m_sacn_stats.m_rejected_packets, result.m_sacn_stats.m_invalid_packets );
+    printf( "  sACN sources        : %u stale frames dropped, %u outranked, %u stream terminated, %u from too many sources\n",
+            result.m_sacn_stats.m_stale_frames, result.m_sacn_stats.m_outranked_frames, result.m_sacn_stats.m_terminated_packets,
+            result.m_sacn_stats.m_ignored_frames );
+  }
+  printf( "  DMX frames emitted  : %llu (%.1f fps)\n", (unsigned long long)result.m_dmx_frames, sim_seconds > 0 ? result.m_dmx_frames / sim_seconds : 0.0 );
+  for( int dmx_num = 0; dmx_num < DMX_NUM_MAX; dmx_num++ ) {
+    if( result.m_port_frames[ dmx_num ] != 0 ) {
+      printf( "    DMX_NUM_%d         : %llu (%.1f fps)\n", dmx_num, (unsigned long long)result.m_port_frames[ dmx_num ],
+              sim_seconds > 0 ? result.m_port_frames[ dmx_num ] / sim_seconds : 0.0 );
+    }
+  }
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    const DMXFrameScheduler::Stats& stats = result.m_frame_stats[ i ];
+    if( !result.m_port_started[ i ] || stats.m_frames < 2 ) {
+      continue;
+    }
+    uint32_t intervals = stats.m_frames - 1;
+    printf( "  port %d refresh (us) : interval min %u, mean %.0f, max %u; jitter mean %.1f, max %u; %u late\n", i + 1,
+            stats.m_interval_min_us, (double)stats.m_interval_sum_us / intervals, stats.m_interval_max_us,
+            (double)stats.m_jitter_sum_us / intervals, stats.m_jitter_max_us, stats.m_late );
+  }
+  for( int i = 0; i < DMX_PORT_MAX; i++ ) {
+    const DMXJitterBuffer::Stats& stats = result.m_jitter_stats[ i ];
+    if( !result.m_port_started[ i ] || stats.m_frames == 0 ) {
+      continue;
+    }
+    printf( "  port %d jitter buffer: %u frames, %u played, %u underruns, %u overruns, %u skipped; wait mean %.1f ms, max %.1f ms; cadence %.1f ms, depth max %u\n",
+            i + 1, stats.m_frames, stats.m_played, stats.m_underruns, stats.m_overruns, stats.m_skipped,
+            stats.m_played ? stats.m_wait_sum_us / 1e3 / stats.m_played : 0.0, stats.m_wait_max_us / 1e3, stats.m_cadence_us / 1e3, stats.m_depth_max );
+  }
+  printf( "  DMX blocking        : %.1f ms in dmx_wait_sent\n", result.m_dmx_wait_us / 1e3 );
+  printf( "  drain while sending : %llu packets in %.3f s on the wire (%.1f packets/sec)\n",
+          (unsigned long long)result.m_packets_during_dmx, result.m_dmx_busy_us / 1e6,
+          result.m_dmx_busy_us > 0 ? result.m_packets_during_dmx / ( result.m_dmx_busy_us / 1e6 ) : 0.0 );
+}
+
+std::vector<uint8_t> ReplayHarness::BuildArtDMX( uint16_t universe, uint8_t sequence, const uint8_t* data, uint16_t length ) {
+  std::vector<uint8_t> packet( ARTNET_PACKET_PAYLOAD_START + 8 + length );
+
+  memcpy( &packet[ 0 ], ARTNET_HEADER_ID, 8 );
+  packet[ 8 ]  = ARTNET_OPCODE_DMX & 0xFF;
+  packet[ 9 ]  = ARTNET_OPCODE_DMX >> 8;
+  packet[ 10 ] = 0;
+  packet[ 11 ] = ARTNET_VERSION;
+  packet[ 12 ] = sequence;
+  packet[ 13 ] = 0;
+  packet[ 14 ] = universe & 0xFF;
+  packet[ 15 ] = ( universe >> 8 ) & 0x7F;
+  packet[ 16 ] = length >> 8;
+  packet[ 17 ] = length & 0xFF;
+  memcpy( &packet[ 18 ], data, length );
+
+  return packet;
+}
+
+std::vector<uint8_t> ReplayHarness::BuildE131( const uint8_t* cid, uint16_t universe, uint8_t priority, uint8_t sequence, uint8_t options,
+                                               const uint8_t* data, uint16_t length ) {
+  std::vector<uint8_t> packet( E131_OFFSET_DMX_DATA + length );
+  size_t end = packet.size();
+
+  auto write16 = [&]( size_t offset, uint16_t value ) {
+    packet[ offset ]     = value >> 8;
+    packet[ offset + 1 ] = value & 0xFF;
+  };
+  auto write32 = [&]( size_t offset, uint32_t value ) {
+    write16( offset, value >> 16 );
+    write16( offset + 2, value & 0xFFFF );
+  };
+
+  write16( E131_OFFSET_PREAMBLE, 0x0010 );
+  memcpy( &packet[ E131_OFFSET_ACN_ID ], E131_ACN_ID, 12 );
+  write16( E131_OFFSET_ROOT_LENGTH, 0x7000 | ( end - E131_OFFSET_ROOT_LENGTH ) );
+  write32( E131_OFFSET_ROOT_VECTOR, E131_VECTOR_ROOT_DATA );
+  memcpy( &packet[ E131_OFFSET_CID ], cid, 16 );
+  write16( E131_OFFSET_FRAMING_LENGTH, 0x7000 | ( end - E131_OFFSET_FRAMING_LENGTH ) );
+  write32( E131_OFFSET_FRAMING_VECTOR, E131_VECTOR_FRAMING_DATA );
+  snprintf( (char*)&packet[ E131_OFFSET_SOURCE_NAME ], 64, "replay %02x%02x", cid[ 0 ], cid[ 1 ] );
+  packet[ E131_OFFSET_PRIORITY ] = priority;
+  packet[ E131_OFFSET_SEQUENCE ] = sequence;
+  packet[ E131_OFFSET_OPTIONS ]  = options;
+  write16( E131_OFFSET_UNIVERSE, universe );
+  write16( E131_OFFSET_DMP_LENGTH, 0x7000 | ( end - E131_OFFSET_DMP_LENGTH ) );
+  packet[ E131_OFFSET_DMP_VECTOR ]   = E131_VECTOR_DMP_SET_PROPERTY;
+  packet[ E131_OFFSET_ADDRESS_TYPE ] = E131_DMP_ADDRESS_DATA_TYPE;
+  write16( E131_OFFSET_ADDRESS_INCREMENT, 0x0001 );
+  write16( E131_OFFSET_VALUE_COUNT, length + 1 );
+  memcpy( &packet[ E131_OFFSET_DMX_DATA ], data, length );
+
+  return packet;
+}
+
+std::vector<ReplayHarness::Event> ReplayHarness::SyntheticStream( uint16_t first_universe, int universes, double rate_hz, double seconds, uint16_t channels, IPAddress source_ip ) {
+  std::vector<Event> events;
+  uint64_t period_us = (uint64_t)( 1e6 / rate_hz );
+  uint64_t end_us    = (uint64_t)( seconds * 1e6 );
+  uint8_t  data[ 512 ];
+  uint8_t  sequence  = 1;
+
+  for( uint64_t time_us = 0, frame = 0; time_us < end_us; time_us += period_us, frame++ ) {
+    for( int u = 0; u < universes; u++ ) {
+      // A slow ramp so consecutive frames differ, offset per channel.
+      for( int channel = 0; channel < channels; channel++ ) {
+        data[ channel ] = (uint8_t)( frame + channel + u );
+      }
+      Event event;
+      // Spread universes of one frame over the period, like a console does.
+      event.m_time_us    = time_us + ( period_us * u ) / ( universes * 2 );
+      event.m_data       = BuildArtDMX( first_universe + u, sequence, data, channels );
+      event.m_source_ip  = source_ip;
+      event.m_local_port = ARTNET_UDP_PORT;
+      event.m_local_ip   = IPAddress( 192, 168, 1, 1 );
+      events.push_back( event );
+    }
+    sequence = ( sequence == 255 ) ? 1 : sequence + 1;
+  }
+
+  std::stable_sort( events.begin(), events.end(), []( const Event& a, const Event& b ) { return a.m_time_us < b.m_time_us; } );
+  return events;
+}
+
+void ReplayHarness::Impair( std::vector<Event>& events, double reorder, double loss, uint32_t seed ) {
+  std::mt19937 random( seed );
+  std::uniform_real_distribution<double> chance( 0, 1 );
+
+  std::vector<Event> impaired;
+  for( size_t i = 0; i < events.size(); i++ ) {
+    if( chance( random ) < loss ) {
+      continue;
+    }
+    if( chance( random ) < reorder && events[ i ].m_data.size() >= 16 ) {
+      // The data arrives in each other's time slots, so the later frame comes first.
+      for( size_t j = i + 1; j < events.size() && j < i + 64; j++ ) {
+        if( events[ j ].m_data.size() >= 16 && memcmp( &events[ j ].m_data[ 14 ], &events[ i ].m_data[ 14 ], 2 ) == 0 ) {
+          std::swap( events[ i ].m_data, events[ j ].m_data );
+          break;
+        }
+      }
+    }
+    impaired.push_back( events[ i ] );
+  }
+  events.swap( impaired );
+}
+
+static uint32_t ReadU32( const uint8_t* p, bool swap ) {
+  uint32_t v = (uint32_t)p[ 0 ] | ( (uint32_t)p[ 1 ] << 8 ) | ( (uint32_t)p[ 2 ] << 16 ) | ( (uint32_t)p[ 3 ] << 24 );
+  return swap ? __builtin_bswap32( v ) : v;
+}
+
+static uint16_t ReadBE16( const uint8_t* p ) {
+  return (uint16_t)( ( p[ 0 ] << 8 ) | p[ 1 ] );
+}
+
+bool ReplayHarness::LoadPcap( const char* path, std::vector<Event>& events ) {
+  FILE* file = fopen( path, "rb" );
+  if( file == nullptr ) {
+    return false;
+  }
+
+  uint8_t global[ 24 ];
+  if( fread( global, 1, sizeof( global ), file ) != sizeof( global ) ) {
+    fclose( file );
+    return false;
+  }
+
+  uint32_t magic = ReadU32( global, false );
+  bool     swap;
+  bool     nanoseconds;
+  if( magic == 0xA1B2C3D4 || magic == 0xA1B23C4D ) {
+    swap = false;
+    nanoseconds = ( magic == 0xA1B23C4D );
+  } else if( magic == 0xD4C3B2A1 || magic == 0x4D3CB2A1 ) {
+    swap = true;
+    nanoseconds = ( magic == 0x4D3CB2A1 );
+  } else {
+    fclose( file );
+    return false;
+  }
+  uint32_t link_type = ReadU32( &global[ 20 ], swap );
+
+  uint64_t first_us = 0;
+  bool     have_first = false;
+  uint8_t  record[ 16 ];
+  std::vector<uint8_t> frame;
+
+  while( fread( record, 1, sizeof( record ), file ) == sizeof( record ) ) {
+    uint32_t seconds  = ReadU32( &record[ 0 ], swap );
+    uint32_t fraction = ReadU32( &record[ 4 ], swap );
+    uint32_t captured = ReadU32( &record[ 8 ], swap );
+
+    frame.resize( captured );
+    if( fread( frame.data(), 1, captured, file ) != captured ) {
+      break;
+    }
+
+    size_t offset;
+    if( link_type == 1 ) {            // Ethernet, with optional 802.1Q tag.
+      if( captured < 14 ) continue;
+      uint16_t ether_type = ReadBE16( &frame[ 12 ] );
+      offset = 14;
+      if( ether_type == 0x8100 && captured >= 18 ) {
+        ether_type = ReadBE16( &frame[ 16 ] );
+        offset = 18;
+      }
+      if( ether_type != 0x0800 ) continue;
+    } else if( link_type == 113 ) {   // Linux cooked capture.
+      if( captured < 16 || ReadBE16( &frame[ 14 ] ) != 0x0800 ) continue;
+      offset = 16;
+    } else if( link_type == 101 || link_type == 12 ) {
+      offset = 0;
+    } else {
+      continue;
+    }
+
+    if( captured < offset + 20 || ( frame[ offset ] >> 4 ) != 4 ) continue;
+    size_t ip_header_len = ( frame[ offset ] & 0x0F ) * 4;
+    if( frame[ offset + 9 ] != 17 || captured < offset + ip_header_len + 8 ) continue;
+
+    IPAddress source_ip( frame[ offset + 12 ], frame[ offset + 13 ], frame[ offset + 14 ], frame[ offset + 15 ] );
+    IPAddress dest_ip( frame[ offset + 16 ], frame[ offset + 17 ], frame[ offset + 18 ], frame[ offset + 19 ] );
+
+    size_t   udp        = offset + ip_header_len;
+    uint16_t dest_port  = ReadBE16( &frame[ udp + 2 ] );
+    uint16_t udp_length = ReadBE16( &frame[ udp + 4 ] );
+    size_t   payload    = udp + 8;
+    size_t   length     = std::min( (size_t)( udp_length >= 8 ? udp_length - 8 : 0 ), captured - payload );
+
+    uint64_t time_us = (uint64_t)seconds * 1000000 + ( nanoseconds ? fraction / 1000 : fraction );
+    if( !have_first ) {
+      first_us   = time_us;
+      have_first = true;
+    }
+
+    Event event;
+    event.m_time_us    = time_us >= first_us ? time_us - first_us : 0;
+    event.m_data.assign( frame.begin() + payload, frame.begin() + payload + length );
+    event.m_source_ip  = source_ip;
+    event.m_local_port = dest_port;
+    // Broadcast and unicast both land on the node's own socket; keep multicast groups as captured.
+    event.m_local_ip   = ( ( dest_ip[ 0 ] & 0xF0 ) == 0xE0 ) ? dest_ip : IPAddress( 192, 168, 1, 1 );
+    events.push_back( event );
+  }
+
+  fclose( file );
+  return true;
+}
+
+bool ReplayHarness::SavePcap( const char* path, const std::vector<Event>& events ) {
+  FILE* file = fopen( path, "wb" );
+  if( file == nullptr ) {
+    return false;
+  }
+
+  // Little endian, microseconds, raw IPv4.
+  uint32_t global[ 6 ] = { 0xA1B2C3D4, 0x00040002, 0, 0, 65535, 101 };
+  fwrite( global, sizeof( global ), 1, file );
+
+  for( const Event& event : events ) {
+    std::vector<uint8_t> frame( 28 + event.m_data.size(), 0 );
+    uint16_t ip_length  = (uint16_t)frame.size();
+    uint16_t udp_length = (uint16_t)( 8 + event.m_data.size() );
+    frame[ 0 ]  = 0x45;
+    frame[ 2 ]  = ip_length >> 8;
+    frame[ 3 ]  = ip_length & 0xFF;
+    frame[ 8 ]  = 64;
+    frame[ 9 ]  = 17;
+    for( int i = 0; i < 4; i++ ) {
+      frame[ 12 + i ] = event.m_source_ip[ i ];
+      frame[ 16 + i ] = event.m_local_ip[ i ];
+    }
+    frame[ 20 ] = event.m_local_port >> 8;    // Events don't keep the source port, the destination stands in.
+    frame[ 21 ] = event.m_local_port & 0xFF;
+    frame[ 22 ] = event.m_local_port >> 8;
+    frame[ 23 ] = event.m_local_port & 0xFF;
+    frame[ 24 ] = udp_length >> 8;
+    frame[ 25 ] = udp_length & 0xFF;
+    memcpy( &frame[ 28 ], event.m_data.data(), event.m_data.size() );
+
+    uint32_t record[ 4 ] = { (uint32_t)( event.m_time_us / 1000000 ), (uint32_t)( event.m_time_us % 1000000 ), (uint32_t)frame.size(), (uint32_t)frame.size() };
+    fwrite( record, sizeof( record ), 1, file );
+    fwrite( frame.data(), frame.size(), 1, file );
+  }
+
+  return fclose( file ) == 0;
+}
@@ -0,0 +1,99 @@
+#ifndef _REPLAY_HARNESS_H_
+#define _REPLAY_HARNESS_H_
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include <WebServer.h>
+
+#include "ESP32Artnet2DMX.h"
+
+// Drives an ESP32Artnet2DMX instance on the host the same way the sketch's
+// setup()/loop() does, feeding it a timed stream of UDP datagrams.
+//
+// Time on the node is simulated (see HostClock); the CPU time spent inside
+// Update() is measured with the host's real clock.
+class ReplayHarness {
+public:
+  struct Event {
+    uint64_t             m_time_us;     // Arrival time, relative to the start of the replay.
+    std::vector<uint8_t> m_data;
+    IPAddress            m_source_ip;
+    uint16_t             m_local_port;
+    IPAddress            m_local_ip;
+  };
+
+  struct Options {
+    uint64_t m_loop_us     = 50;   // Simulated device time one loop() iteration costs on top of any blocking.
+    size_t   m_queue_depth = 16;   // Receive queue depth of each UDP socket.
+    bool     m_serial      = false;
+    bool     m_use_tasks   = false; // Run the node's receive and transmit tasks as threads, instead of inline in Update().
+    uint64_t m_start_us    = 0;     // Simulated time at start, e.g. just before the micros() or millis() wrap.
+    uint64_t m_stall_us    = 0;     // Every m_stall_period_us one loop() iteration blocks this long,
+    uint64_t m_stall_period_us = 0; // like a flash write or a slow web request would.
+    uint64_t m_read_step_us = 0;    // Simulated time each millis() or micros() the node calls takes, see HostClock.
+  };
+
+  struct Result {
+    uint64_t              m_sim_duration_us;
+    uint64_t              m_loop_iterations;
+    uint64_t              m_packets_offered;
+    uint64_t              m_packets_consumed;
+    uint64_t              m_packets_dropped;
+    uint64_t              m_bytes_read;           // Copied out of the UDP socket by the node.
+    uint64_t              m_dmx_frames;
+    uint64_t              m_port_frames[ DMX_NUM_MAX ];   // Frames per esp_dmx port.
+    uint64_t              m_dmx_wait_us;          // Time loop() spent blocked in dmx_wait_sent().
+    uint64_t              m_dmx_busy_us;          // Time at least one port was on the wire.
+    uint64_t              m_packets_during_dmx;   // Packets consumed while a port was on the wire.
+    bool                  m_port_started[ DMX_PORT_MAX ];
+    DMXFrameScheduler::Stats m_frame_stats[ DMX_PORT_MAX ];  // Refresh timing per DMX port.
+    DMXJitterBuffer::Stats   m_jitter_stats[ DMX_PORT_MAX ]; // Per DMX port, when its jitter buffer is on.
+    ArtNetReceiveStats    m_receive_stats;        // The node's own counts, since it was last started.
+    SACNReceiveStats      m_sacn_stats;
+    uint64_t              m_update_ns_total;
+    std::vector<uint64_t> m_packet_ns;      // CPU time per consumed packet.
+    std::vector<uint64_t> m_latency_us;     // Arrival of each packet to the break of the first DMX frame started after it was read.
+  };
+
+  explicit ReplayHarness( const Options& options );
+  ~ReplayHarness();
+
+  // Equivalent of the sketch's setup().  Optional JSON replaces /config.json first.
+  void Setup( const char* config_json = nullptr );
+
+  // Replays the events, then keeps looping for tail_us of simulated time.
+  Result Run( const std::vector<Event>& events, uint64_t tail_us = 0 );
+
+  ESP32Artnet2DMX& Node() { return *m_node; }
+  WebServer& Server() { return m_server; }
+
+  static void PrintResult( const char* name, const Result& result );
+
+  static std::vector<uint8_t> BuildArtDMX( uint16_t universe, uint8_t sequence, const uint8_t* data, uint16_t length );
+
+  // An E1.31 data packet from the source with the given 16 byte CID.
+  static std::vector<uint8_t> BuildE131( const uint8_t* cid, uint16_t universe, uint8_t priority, uint8_t sequence, uint8_t options,
+                                         const uint8_t* data, uint16_t length );
+
+  // Universes [first_universe, first_universe + universes) each sent at rate_hz.
+  static std::vector<Event> SyntheticStream( uint16_t first_universe, int universes, double rate_hz, double seconds, uint16_t channels, IPAddress source_ip );
+
+  // Like a poor WiFi link : each ArtDMX frame is lost with probability loss, or
+  // else swapped with the next frame of its universe with probability reorder.
+  static void Impair( std::vector<Event>& events, double reorder, double loss, uint32_t seed );
+
+  // Reads UDP datagrams from a classic libpcap capture (Ethernet, Linux SLL or raw IP).
+  static bool LoadPcap( const char* path, std::vector<Event>& events );
+
+  // Writes the events as a raw IP capture LoadPcap() reads back, e.g. to keep a built stream.
+  static bool SavePcap( const char* path, const std::vector<Event>& events );
+
+private:
+  Options                          m_options;
+  WebServer                        m_server;
+  std::unique_ptr<ESP32Artnet2DMX> m_node;
+};
+
+#endif
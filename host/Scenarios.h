@@ -0,0 +1,61 @@
+#ifndef _SCENARIOS_H_
+#define _SCENARIOS_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// Command line of one artnet_replay scenario : positional arguments and --name value options.
+struct Arguments {
+  std::vector<std::string>           m_positional;
+  std::map<std::string, std::string> m_options;
+
+  bool Has( const char* name ) const { return m_options.count( name ) != 0; }
+
+  double Number( const char* name, double fallback ) const {
+    auto it = m_options.find( name );
+    return it == m_options.end() ? fallback : atof( it->second.c_str() );
+  }
+
+  std::string Text( const char* name, const char* fallback ) const {
+    auto it = m_options.find( name );
+    return it == m_options.end() ? std::string( fallback ) : it->second;
+  }
+};
+
+// Average host CPU time of one call of function, in nanoseconds.
+template <typename Function>
+double MeasureNs( Function function, uint64_t iterations ) {
+  auto start = std::chrono::steady_clock::now();
+  for( uint64_t i = 0; i < iterations; i++ ) {
+    function();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>( end - start ).count() / iterations;
+}
+
+// Keeps the optimiser from discarding benchmark results.
+template <typename T>
+inline void KeepAlive( const T& value ) {
+  asm volatile( "" : : "g"( &value ) : "memory" );
+}
+
+int BenchRouting( const Arguments& arguments );
+int BenchUniverses( const Arguments& arguments );
+int StressTripleBuffer( const Arguments& arguments );
+int BenchLatency( const Arguments& arguments );
+int FuzzArtNetParser( const Arguments& arguments );
+int BenchParser( const Arguments& arguments );
+int BenchMerge( const Arguments& arguments );
+int BenchCurves( const Arguments& arguments );
+int BenchInterpolation( const Arguments& arguments );
+int BenchJitter( const Arguments& arguments );
+int BenchPoll( const Arguments& arguments );
+int BenchSync( const Arguments& arguments );
+int BenchSACN( const Arguments& arguments );
+int BenchStats( const Arguments& arguments );
+
+#endif
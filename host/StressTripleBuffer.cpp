@@ -0,0 +1,137 @@
+// Torn frame stress test for the receive -> transmit hand-off.
+//
+// First a writer and a reader thread hammer a DMXTripleBuffer directly, then
+// the node itself runs with its receive and transmit tasks as threads while
+// Art-Net is delivered as fast as it is consumed.  Every frame carries a
+// pattern that any mix of two frames breaks.
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "DMXTripleBuffer.h"
+#include "HostNetwork.h"
+#include "ReplayHarness.h"
+#include "Scenarios.h"
+
+// Slots 1 - 4 hold the sequence number, the rest a pattern derived from it.
+static void FillFrame( uint8_t* frame, uint32_t sequence ) {
+  frame[ 0 ] = 0;
+  memcpy( &frame[ 1 ], &sequence, sizeof( sequence ) );
+  for( int slot = 5; slot < DMX_PACKET_SIZE; slot++ ) {
+    frame[ slot ] = (uint8_t)( sequence * 31 + slot );
+  }
+}
+
+static bool IsFrameWhole( const uint8_t* frame, uint32_t& sequence ) {
+  memcpy( &sequence, &frame[ 1 ], sizeof( sequence ) );
+  for( int slot = 5; slot < DMX_PACKET_SIZE; slot++ ) {
+    if( frame[ slot ] != (uint8_t)( sequence * 31 + slot ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool StressBuffer( double seconds ) {
+  DMXTripleBuffer triple_buffer;
+  FillFrame( triple_buffer.GetWriteBuffer(), 0 );
+  triple_buffer.Publish();
+
+  std::atomic<bool> is_running( true );
+  uint64_t published = 0;
+
+  std::thread writer( [&]() {
+    uint32_t sequence = 1;
+    while( is_running.load( std::memory_order_relaxed ) ) {
+      FillFrame( triple_buffer.GetWriteBuffer(), sequence++ );
+      triple_buffer.Publish();
+      published++;
+    }
+  } );
+
+  uint64_t acquired = 0, torn = 0, backwards = 0;
+  uint32_t last_sequence = 0;
+  auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>( seconds );
+  while( std::chrono::steady_clock::now() < end ) {
+    for( int i = 0; i < 1000; i++ ) {
+      if( !triple_buffer.Acquire() ) {
+        continue;
+      }
+      acquired++;
+      uint32_t sequence;
+      if( !IsFrameWhole( triple_buffer.GetReadBuffer(), sequence ) ) {
+        torn++;
+      } else if( sequence < last_sequence ) {
+        backwards++;
+      } else {
+        last_sequence = sequence;
+      }
+    }
+  }
+
+  is_running = false;
+  writer.join();
+
+  printf( "  triple buffer : %llu published, %llu acquired, %llu torn, %llu out of order\n",
+          (unsigned long long)published, (unsigned long long)acquired, (unsigned long long)torn, (unsigned long long)backwards );
+  return torn == 0 && backwards == 0 && acquired > 0;
+}
+
+static bool StressNode( const Arguments& arguments, double seconds ) {
+  ReplayHarness::Options options;
+  options.m_queue_depth = (size_t)arguments.Number( "queue", 16 );
+  options.m_use_tasks   = true;
+
+  // Send continuously so the transmit task reads frames as often as it can.
+  ReplayHarness harness( options );
+  harness.Setup( "{\"artnet_source_ip\":\"255.255.255.255\",\"artnet_universe\":1,\"artnet_timeout_ms\":0,\"dmx_update_interval_ms\":0}" );
+
+  // Frames sent before the first packet arrives are still blank.
+  static const uint8_t blank[ DMX_PACKET_SIZE ] = {};
+
+  std::atomic<uint64_t> frames( 0 ), torn( 0 );
+  HostDMX::s_send_hook = [&]( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size ) {
+    uint32_t sequence;
+    if( memcmp( frame, blank, DMX_PACKET_SIZE ) == 0 ) {
+      return;
+    }
+    frames++;
+    if( !IsFrameWhole( frame, sequence ) ) {
+      torn++;
+    }
+  };
+
+  uint8_t frame[ DMX_PACKET_SIZE ];
+  uint64_t delivered = 0;
+  uint32_t sequence  = 0;
+  auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>( seconds );
+  while( std::chrono::steady_clock::now() < end ) {
+    FillFrame( frame, ++sequence );
+    std::vector<uint8_t> packet = ReplayHarness::BuildArtDMX( 1, (uint8_t)sequence, &frame[ 1 ], 512 );
+    while( !HostNetwork::Deliver( packet.data(), packet.size(), IPAddress( 192, 168, 1, 100 ), ARTNET_UDP_PORT, ARTNET_UDP_PORT ) ) {
+      std::this_thread::yield();
+    }
+    delivered++;
+  }
+
+  // Waits for the tasks to finish before the hook goes out of scope.
+  harness.Node().Stop();
+  HostDMX::s_send_hook = nullptr;
+
+  printf( "  node tasks    : %llu packets received, %llu DMX frames sent, %llu torn\n",
+          (unsigned long long)delivered, (unsigned long long)frames.load(), (unsigned long long)torn.load() );
+  return torn == 0 && frames > 0;
+}
+
+int StressTripleBuffer( const Arguments& arguments ) {
+  double seconds = arguments.Number( "seconds", 2 );
+
+  printf( "triplebuffer: torn frame stress, %.1f s per stage\n", seconds );
+  bool is_buffer_ok = StressBuffer( seconds );
+  bool is_node_ok   = StressNode( arguments, seconds );
+
+  printf( "  %s\n", is_buffer_ok && is_node_ok ? "PASS" : "FAIL" );
+  return is_buffer_ok && is_node_ok ? 0 : 1;
+}
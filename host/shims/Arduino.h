@@ -0,0 +1,136 @@
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+// Host (Linux) stand-in for the Arduino core.
+//
+// Only the parts of the ESP32 Arduino API used by the sketch are provided.
+// Time is simulated : millis()/micros() read a virtual clock that is advanced
+// by delay(), by the esp_dmx shim while a frame is on the wire and by the
+// replay driver between loop iterations.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "HostClock.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay( unsigned long ms );
+void delayMicroseconds( unsigned int us );
+void yield();
+
+void randomSeed( unsigned long seed );
+long random( long howbig );
+long random( long howsmall, long howbig );
+
+class String {
+public:
+  String() {}
+  String( const char* str ) : m_str( str ? str : "" ) {}
+  String( const std::string& str ) : m_str( str ) {}
+  String( char c ) : m_str( 1, c ) {}
+  String( int value ) : m_str( std::to_string( value ) ) {}
+  String( unsigned int value ) : m_str( std::to_string( value ) ) {}
+  String( long value ) : m_str( std::to_string( value ) ) {}
+  String( unsigned long value ) : m_str( std::to_string( value ) ) {}
+  String( long long value ) : m_str( std::to_string( value ) ) {}
+  String( unsigned long long value ) : m_str( std::to_string( value ) ) {}
+  String( unsigned char value ) : m_str( std::to_string( value ) ) {}
+  String( unsigned short value ) : m_str( std::to_string( value ) ) {}
+  String( short value ) : m_str( std::to_string( value ) ) {}
+  String( float value, unsigned int decimals = 2 );
+  String( double value, unsigned int decimals = 2 );
+
+  unsigned int length() const { return (unsigned int)m_str.length(); }
+  const char* c_str() const { return m_str.c_str(); }
+  bool isEmpty() const { return m_str.empty(); }
+
+  bool equals( const String& other ) const { return m_str == other.m_str; }
+  bool equals( const char* other ) const { return m_str == ( other ? other : "" ); }
+  bool equalsIgnoreCase( const String& other ) const { return strcasecmp( m_str.c_str(), other.m_str.c_str() ) == 0; }
+  bool startsWith( const String& prefix ) const { return m_str.compare( 0, prefix.m_str.length(), prefix.m_str ) == 0; }
+
+  int indexOf( char c, unsigned int from = 0 ) const;
+  int indexOf( const String& str, unsigned int from = 0 ) const;
+  String substring( unsigned int from ) const;
+  String substring( unsigned int from, unsigned int to ) const;
+  void trim();
+
+  long toInt() const { return strtol( m_str.c_str(), nullptr, 10 ); }
+  float toFloat() const { return strtof( m_str.c_str(), nullptr ); }
+
+  char operator[]( unsigned int index ) const { return index < m_str.length() ? m_str[ index ] : 0; }
+
+  String& operator+=( const String& rhs ) { m_str += rhs.m_str; return *this; }
+  String& operator+=( const char* rhs ) { m_str += rhs; return *this; }
+  String& operator+=( char rhs ) { m_str += rhs; return *this; }
+  template <typename T> String& operator+=( T rhs ) { m_str += String( rhs ).m_str; return *this; }
+
+  bool concat( const String& rhs ) { m_str += rhs.m_str; return true; }
+
+  bool operator==( const String& rhs ) const { return m_str == rhs.m_str; }
+  bool operator==( const char* rhs ) const { return equals( rhs ); }
+  bool operator!=( const String& rhs ) const { return m_str != rhs.m_str; }
+  bool operator!=( const char* rhs ) const { return !equals( rhs ); }
+  bool operator<( const String& rhs ) const { return m_str < rhs.m_str; }
+
+  const std::string& str() const { return m_str; }
+
+private:
+  std::string m_str;
+};
+
+inline String operator+( const String& lhs, const String& rhs ) { String s( lhs ); s += rhs; return s; }
+inline String operator+( const String& lhs, const char* rhs ) { String s( lhs ); s += rhs; return s; }
+inline String operator+( const char* lhs, const String& rhs ) { String s( lhs ); s += rhs; return s; }
+inline String operator+( const String& lhs, char rhs ) { String s( lhs ); s += rhs; return s; }
+template <typename T> inline String operator+( const String& lhs, T rhs ) { String s( lhs ); s += String( rhs ); return s; }
+
+#include "Print.h"
+#include "IPAddress.h"
+
+class HardwareSerial : public Print {
+public:
+  void begin( unsigned long baud ) { (void)baud; }
+  void end() {}
+  void flush() {}
+  operator bool() const { return true; }
+
+  size_t write( uint8_t c ) override;
+  size_t write( const uint8_t* buffer, size_t size ) override;
+
+  // Host only : Serial output is discarded unless echo is enabled, so that
+  // diagnostic printf calls in the hot path don't skew the benchmark.
+  void HostSetEcho( bool echo ) { m_echo = echo; }
+
+private:
+  bool m_echo = false;
+};
+
+extern HardwareSerial Serial;
+
+// The chip : the host has no heap to report, fixed values stand in.
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return m_host_free_heap; }
+  uint32_t getMinFreeHeap() { return m_host_min_free_heap; }
+
+  // Host only.
+  uint32_t m_host_free_heap     = 200000;
+  uint32_t m_host_min_free_heap = 180000;
+};
+
+extern EspClass ESP;
+
+#endif
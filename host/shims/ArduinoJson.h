@@ -0,0 +1,216 @@
+#ifndef _HOST_ARDUINOJSON_H_
+#define _HOST_ARDUINOJSON_H_
+
+// Host stand-in for the subset of the ArduinoJson (v6 style) API used by the
+// sketch.  Documents are a small tree of reference counted nodes; capacity
+// arguments are accepted and ignored.
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Arduino.h"
+#include "FS.h"
+
+namespace host_json {
+
+struct Node;
+typedef std::shared_ptr<Node> NodePtr;
+
+struct Node {
+  enum Type { Null, Bool, Int, Float, Str, Array, Object };
+
+  Type                                      m_type = Null;
+  bool                                      m_bool = false;
+  long long                                 m_int = 0;
+  double                                    m_float = 0;
+  std::string                               m_str;
+  std::vector<NodePtr>                      m_array;
+  std::vector<std::pair<std::string, NodePtr>> m_object;
+
+  NodePtr Find( const std::string& key ) const;
+  NodePtr FindOrCreate( const std::string& key );
+  void Clear() { m_type = Null; m_array.clear(); m_object.clear(); m_str.clear(); }
+};
+
+}
+
+class JsonArray;
+class JsonObject;
+
+class JsonVariant {
+public:
+  JsonVariant() {}
+  explicit JsonVariant( host_json::NodePtr node ) : m_node( node ) {}
+  JsonVariant( host_json::NodePtr parent, const std::string& key ) : m_parent( parent ), m_key( key ) {}
+
+  bool isNull() const { host_json::NodePtr node = this->Resolve(); return !node || node->m_type == host_json::Node::Null; }
+
+  template <typename T> T as() const;
+  template <typename T> bool is() const;
+  template <typename T> operator T() const { return this->as<T>(); }
+
+  JsonVariant operator[]( const char* key ) const;
+  JsonVariant operator[]( const String& key ) const { return ( *this )[ key.c_str() ]; }
+  JsonVariant operator[]( size_t index ) const;
+  JsonVariant operator[]( int index ) const { return ( *this )[ (size_t)index ]; }
+
+  JsonVariant& operator=( const JsonVariant& rhs );
+  JsonVariant& operator=( const String& value ) { this->SetString( value.str() ); return *this; }
+  JsonVariant& operator=( const char* value ) { this->SetString( value ? value : "" ); return *this; }
+  JsonVariant& operator=( bool value );
+  JsonVariant& operator=( float value ) { this->SetFloat( value ); return *this; }
+  JsonVariant& operator=( double value ) { this->SetFloat( value ); return *this; }
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+  JsonVariant& operator=( T value ) { this->SetInt( (long long)value ); return *this; }
+
+  JsonArray createNestedArray( const char* key );
+  JsonObject createNestedObject( const char* key );
+
+  host_json::NodePtr Resolve( bool create = false ) const;
+
+protected:
+  void SetString( const std::string& value );
+  void SetInt( long long value );
+  void SetFloat( double value );
+
+  mutable host_json::NodePtr m_node;
+  host_json::NodePtr         m_parent;
+  std::string                m_key;
+};
+
+class JsonArray {
+public:
+  class iterator {
+  public:
+    iterator( host_json::NodePtr node, size_t index ) : m_node( node ), m_index( index ) {}
+    JsonVariant operator*() const { return JsonVariant( m_node->m_array[ m_index ] ); }
+    iterator& operator++() { m_index++; return *this; }
+    bool operator!=( const iterator& rhs ) const { return m_index != rhs.m_index; }
+  private:
+    host_json::NodePtr m_node;
+    size_t             m_index;
+  };
+
+  JsonArray() {}
+  explicit JsonArray( host_json::NodePtr node ) : m_node( node ) {}
+
+  bool isNull() const { return !m_node; }
+  size_t size() const { return m_node ? m_node->m_array.size() : 0; }
+  iterator begin() const { return iterator( m_node, 0 ); }
+  iterator end() const { return iterator( m_node, this->size() ); }
+  JsonVariant operator[]( size_t index ) const { return index < this->size() ? JsonVariant( m_node->m_array[ index ] ) : JsonVariant(); }
+
+  template <typename T> bool add( T value ) {
+    if( !m_node ) return false;
+    host_json::NodePtr node = std::make_shared<host_json::Node>();
+    m_node->m_array.push_back( node );
+    JsonVariant target( node );
+    target = value;
+    return true;
+  }
+
+  JsonObject createNestedObject();
+  JsonArray createNestedArray();
+
+private:
+  host_json::NodePtr m_node;
+};
+
+class JsonObject {
+public:
+  JsonObject() {}
+  explicit JsonObject( host_json::NodePtr node ) : m_node( node ) {}
+
+  bool isNull() const { return !m_node; }
+  size_t size() const { return m_node ? m_node->m_object.size() : 0; }
+  JsonVariant operator[]( const char* key ) const { return m_node ? JsonVariant( m_node, key ) : JsonVariant(); }
+  JsonVariant operator[]( const String& key ) const { return ( *this )[ key.c_str() ]; }
+  bool containsKey( const char* key ) const { return m_node && m_node->Find( key ) != nullptr; }
+
+  JsonArray createNestedArray( const char* key );
+  JsonObject createNestedObject( const char* key );
+
+private:
+  host_json::NodePtr m_node;
+};
+
+class JsonDocument {
+public:
+  JsonDocument() : m_root( std::make_shared<host_json::Node>() ) {}
+  explicit JsonDocument( size_t capacity ) : m_root( std::make_shared<host_json::Node>() ) { (void)capacity; }
+
+  JsonVariant operator[]( const char* key ) { return JsonVariant( m_root, key ); }
+  JsonVariant operator[]( const String& key ) { return JsonVariant( m_root, key.str() ); }
+  bool containsKey( const char* key ) const { return m_root->Find( key ) != nullptr; }
+
+  JsonArray createNestedArray( const char* key ) { return JsonVariant( m_root ).createNestedArray( key ); }
+  JsonObject createNestedObject( const char* key ) { return JsonVariant( m_root ).createNestedObject( key ); }
+
+  template <typename T> T as() const { return JsonVariant( m_root ).as<T>(); }
+  void clear() { m_root->Clear(); }
+
+  host_json::NodePtr Root() const { return m_root; }
+
+private:
+  host_json::NodePtr m_root;
+};
+
+typedef JsonDocument DynamicJsonDocument;
+
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, InvalidInput };
+
+  DeserializationError( Code code = Ok ) : m_code( code ) {}
+  explicit operator bool() const { return m_code != Ok; }
+  Code code() const { return m_code; }
+  const char* c_str() const { return m_code == Ok ? "Ok" : ( m_code == EmptyInput ? "EmptyInput" : "InvalidInput" ); }
+
+private:
+  Code m_code;
+};
+
+size_t serializeJson( const JsonDocument& doc, File& file );
+size_t serializeJson( const JsonDocument& doc, String& output );
+size_t measureJson( const JsonDocument& doc );
+DeserializationError deserializeJson( JsonDocument& doc, File& file );
+DeserializationError deserializeJson( JsonDocument& doc, const String& input );
+
+template <> String JsonVariant::as<String>() const;
+template <> const char* JsonVariant::as<const char*>() const;
+template <> bool JsonVariant::as<bool>() const;
+template <> float JsonVariant::as<float>() const;
+template <> double JsonVariant::as<double>() const;
+template <> JsonArray JsonVariant::as<JsonArray>() const;
+template <> JsonObject JsonVariant::as<JsonObject>() const;
+template <> JsonVariant JsonVariant::as<JsonVariant>() const;
+
+template <typename T> T JsonVariant::as() const {
+  static_assert( std::is_integral<T>::value, "Unsupported JsonVariant conversion" );
+  host_json::NodePtr node = this->Resolve();
+  if( !node ) return 0;
+  switch( node->m_type ) {
+    case host_json::Node::Int:   return (T)node->m_int;
+    case host_json::Node::Float: return (T)node->m_float;
+    case host_json::Node::Bool:  return (T)node->m_bool;
+    case host_json::Node::Str:   return (T)strtoll( node->m_str.c_str(), nullptr, 10 );
+    default:                     return 0;
+  }
+}
+
+template <typename T> bool JsonVariant::is() const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node ) return false;
+  if( std::is_same<T, JsonArray>::value ) return node->m_type == host_json::Node::Array;
+  if( std::is_same<T, JsonObject>::value ) return node->m_type == host_json::Node::Object;
+  if( std::is_same<T, String>::value || std::is_same<T, const char*>::value ) return node->m_type == host_json::Node::Str;
+  if( std::is_same<T, bool>::value ) return node->m_type == host_json::Node::Bool;
+  if( std::is_floating_point<T>::value ) return node->m_type == host_json::Node::Float || node->m_type == host_json::Node::Int;
+  if( std::is_integral<T>::value ) return node->m_type == host_json::Node::Int;
+  return false;
+}
+
+#endif
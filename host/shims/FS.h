@@ -0,0 +1,47 @@
+#ifndef _HOST_FS_H_
+#define _HOST_FS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+
+// Minimal in-memory file system behind the LittleFS stand-in.
+class File {
+public:
+  File() {}
+  File( std::shared_ptr<std::string> data, bool write ) : m_data( data ), m_write( write ) {}
+
+  operator bool() const { return m_data != nullptr; }
+
+  size_t write( uint8_t c ) { if( !m_write || !m_data ) return 0; m_data->push_back( (char)c ); return 1; }
+  size_t write( const uint8_t* buffer, size_t size ) { if( !m_write || !m_data ) return 0; m_data->append( (const char*)buffer, size ); return size; }
+  int read() { if( !m_data || m_pos >= m_data->size() ) return -1; return (uint8_t)( *m_data )[ m_pos++ ]; }
+  int available() { return m_data ? (int)( m_data->size() - m_pos ) : 0; }
+  size_t size() const { return m_data ? m_data->size() : 0; }
+  void close() { m_data.reset(); }
+
+private:
+  std::shared_ptr<std::string> m_data;
+  bool                         m_write = false;
+  size_t                       m_pos = 0;
+};
+
+namespace fs {
+
+class FS {
+public:
+  bool begin( bool format_on_fail = false ) { (void)format_on_fail; return true; }
+  bool exists( const String& path ) { return m_files.count( path.str() ) != 0; }
+  bool remove( const String& path ) { return m_files.erase( path.str() ) != 0; }
+
+  File open( const String& path, const char* mode );
+
+private:
+  std::map<std::string, std::shared_ptr<std::string>> m_files;
+};
+
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef _HOST_CLOCK_H_
+#define _HOST_CLOCK_H_
+
+#include <stdint.h>
+#include <atomic>
+
+// Simulated time base shared by all shims.
+//
+// Everything that reads time on the device (millis, micros, esp_timer) reads
+// this clock instead, so replays are deterministic and independent of how fast
+// the host CPU is.  The replay driver moves it forward explicitly, and with a
+// read step set, each millis() or micros() the device calls moves it on too.
+class HostClock {
+public:
+  static uint64_t NowMicros() { return s_now_us.load( std::memory_order_acquire ); }
+
+  // The clock as millis() and micros() read it.
+  static uint64_t ReadMicros() {
+    uint64_t step_us = s_read_step_us.load( std::memory_order_relaxed );
+    if( step_us == 0 ) {
+      return NowMicros();
+    }
+    return s_now_us.fetch_add( step_us, std::memory_order_acq_rel ) + step_us;
+  }
+
+  // Time each read by the device takes, so that time passes inside Update()
+  // and its stages can be told apart.  0 by default.
+  static void SetReadStep( uint64_t step_us ) { s_read_step_us.store( step_us, std::memory_order_relaxed ); }
+
+  static void Set( uint64_t now_us ) { s_now_us.store( now_us, std::memory_order_release ); }
+
+  static void Advance( uint64_t delta_us ) { s_now_us.fetch_add( delta_us, std::memory_order_acq_rel ); }
+
+  // Advance to the given time, never backwards.
+  static void AdvanceTo( uint64_t target_us ) {
+    uint64_t now_us = s_now_us.load( std::memory_order_acquire );
+    while( now_us < target_us && !s_now_us.compare_exchange_weak( now_us, target_us, std::memory_order_acq_rel ) ) {
+    }
+  }
+
+private:
+  static std::atomic<uint64_t> s_now_us;
+  static std::atomic<uint64_t> s_read_step_us;
+};
+
+#endif
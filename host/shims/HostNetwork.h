@@ -0,0 +1,56 @@
+#ifndef _HOST_NETWORK_H_
+#define _HOST_NETWORK_H_
+
+#include <mutex>
+#include <vector>
+
+#include "WiFiUdp.h"
+
+// Connects the replay driver to the WiFiUDP sockets opened by the sketch.
+class HostNetwork {
+public:
+  struct Sent {
+    std::vector<uint8_t> m_data;
+    IPAddress            m_remote_ip;
+    uint16_t             m_remote_port;
+    uint64_t             m_time_us;
+  };
+
+  struct Counters {
+    uint64_t m_delivered;
+    uint64_t m_dropped_queue_full;
+    uint64_t m_dropped_no_socket;
+    uint64_t m_bytes_read;      // Copied out of the sockets by WiFiUDP::read().
+  };
+
+  // Deliver a datagram to whichever socket is bound to the port (and group,
+  // for multicast).  Returns false when it was dropped.
+  static bool Deliver( const uint8_t* data, size_t len, IPAddress remote_ip, uint16_t remote_port, uint16_t local_port, IPAddress local_ip = IPAddress( 192, 168, 1, 1 ) );
+
+  static void Register( WiFiUDP* socket );
+  static void Unregister( WiFiUDP* socket );
+
+  static void RecordSent( const Sent& sent ) { s_sent.push_back( sent ); }
+
+  // Datagrams waiting in all socket queues.
+  static size_t Queued();
+
+  // Multicast groups joined on the interface, by igmp_joingroup().  IsGroupJoined()
+  // is for Deliver(), with s_mutex held.
+  static bool IsGroupJoined( IPAddress group );
+  static void JoinGroup( IPAddress group );
+  static bool LeaveGroup( IPAddress group );
+
+  static std::vector<Sent> s_sent;
+  static Counters          s_counters;
+
+  // Guards the socket list and receive queues, which the sketch's receive
+  // task reads while the replay driver delivers.
+  static std::mutex        s_mutex;
+
+private:
+  static std::vector<WiFiUDP*> s_sockets;
+  static std::vector<IPAddress> s_groups;   // Once per join.
+};
+
+#endif
@@ -0,0 +1,1138 @@
+// Implementation of the host stand-ins for the Arduino core, WiFi, WebServer,
+// LittleFS, ArduinoJson and esp_dmx.
+
+#include "Arduino.h"
+#include "ArduinoJson.h"
+#include "HostNetwork.h"
+#include "LittleFS.h"
+#include "WebServer.h"
+#include "WiFi.h"
+#include "esp_dmx.h"
+#include "freertos/task.h"
+#include "lwip/igmp.h"
+
+#include <ctype.h>
+#include <random>
+#include <thread>
+
+//
+// Clock
+//
+
+std::atomic<uint64_t> HostClock::s_now_us( 0 );
+std::atomic<uint64_t> HostClock::s_read_step_us( 0 );
+
+unsigned long millis() {
+  // The ESP32 millis() is 32 bits wide; keep the same wrap point on the host.
+  return (unsigned long)(uint32_t)( HostClock::ReadMicros() / 1000 );
+}
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)HostClock::ReadMicros();
+}
+
+void delay( unsigned long ms ) {
+  HostClock::Advance( (uint64_t)ms * 1000 );
+}
+
+void delayMicroseconds( unsigned int us ) {
+  HostClock::Advance( us );
+}
+
+void yield() {
+}
+
+// Seeded the same every run, so replays are repeatable.
+static std::mt19937 s_random( 1 );
+
+void randomSeed( unsigned long seed ) {
+  s_random.seed( seed );
+}
+
+long random( long howbig ) {
+  return howbig <= 0 ? 0 : (long)( s_random() % (unsigned long)howbig );
+}
+
+long random( long howsmall, long howbig ) {
+  return howsmall >= howbig ? howsmall : howsmall + random( howbig - howsmall );
+}
+
+//
+// String
+//
+
+String::String( float value, unsigned int decimals ) : String( (double)value, decimals ) {
+}
+
+String::String( double value, unsigned int decimals ) {
+  char buffer[ 64 ];
+  snprintf( buffer, sizeof( buffer ), "%.*f", (int)decimals, value );
+  m_str = buffer;
+}
+
+int String::indexOf( char c, unsigned int from ) const {
+  size_t pos = m_str.find( c, from );
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf( const String& str, unsigned int from ) const {
+  size_t pos = m_str.find( str.m_str, from );
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring( unsigned int from ) const {
+  if( from >= m_str.length() ) {
+    return String();
+  }
+  return String( m_str.substr( from ) );
+}
+
+String String::substring( unsigned int from, unsigned int to ) const {
+  if( from > to ) {
+    std::swap( from, to );
+  }
+  if( from >= m_str.length() ) {
+    return String();
+  }
+  return String( m_str.substr( from, to - from ) );
+}
+
+void String::trim() {
+  size_t first = m_str.find_first_not_of( " \t\r\n" );
+  if( first == std::string::npos ) {
+    m_str.clear();
+    return;
+  }
+  size_t last = m_str.find_last_not_of( " \t\r\n" );
+  m_str = m_str.substr( first, last - first + 1 );
+}
+
+//
+// Print / Serial
+//
+
+size_t Print::write( const uint8_t* buffer, size_t size ) {
+  size_t n = 0;
+  while( size-- ) {
+    n += this->write( *buffer++ );
+  }
+  return n;
+}
+
+size_t Print::print( const char* str ) {
+  return this->write( (const uint8_t*)str, strlen( str ) );
+}
+
+size_t Print::print( const String& str ) {
+  return this->write( (const uint8_t*)str.c_str(), str.length() );
+}
+
+size_t Print::print( const IPAddress& ip ) {
+  return this->print( ip.toString() );
+}
+
+size_t Print::print( char c ) {
+  return this->write( (uint8_t)c );
+}
+
+size_t Print::print( int value ) {
+  return this->print( String( value ) );
+}
+
+size_t Print::print( unsigned int value ) {
+  return this->print( String( value ) );
+}
+
+size_t Print::print( long value ) {
+  return this->print( String( value ) );
+}
+
+size_t Print::print( unsigned long value ) {
+  return this->print( String( value ) );
+}
+
+size_t Print::print( double value, int digits ) {
+  return this->print( String( value, digits ) );
+}
+
+size_t Print::println() {
+  return this->print( "\r\n" );
+}
+
+size_t Print::printf( const char* format, ... ) {
+  char buffer[ 256 ];
+  va_list args;
+  va_start( args, format );
+  int len = vsnprintf( buffer, sizeof( buffer ), format, args );
+  va_end( args );
+  if( len < 0 ) {
+    return 0;
+  }
+  return this->write( (const uint8_t*)buffer, std::min( (size_t)len, sizeof( buffer ) - 1 ) );
+}
+
+HardwareSerial Serial;
+
+EspClass ESP;
+
+size_t HardwareSerial::write( uint8_t c ) {
+  if( m_echo ) {
+    fputc( c, stderr );
+  }
+  return 1;
+}
+
+size_t HardwareSerial::write( const uint8_t* buffer, size_t size ) {
+  if( m_echo ) {
+    fwrite( buffer, 1, size, stderr );
+  }
+  return size;
+}
+
+//
+// IPAddress
+//
+
+IPAddress::IPAddress( uint8_t a, uint8_t b, uint8_t c, uint8_t d ) {
+  m_address = (uint32_t)a | ( (uint32_t)b << 8 ) | ( (uint32_t)c << 16 ) | ( (uint32_t)d << 24 );
+}
+
+bool IPAddress::fromString( const char* address ) {
+  unsigned int octets[ 4 ];
+  char trailing;
+  if( sscanf( address, "%u.%u.%u.%u%c", &octets[ 0 ], &octets[ 1 ], &octets[ 2 ], &octets[ 3 ], &trailing ) != 4 ) {
+    return false;
+  }
+  for( unsigned int octet : octets ) {
+    if( octet > 255 ) {
+      return false;
+    }
+  }
+  *this = IPAddress( octets[ 0 ], octets[ 1 ], octets[ 2 ], octets[ 3 ] );
+  return true;
+}
+
+bool IPAddress::fromString( const String& address ) {
+  return this->fromString( address.c_str() );
+}
+
+String IPAddress::toString() const {
+  char buffer[ 16 ];
+  snprintf( buffer, sizeof( buffer ), "%u.%u.%u.%u", ( *this )[ 0 ], ( *this )[ 1 ], ( *this )[ 2 ], ( *this )[ 3 ] );
+  return String( buffer );
+}
+
+//
+// WiFi / WiFiUDP
+//
+
+WiFiClass WiFi;
+
+std::vector<WiFiUDP*>          HostNetwork::s_sockets;
+std::vector<IPAddress>         HostNetwork::s_groups;
+std::vector<HostNetwork::Sent> HostNetwork::s_sent;
+HostNetwork::Counters          HostNetwork::s_counters = {};
+std::mutex                     HostNetwork::s_mutex;
+
+size_t WiFiUDP::s_host_queue_depth = 16;
+
+void HostNetwork::Register( WiFiUDP* socket ) {
+  std::lock_guard<std::mutex> lock( s_mutex );
+  if( std::find( s_sockets.begin(), s_sockets.end(), socket ) == s_sockets.end() ) {
+    s_sockets.push_back( socket );
+  }
+}
+
+void HostNetwork::Unregister( WiFiUDP* socket ) {
+  std::lock_guard<std::mutex> lock( s_mutex );
+  s_sockets.erase( std::remove( s_sockets.begin(), s_sockets.end(), socket ), s_sockets.end() );
+}
+
+bool HostNetwork::IsGroupJoined( IPAddress group ) {
+  return std::find( s_groups.begin(), s_groups.end(), group ) != s_groups.end();
+}
+
+void HostNetwork::JoinGroup( IPAddress group ) {
+  std::lock_guard<std::mutex> lock( s_mutex );
+  s_groups.push_back( group );
+}
+
+bool HostNetwork::LeaveGroup( IPAddress group ) {
+  std::lock_guard<std::mutex> lock( s_mutex );
+  auto joined = std::find( s_groups.begin(), s_groups.end(), group );
+  if( joined == s_groups.end() ) {
+    return false;
+  }
+  s_groups.erase( joined );
+  return true;
+}
+
+err_t igmp_joingroup( const ip4_addr_t* ifaddr, const ip4_addr_t* groupaddr ) {
+  IPAddress group( groupaddr->addr );
+  if( ( group[ 0 ] & 0xF0 ) != 0xE0 ) {
+    return ERR_VAL;
+  }
+  HostNetwork::JoinGroup( group );
+  return ERR_OK;
+}
+
+err_t igmp_leavegroup( const ip4_addr_t* ifaddr, const ip4_addr_t* groupaddr ) {
+  return HostNetwork::LeaveGroup( IPAddress( groupaddr->addr ) ) ? ERR_OK : ERR_VAL;
+}
+
+size_t HostNetwork::Queued() {
+  std::lock_guard<std::mutex> lock( s_mutex );
+  size_t queued = 0;
+  for( WiFiUDP* socket : s_sockets ) {
+    queued += socket->HostQueued();
+  }
+  return queued;
+}
+
+bool HostNetwork::Deliver( const uint8_t* data, size_t len, IPAddress remote_ip, uint16_t remote_port, uint16_t local_port, IPAddress local_ip ) {
+  WiFiUDP::HostDatagram datagram;
+  datagram.m_data.assign( data, data + len );
+  datagram.m_remote_ip   = remote_ip;
+  datagram.m_remote_port = remote_port;
+  datagram.m_local_ip    = local_ip;
+  datagram.m_arrival_us  = HostClock::NowMicros();
+
+  std::lock_guard<std::mutex> lock( s_mutex );
+  for( WiFiUDP* socket : s_sockets ) {
+    if( socket->HostIsBoundTo( local_port, local_ip ) ) {
+      if( socket->HostEnqueue( datagram ) ) {
+        s_counters.m_delivered++;
+        return true;
+      }
+      s_counters.m_dropped_queue_full++;
+      return false;
+    }
+  }
+
+  s_counters.m_dropped_no_socket++;
+  return false;
+}
+
+WiFiUDP::WiFiUDP() : m_is_bound( false ), m_port( 0 ), m_current_pos( 0 ), m_remote_port( 0 ), m_tx_port( 0 ) {
+}
+
+WiFiUDP::~WiFiUDP() {
+  this->stop();
+}
+
+uint8_t WiFiUDP::begin( uint16_t port ) {
+  m_port     = port;
+  m_is_bound = true;
+  HostNetwork::Register( this );
+  return 1;
+}
+
+uint8_t WiFiUDP::beginMulticast( IPAddress multicast, uint16_t port ) {
+  m_multicast_groups.push_back( multicast );
+  return this->begin( port );
+}
+
+void WiFiUDP::stop() {
+  HostNetwork::Unregister( this );
+
+  std::lock_guard<std::mutex> lock( HostNetwork::s_mutex );
+  m_is_bound = false;
+  m_multicast_groups.clear();
+  m_queue.clear();
+  m_current.clear();
+  m_current_pos = 0;
+}
+
+bool WiFiUDP::HostIsBoundTo( uint16_t port, IPAddress local_ip ) const {
+  if( !m_is_bound || m_port != port ) {
+    return false;
+  }
+  // Multicast destinations (224.0.0.0/4) only reach sockets that joined the
+  // group, or any socket on the port once the interface joined it.
+  if( ( local_ip[ 0 ] & 0xF0 ) == 0xE0 ) {
+    return std::find( m_multicast_groups.begin(), m_multicast_groups.end(), local_ip ) != m_multicast_groups.end() ||
+           HostNetwork::IsGroupJoined( local_ip );
+  }
+  return m_multicast_groups.empty();
+}
+
+bool WiFiUDP::HostEnqueue( const HostDatagram& datagram ) {
+  if( m_queue.size() >= s_host_queue_depth ) {
+    return false;
+  }
+  m_queue.push_back( datagram );
+  return true;
+}
+
+int WiFiUDP::parsePacket() {
+  // Any unread remainder of the previous datagram is discarded, as on the ESP32.
+  m_current.clear();
+  m_current_pos = 0;
+
+  std::lock_guard<std::mutex> lock( HostNetwork::s_mutex );
+  if( m_queue.empty() ) {
+    return 0;
+  }
+
+  HostDatagram& datagram = m_queue.front();
+  m_current.swap( datagram.m_data );
+  m_remote_ip   = datagram.m_remote_ip;
+  m_remote_port = datagram.m_remote_port;
+  m_queue.pop_front();
+
+  return (int)m_current.size();
+}
+
+int WiFiUDP::available() {
+  return (int)( m_current.size() - m_current_pos );
+}
+
+int WiFiUDP::read() {
+  if( m_current_pos >= m_current.size() ) {
+    return -1;
+  }
+  return m_current[ m_current_pos++ ];
+}
+
+int WiFiUDP::read( uint8_t* buffer, size_t len ) {
+  size_t n = std::min( len, m_current.size() - m_current_pos );
+  memcpy( buffer, m_current.data() + m_current_pos, n );
+  m_current_pos += n;
+  HostNetwork::s_counters.m_bytes_read += n;
+  return (int)n;
+}
+
+int WiFiUDP::peek() {
+  if( m_current_pos >= m_current.size() ) {
+    return -1;
+  }
+  return m_current[ m_current_pos ];
+}
+
+void WiFiUDP::flush() {
+  m_current_pos = m_current.size();
+}
+
+int WiFiUDP::beginPacket( IPAddress ip, uint16_t port ) {
+  m_tx.clear();
+  m_tx_ip   = ip;
+  m_tx_port = port;
+  return 1;
+}
+
+int WiFiUDP::endPacket() {
+  HostNetwork::Sent sent;
+  sent.m_data        = m_tx;
+  sent.m_remote_ip   = m_tx_ip;
+  sent.m_remote_port = m_tx_port;
+  sent.m_time_us     = HostClock::NowMicros();
+  HostNetwork::RecordSent( sent );
+  m_tx.clear();
+  return 1;
+}
+
+size_t WiFiUDP::write( uint8_t c ) {
+  m_tx.push_back( c );
+  return 1;
+}
+
+size_t WiFiUDP::write( const uint8_t* buffer, size_t size ) {
+  m_tx.insert( m_tx.end(), buffer, buffer + size );
+  return size;
+}
+
+//
+// WebServer
+//
+
+void WebServer::handleClient() {
+  if( m_pending.empty() ) {
+    return;
+  }
+
+  Request request = m_pending.front();
+  m_pending.pop_front();
+
+  m_uri    = request.m_uri;
+  m_method = request.m_method;
+  m_args   = request.m_args;
+
+  for( const Handler& handler : m_handlers ) {
+    if( handler.m_uri == m_uri && ( handler.m_method == HTTP_ANY || handler.m_method == m_method ) ) {
+      handler.m_function();
+      return;
+    }
+  }
+
+  if( m_not_found ) {
+    m_not_found();
+  }
+}
+
+void WebServer::send( int code, const char* content_type, const String& content ) {
+  m_host_response_code = code;
+  m_host_response_type = content_type;
+  m_host_response_body = content;
+}
+
+String WebServer::arg( const String& name ) {
+  for( const auto& arg : m_args ) {
+    if( arg.first == name ) {
+      return arg.second;
+    }
+  }
+  return String();
+}
+
+bool WebServer::hasArg( const String& name ) {
+  for( const auto& arg : m_args ) {
+    if( arg.first == name ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WebServer::HostRequest( HTTPMethod method, const String& uri, const HostArgs& args ) {
+  m_pending.push_back( Request{ method, uri, args } );
+}
+
+//
+// LittleFS
+//
+
+fs::FS LittleFS;
+
+File fs::FS::open( const String& path, const char* mode ) {
+  if( mode[ 0 ] == 'w' ) {
+    std::shared_ptr<std::string> data = std::make_shared<std::string>();
+    m_files[ path.str() ] = data;
+    return File( data, true );
+  }
+
+  auto it = m_files.find( path.str() );
+  if( it == m_files.end() ) {
+    return File();
+  }
+  return File( it->second, false );
+}
+
+//
+// ArduinoJson
+//
+
+namespace host_json {
+
+NodePtr Node::Find( const std::string& key ) const {
+  if( m_type != Object ) {
+    return nullptr;
+  }
+  for( const auto& member : m_object ) {
+    if( member.first == key ) {
+      return member.second;
+    }
+  }
+  return nullptr;
+}
+
+NodePtr Node::FindOrCreate( const std::string& key ) {
+  if( m_type != Object ) {
+    this->Clear();
+    m_type = Object;
+  }
+  NodePtr node = this->Find( key );
+  if( !node ) {
+    node = std::make_shared<Node>();
+    m_object.push_back( std::make_pair( key, node ) );
+  }
+  return node;
+}
+
+static void Escape( const std::string& in, std::string& out ) {
+  out += '"';
+  for( char c : in ) {
+    switch( c ) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n";  break;
+      case '\r': out += "\\r";  break;
+      case '\t': out += "\\t";  break;
+      default:
+        if( (unsigned char)c < 0x20 ) {
+          char buffer[ 8 ];
+          snprintf( buffer, sizeof( buffer ), "\\u%04x", c );
+          out += buffer;
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+static void Serialize( const NodePtr& node, std::string& out ) {
+  if( !node ) {
+    out += "null";
+    return;
+  }
+  switch( node->m_type ) {
+    case Node::Null:  out += "null"; break;
+    case Node::Bool:  out += node->m_bool ? "true" : "false"; break;
+    case Node::Int:   out += std::to_string( node->m_int ); break;
+    case Node::Float: {
+      char buffer[ 32 ];
+      snprintf( buffer, sizeof( buffer ), "%.9g", node->m_float );
+      out += buffer;
+      break;
+    }
+    case Node::Str:   Escape( node->m_str, out ); break;
+    case Node::Array: {
+      out += '[';
+      for( size_t i = 0; i < node->m_array.size(); i++ ) {
+        if( i ) out += ',';
+        Serialize( node->m_array[ i ], out );
+      }
+      out += ']';
+      break;
+    }
+    case Node::Object: {
+      out += '{';
+      for( size_t i = 0; i < node->m_object.size(); i++ ) {
+        if( i ) out += ',';
+        Escape( node->m_object[ i ].first, out );
+        out += ':';
+        Serialize( node->m_object[ i ].second, out );
+      }
+      out += '}';
+      break;
+    }
+  }
+}
+
+class Parser {
+public:
+  explicit Parser( const std::string& text ) : m_text( text ), m_pos( 0 ) {}
+
+  bool Parse( const NodePtr& node ) {
+    this->SkipSpace();
+    if( !this->Value( node, 0 ) ) {
+      return false;
+    }
+    this->SkipSpace();
+    return m_pos == m_text.size();
+  }
+
+private:
+  void SkipSpace() {
+    while( m_pos < m_text.size() && isspace( (unsigned char)m_text[ m_pos ] ) ) {
+      m_pos++;
+    }
+  }
+
+  bool Literal( const char* literal ) {
+    size_t len = strlen( literal );
+    if( m_text.compare( m_pos, len, literal ) != 0 ) {
+      return false;
+    }
+    m_pos += len;
+    return true;
+  }
+
+  bool StringValue( std::string& out ) {
+    if( m_text[ m_pos ] != '"' ) {
+      return false;
+    }
+    m_pos++;
+    while( m_pos < m_text.size() && m_text[ m_pos ] != '"' ) {
+      char c = m_text[ m_pos++ ];
+      if( c == '\\' && m_pos < m_text.size() ) {
+        char e = m_text[ m_pos++ ];
+        switch( e ) {
+          case 'n': out += '\n'; break;
+          case 'r': out += '\r'; break;
+          case 't': out += '\t'; break;
+          case 'u': {
+            if( m_pos + 4 > m_text.size() ) return false;
+            out += (char)strtol( m_text.substr( m_pos, 4 ).c_str(), nullptr, 16 );
+            m_pos += 4;
+            break;
+          }
+          default: out += e; break;
+        }
+      } else {
+        out += c;
+      }
+    }
+    if( m_pos >= m_text.size() ) {
+      return false;
+    }
+    m_pos++;
+    return true;
+  }
+
+  bool Value( const NodePtr& node, int depth ) {
+    if( m_pos >= m_text.size() || depth > 32 ) {
+      return false;
+    }
+    char c = m_text[ m_pos ];
+    if( c == '{' ) {
+      m_pos++;
+      node->m_type = Node::Object;
+      this->SkipSpace();
+      if( m_pos < m_text.size() && m_text[ m_pos ] == '}' ) {
+        m_pos++;
+        return true;
+      }
+      while( true ) {
+        this->SkipSpace();
+        std::string key;
+        if( m_pos >= m_text.size() || !this->StringValue( key ) ) return false;
+        this->SkipSpace();
+        if( m_pos >= m_text.size() || m_text[ m_pos++ ] != ':' ) return false;
+        this->SkipSpace();
+        NodePtr child = std::make_shared<Node>();
+        if( !this->Value( child, depth + 1 ) ) return false;
+        node->m_object.push_back( std::make_pair( key, child ) );
+        this->SkipSpace();
+        if( m_pos >= m_text.size() ) return false;
+        if( m_text[ m_pos ] == ',' ) { m_pos++; continue; }
+        if( m_text[ m_pos ] == '}' ) { m_pos++; return true; }
+        return false;
+      }
+    }
+    if( c == '[' ) {
+      m_pos++;
+      node->m_type = Node::Array;
+      this->SkipSpace();
+      if( m_pos < m_text.size() && m_text[ m_pos ] == ']' ) {
+        m_pos++;
+        return true;
+      }
+      while( true ) {
+        this->SkipSpace();
+        NodePtr child = std::make_shared<Node>();
+        if( !this->Value( child, depth + 1 ) ) return false;
+        node->m_array.push_back( child );
+        this->SkipSpace();
+        if( m_pos >= m_text.size() ) return false;
+        if( m_text[ m_pos ] == ',' ) { m_pos++; continue; }
+        if( m_text[ m_pos ] == ']' ) { m_pos++; return true; }
+        return false;
+      }
+    }
+    if( c == '"' ) {
+      node->m_type = Node::Str;
+      return this->StringValue( node->m_str );
+    }
+    if( this->Literal( "true" ) ) { node->m_type = Node::Bool; node->m_bool = true; return true; }
+    if( this->Literal( "false" ) ) { node->m_type = Node::Bool; node->m_bool = false; return true; }
+    if( this->Literal( "null" ) ) { node->m_type = Node::Null; return true; }
+
+    size_t start = m_pos;
+    bool is_float = false;
+    while( m_pos < m_text.size() && strchr( "+-0123456789.eE", m_text[ m_pos ] ) ) {
+      if( strchr( ".eE", m_text[ m_pos ] ) ) {
+        is_float = true;
+      }
+      m_pos++;
+    }
+    if( start == m_pos ) {
+      return false;
+    }
+    std::string number = m_text.substr( start, m_pos - start );
+    if( is_float ) {
+      node->m_type  = Node::Float;
+      node->m_float = strtod( number.c_str(), nullptr );
+    } else {
+      node->m_type = Node::Int;
+      node->m_int  = strtoll( number.c_str(), nullptr, 10 );
+    }
+    return true;
+  }
+
+  const std::string& m_text;
+  size_t             m_pos;
+};
+
+}
+
+host_json::NodePtr JsonVariant::Resolve( bool create ) const {
+  if( m_node ) {
+    return m_node;
+  }
+  if( !m_parent ) {
+    return nullptr;
+  }
+  if( create ) {
+    m_node = m_parent->FindOrCreate( m_key );
+    return m_node;
+  }
+  return m_parent->Find( m_key );
+}
+
+JsonVariant JsonVariant::operator[]( const char* key ) const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node ) {
+    return JsonVariant();
+  }
+  return JsonVariant( node, key );
+}
+
+JsonVariant JsonVariant::operator[]( size_t index ) const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node || node->m_type != host_json::Node::Array || index >= node->m_array.size() ) {
+    return JsonVariant();
+  }
+  return JsonVariant( node->m_array[ index ] );
+}
+
+JsonVariant& JsonVariant::operator=( const JsonVariant& rhs ) {
+  host_json::NodePtr source = rhs.Resolve();
+  host_json::NodePtr node   = this->Resolve( true );
+  if( node && source ) {
+    *node = *source;
+  }
+  return *this;
+}
+
+JsonVariant& JsonVariant::operator=( bool value ) {
+  host_json::NodePtr node = this->Resolve( true );
+  if( node ) {
+    node->Clear();
+    node->m_type = host_json::Node::Bool;
+    node->m_bool = value;
+  }
+  return *this;
+}
+
+void JsonVariant::SetString( const std::string& value ) {
+  host_json::NodePtr node = this->Resolve( true );
+  if( node ) {
+    node->Clear();
+    node->m_type = host_json::Node::Str;
+    node->m_str  = value;
+  }
+}
+
+void JsonVariant::SetInt( long long value ) {
+  host_json::NodePtr node = this->Resolve( true );
+  if( node ) {
+    node->Clear();
+    node->m_type = host_json::Node::Int;
+    node->m_int  = value;
+  }
+}
+
+void JsonVariant::SetFloat( double value ) {
+  host_json::NodePtr node = this->Resolve( true );
+  if( node ) {
+    node->Clear();
+    node->m_type  = host_json::Node::Float;
+    node->m_float = value;
+  }
+}
+
+JsonArray JsonVariant::createNestedArray( const char* key ) {
+  host_json::NodePtr node = this->Resolve( true );
+  if( !node ) {
+    return JsonArray();
+  }
+  host_json::NodePtr child = node->FindOrCreate( key );
+  child->Clear();
+  child->m_type = host_json::Node::Array;
+  return JsonArray( child );
+}
+
+JsonObject JsonVariant::createNestedObject( const char* key ) {
+  host_json::NodePtr node = this->Resolve( true );
+  if( !node ) {
+    return JsonObject();
+  }
+  host_json::NodePtr child = node->FindOrCreate( key );
+  child->Clear();
+  child->m_type = host_json::Node::Object;
+  return JsonObject( child );
+}
+
+template <> String JsonVariant::as<String>() const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node || node->m_type == host_json::Node::Null ) {
+    return String( "null" );
+  }
+  if( node->m_type == host_json::Node::Str ) {
+    return String( node->m_str );
+  }
+  std::string out;
+  host_json::Serialize( node, out );
+  return String( out );
+}
+
+template <> const char* JsonVariant::as<const char*>() const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node || node->m_type != host_json::Node::Str ) {
+    return nullptr;
+  }
+  return node->m_str.c_str();
+}
+
+template <> bool JsonVariant::as<bool>() const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node ) {
+    return false;
+  }
+  switch( node->m_type ) {
+    case host_json::Node::Bool:  return node->m_bool;
+    case host_json::Node::Int:   return node->m_int != 0;
+    case host_json::Node::Float: return node->m_float != 0;
+    default:                     return false;
+  }
+}
+
+template <> double JsonVariant::as<double>() const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node ) {
+    return 0;
+  }
+  switch( node->m_type ) {
+    case host_json::Node::Int:   return (double)node->m_int;
+    case host_json::Node::Float: return node->m_float;
+    case host_json::Node::Str:   return strtod( node->m_str.c_str(), nullptr );
+    default:                     return 0;
+  }
+}
+
+template <> float JsonVariant::as<float>() const {
+  return (float)this->as<double>();
+}
+
+template <> JsonArray JsonVariant::as<JsonArray>() const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node || node->m_type != host_json::Node::Array ) {
+    return JsonArray();
+  }
+  return JsonArray( node );
+}
+
+template <> JsonObject JsonVariant::as<JsonObject>() const {
+  host_json::NodePtr node = this->Resolve();
+  if( !node || node->m_type != host_json::Node::Object ) {
+    return JsonObject();
+  }
+  return JsonObject( node );
+}
+
+template <> JsonVariant JsonVariant::as<JsonVariant>() const {
+  return *this;
+}
+
+JsonObject JsonArray::createNestedObject() {
+  if( !m_node ) {
+    return JsonObject();
+  }
+  host_json::NodePtr child = std::make_shared<host_json::Node>();
+  child->m_type = host_json::Node::Object;
+  m_node->m_array.push_back( child );
+  return JsonObject( child );
+}
+
+JsonArray JsonArray::createNestedArray() {
+  if( !m_node ) {
+    return JsonArray();
+  }
+  host_json::NodePtr child = std::make_shared<host_json::Node>();
+  child->m_type = host_json::Node::Array;
+  m_node->m_array.push_back( child );
+  return JsonArray( child );
+}
+
+JsonArray JsonObject::createNestedArray( const char* key ) {
+  return m_node ? JsonVariant( m_node ).createNestedArray( key ) : JsonArray();
+}
+
+JsonObject JsonObject::createNestedObject( const char* key ) {
+  return m_node ? JsonVariant( m_node ).createNestedObject( key ) : JsonObject();
+}
+
+size_t serializeJson( const JsonDocument& doc, File& file ) {
+  std::string out;
+  host_json::Serialize( doc.Root(), out );
+  return file.write( (const uint8_t*)out.data(), out.size() );
+}
+
+size_t serializeJson( const JsonDocument& doc, String& output ) {
+  std::string out;
+  host_json::Serialize( doc.Root(), out );
+  output = String( out );
+  return out.size();
+}
+
+size_t measureJson( const JsonDocument& doc ) {
+  std::string out;
+  host_json::Serialize( doc.Root(), out );
+  return out.size();
+}
+
+DeserializationError deserializeJson( JsonDocument& doc, const String& input ) {
+  doc.clear();
+  if( input.length() == 0 ) {
+    return DeserializationError( DeserializationError::EmptyInput );
+  }
+  host_json::Parser parser( input.str() );
+  if( !parser.Parse( doc.Root() ) ) {
+    doc.clear();
+    return DeserializationError( DeserializationError::InvalidInput );
+  }
+  return DeserializationError();
+}
+
+DeserializationError deserializeJson( JsonDocument& doc, File& file ) {
+  std::string text;
+  int c;
+  while( ( c = file.read() ) >= 0 ) {
+    text += (char)c;
+  }
+  return deserializeJson( doc, String( text ) );
+}
+
+//
+// esp_dmx
+//
+
+HostDMX::Port     HostDMX::s_ports[ DMX_NUM_MAX ];
+HostDMX::SendHook HostDMX::s_send_hook;
+
+void HostDMX::Reset() {
+  memset( s_ports, 0, sizeof( s_ports ) );
+}
+
+bool dmx_driver_install( dmx_port_t dmx_num, dmx_config_t* config, dmx_personality_t* personalities, int personality_count ) {
+  (void)config;
+  (void)personalities;
+  (void)personality_count;
+  if( dmx_num < 0 || dmx_num >= DMX_NUM_MAX ) {
+    return false;
+  }
+  HostDMX::Port& port = HostDMX::Get( dmx_num );
+  if( port.m_installed ) {
+    return false;
+  }
+  port.m_installed     = true;
+  port.m_busy_until_us = 0;
+  memset( port.m_buffer, 0, sizeof( port.m_buffer ) );
+  return true;
+}
+
+bool dmx_driver_delete( dmx_port_t dmx_num ) {
+  if( !dmx_driver_is_installed( dmx_num ) ) {
+    return false;
+  }
+  HostDMX::Get( dmx_num ).m_installed = false;
+  return true;
+}
+
+bool dmx_driver_is_installed( dmx_port_t dmx_num ) {
+  return dmx_num >= 0 && dmx_num < DMX_NUM_MAX && HostDMX::Get( dmx_num ).m_installed;
+}
+
+bool dmx_set_pin( dmx_port_t dmx_num, int tx_pin, int rx_pin, int rts_pin ) {
+  if( !dmx_driver_is_installed( dmx_num ) ) {
+    return false;
+  }
+  HostDMX::Port& port = HostDMX::Get( dmx_num );
+  port.m_tx_pin  = tx_pin;
+  port.m_rx_pin  = rx_pin;
+  port.m_rts_pin = rts_pin;
+  return true;
+}
+
+size_t dmx_write( dmx_port_t dmx_num, const void* source, size_t size ) {
+  if( !dmx_driver_is_installed( dmx_num ) ) {
+    return 0;
+  }
+  HostDMX::Port& port = HostDMX::Get( dmx_num );
+  size = std::min( size, (size_t)DMX_PACKET_SIZE );
+  if( HostClock::NowMicros() < port.m_busy_until_us ) {
+    // The UART reads the buffer while it sends, so this can tear a frame.
+    port.m_writes_while_busy++;
+  }
+  memcpy( port.m_buffer, source, size );
+  return size;
+}
+
+bool dmx_wait_sent( dmx_port_t dmx_num, TickType_t wait_ticks ) {
+  if( !dmx_driver_is_installed( dmx_num ) ) {
+    return false;
+  }
+  HostDMX::Port& port = HostDMX::Get( dmx_num );
+  uint64_t now_us = HostClock::NowMicros();
+  if( now_us >= port.m_busy_until_us ) {
+    return true;
+  }
+  uint64_t wait_us = (uint64_t)wait_ticks * portTICK_PERIOD_MS * 1000;
+  if( now_us + wait_us < port.m_busy_until_us ) {
+    port.m_wait_us += wait_us;
+    HostClock::Advance( wait_us );
+    return false;
+  }
+  port.m_wait_us += port.m_busy_until_us - now_us;
+  HostClock::AdvanceTo( port.m_busy_until_us );
+  return true;
+}
+
+size_t dmx_send_num( dmx_port_t dmx_num, size_t size ) {
+  if( !dmx_driver_is_installed( dmx_num ) || size == 0 ) {
+    return 0;
+  }
+  size = std::min( size, (size_t)DMX_PACKET_SIZE );
+
+  // Like the driver, wait a frame time for a send already in progress.
+  if( !dmx_wait_sent( dmx_num, pdMS_TO_TICKS( 23 ) ) ) {
+    return 0;
+  }
+
+  HostDMX::Port& port = HostDMX::Get( dmx_num );
+  uint64_t now_us = HostClock::NowMicros();
+  port.m_busy_until_us = now_us + HostDMX::FrameTimeMicros( size );
+  port.m_frames_sent++;
+  port.m_slots_sent += size;
+
+  if( HostDMX::s_send_hook ) {
+    HostDMX::s_send_hook( dmx_num, now_us, port.m_buffer, size );
+  }
+
+  return size;
+}
+
+size_t dmx_send( dmx_port_t dmx_num ) {
+  return dmx_send_num( dmx_num, DMX_PACKET_SIZE );
+}
+
+//
+// FreeRTOS tasks
+//
+
+BaseType_t xTaskCreatePinnedToCore( TaskFunction_t task_function, const char* name, uint32_t stack_depth, void* parameter, UBaseType_t priority, TaskHandle_t* created_task, BaseType_t core_id ) {
+  (void)name;
+  (void)stack_depth;
+  (void)priority;
+  (void)core_id;
+  std::thread thread( task_function, parameter );
+  if( created_task != nullptr ) {
+    *created_task = nullptr;
+  }
+  thread.detach();
+  return pdPASS;
+}
+
+void vTaskDelete( TaskHandle_t task ) {
+  (void)task;
+}
+
+void vTaskDelay( TickType_t ticks ) {
+  delay( (unsigned long)ticks * portTICK_PERIOD_MS );
+  std::this_thread::yield();
+}
+
+BaseType_t xPortGetCoreID() {
+  return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef _HOST_IPADDRESS_H_
+#define _HOST_IPADDRESS_H_
+
+#include <stdint.h>
+
+class String;
+
+class IPAddress {
+public:
+  IPAddress() : m_address( 0 ) {}
+  IPAddress( uint8_t a, uint8_t b, uint8_t c, uint8_t d );
+  IPAddress( uint32_t address ) : m_address( address ) {}
+
+  bool fromString( const char* address );
+  bool fromString( const String& address );
+  String toString() const;
+
+  operator uint32_t() const { return m_address; }
+  uint8_t operator[]( int index ) const { return ( m_address >> ( index * 8 ) ) & 0xFF; }
+
+  bool operator==( const IPAddress& rhs ) const { return m_address == rhs.m_address; }
+  bool operator!=( const IPAddress& rhs ) const { return m_address != rhs.m_address; }
+
+private:
+  uint32_t m_address;   // Network order, as on the ESP32 (first octet in the low byte).
+};
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef _HOST_LITTLEFS_H_
+#define _HOST_LITTLEFS_H_
+
+#include "FS.h"
+
+extern fs::FS LittleFS;
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef _HOST_PRINT_H_
+#define _HOST_PRINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+class String;
+class IPAddress;
+
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write( uint8_t c ) = 0;
+  virtual size_t write( const uint8_t* buffer, size_t size );
+
+  size_t print( const char* str );
+  size_t print( const String& str );
+  size_t print( const IPAddress& ip );
+  size_t print( char c );
+  size_t print( int value );
+  size_t print( unsigned int value );
+  size_t print( long value );
+  size_t print( unsigned long value );
+  size_t print( double value, int digits = 2 );
+
+  size_t println();
+  template <typename T> size_t println( const T& value ) { size_t n = print( value ); return n + println(); }
+
+  size_t printf( const char* format, ... ) __attribute__( ( format( printf, 2, 3 ) ) );
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef _HOST_WEBSERVER_H_
+#define _HOST_WEBSERVER_H_
+
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "Arduino.h"
+
+typedef enum {
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_POST
+} HTTPMethod;
+
+// Host stand-in for the ESP32 WebServer.
+//
+// Requests are queued with HostRequest() and dispatched one per
+// handleClient() call, just as the real server serves one client per call.
+// The last response is kept for the driver to inspect.
+class WebServer {
+public:
+  typedef std::function<void( void )> THandlerFunction;
+
+  WebServer( int port = 80 ) { (void)port; }
+
+  void begin() {}
+  void handleClient();
+
+  void on( const String& uri, THandlerFunction handler ) { this->on( uri, HTTP_ANY, handler ); }
+  void on( const String& uri, HTTPMethod method, THandlerFunction handler ) { m_handlers.push_back( Handler{ uri, method, handler } ); }
+  void onNotFound( THandlerFunction handler ) { m_not_found = handler; }
+
+  void send( int code, const char* content_type, const String& content );
+  void send( int code, const String& content_type, const String& content ) { this->send( code, content_type.c_str(), content ); }
+
+  String uri() { return m_uri; }
+  HTTPMethod method() { return m_method; }
+  int args() { return (int)m_args.size(); }
+  String argName( int i ) { return m_args[ i ].first; }
+  String arg( int i ) { return m_args[ i ].second; }
+  String arg( const String& name );
+  bool hasArg( const String& name );
+
+  // Host only.
+  typedef std::vector<std::pair<String, String>> HostArgs;
+
+  void HostRequest( HTTPMethod method, const String& uri, const HostArgs& args = HostArgs() );
+
+  int    m_host_response_code = 0;
+  String m_host_response_type;
+  String m_host_response_body;
+
+private:
+  struct Handler {
+    String           m_uri;
+    HTTPMethod       m_method;
+    THandlerFunction m_function;
+  };
+
+  struct Request {
+    HTTPMethod m_method;
+    String     m_uri;
+    HostArgs   m_args;
+  };
+
+  std::vector<Handler> m_handlers;
+  THandlerFunction     m_not_found;
+  std::deque<Request>  m_pending;
+
+  String     m_uri;
+  HTTPMethod m_method = HTTP_GET;
+  HostArgs   m_args;
+};
+
+#endif
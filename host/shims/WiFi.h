@@ -0,0 +1,44 @@
+#ifndef _HOST_WIFI_H_
+#define _HOST_WIFI_H_
+
+#include "Arduino.h"
+#include "WiFiUdp.h"
+
+typedef enum {
+  WL_IDLE_STATUS  = 0,
+  WL_CONNECTED    = 3,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP  = 2
+} wifi_mode_t;
+
+class WiFiClass {
+public:
+  bool mode( wifi_mode_t mode ) { m_mode = mode; return true; }
+  wl_status_t begin( const String& ssid, const String& pass ) { (void)ssid; (void)pass; m_status = WL_CONNECTED; return m_status; }
+  bool config( IPAddress ip, IPAddress gateway, IPAddress subnet ) { (void)gateway; (void)subnet; m_local_ip = ip; return true; }
+  bool disconnect() { m_status = WL_DISCONNECTED; return true; }
+  wl_status_t status() { return m_status; }
+
+  bool softAP( const String& ssid, const String& pass ) { (void)ssid; (void)pass; return true; }
+  bool softAPConfig( IPAddress ip, IPAddress gateway, IPAddress subnet ) { (void)gateway; (void)subnet; m_local_ip = ip; return true; }
+
+  IPAddress localIP() { return m_local_ip; }
+  IPAddress softAPIP() { return m_local_ip; }
+  IPAddress subnetMask() { return IPAddress( 255, 255, 255, 0 ); }
+  String macAddress() { return String( "02:00:00:00:00:01" ); }
+  uint8_t* macAddress( uint8_t* mac ) { static const uint8_t host_mac[ 6 ] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 }; memcpy( mac, host_mac, 6 ); return mac; }
+
+private:
+  wifi_mode_t m_mode     = WIFI_OFF;
+  wl_status_t m_status   = WL_IDLE_STATUS;
+  IPAddress   m_local_ip = IPAddress( 192, 168, 1, 1 );
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _HOST_WIFIUDP_H_
+#define _HOST_WIFIUDP_H_
+
+#include <deque>
+#include <vector>
+
+#include "Arduino.h"
+
+// Host stand-in for the ESP32 WiFiUDP socket.
+//
+// Datagrams are delivered by HostNetwork::Deliver() into a bounded per-socket
+// queue which models the lwIP receive mailbox; once it is full further
+// datagrams are dropped and counted, as they would be on the device.
+class WiFiUDP : public Print {
+public:
+  WiFiUDP();
+  ~WiFiUDP();
+
+  uint8_t begin( uint16_t port );
+  uint8_t beginMulticast( IPAddress multicast, uint16_t port );
+  void stop();
+
+  int parsePacket();
+  int available();
+  int read();
+  int read( uint8_t* buffer, size_t len );
+  int read( char* buffer, size_t len ) { return this->read( (uint8_t*)buffer, len ); }
+  int peek();
+  void flush();
+
+  IPAddress remoteIP() { return m_remote_ip; }
+  uint16_t remotePort() { return m_remote_port; }
+
+  int beginPacket( IPAddress ip, uint16_t port );
+  int endPacket();
+  size_t write( uint8_t c ) override;
+  size_t write( const uint8_t* buffer, size_t size ) override;
+
+  // Host only.
+  struct HostDatagram {
+    std::vector<uint8_t> m_data;
+    IPAddress            m_remote_ip;
+    uint16_t             m_remote_port;
+    IPAddress            m_local_ip;
+    uint64_t             m_arrival_us;
+  };
+
+  bool HostEnqueue( const HostDatagram& datagram );
+  bool HostIsBoundTo( uint16_t port, IPAddress local_ip ) const;
+  size_t HostQueued() const { return m_queue.size(); }
+
+  static size_t s_host_queue_depth;
+
+private:
+  bool                     m_is_bound;
+  uint16_t                 m_port;
+  std::vector<IPAddress>   m_multicast_groups;
+  std::deque<HostDatagram> m_queue;
+
+  std::vector<uint8_t>     m_current;
+  size_t                   m_current_pos;
+  IPAddress                m_remote_ip;
+  uint16_t                 m_remote_port;
+
+  std::vector<uint8_t>     m_tx;
+  IPAddress                m_tx_ip;
+  uint16_t                 m_tx_port;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef _HOST_ESP_DMX_H_
+#define _HOST_ESP_DMX_H_
+
+// Host stand-in for the esp_dmx library (4.x API).
+//
+// Frames are not put on a wire; instead each port records what was sent and
+// when.  A send occupies the port for the real DMX frame time (break + MAB +
+// 44us per slot) on the simulated clock, so dmx_wait_sent() costs the same
+// amount of device time as it would on the ESP32.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+#include "freertos/FreeRTOS.h"
+
+#ifndef SOC_UART_NUM
+#define SOC_UART_NUM 3
+#endif
+
+typedef int dmx_port_t;
+
+enum {
+  DMX_NUM_0,
+  DMX_NUM_1,
+#if SOC_UART_NUM > 2
+  DMX_NUM_2,
+#endif
+  DMX_NUM_MAX
+};
+
+#define DMX_PACKET_SIZE     513
+#define DMX_TIMEOUT_TICK    ( 1250 / portTICK_PERIOD_MS )
+#define DMX_BREAK_LEN_US    176
+#define DMX_MAB_LEN_US      12
+#define DMX_SLOT_LEN_US     44
+
+typedef struct dmx_config_t {
+  uint32_t interrupt_flags;
+  uint16_t root_device_parameter_count;
+  uint16_t sub_device_parameter_count;
+  uint16_t model_id;
+  uint16_t product_category;
+  uint32_t software_version_id;
+  const char* software_version_label;
+  int queue_size_max;
+} dmx_config_t;
+
+#define DMX_CONFIG_DEFAULT { 0, 32, 0, 0, 0x0100, 0, "esp_dmx", 32 }
+
+typedef struct dmx_personality_t {
+  uint16_t footprint;
+  const char* description;
+} dmx_personality_t;
+
+bool dmx_driver_install( dmx_port_t dmx_num, dmx_config_t* config, dmx_personality_t* personalities, int personality_count );
+bool dmx_driver_delete( dmx_port_t dmx_num );
+bool dmx_driver_is_installed( dmx_port_t dmx_num );
+bool dmx_set_pin( dmx_port_t dmx_num, int tx_pin, int rx_pin, int rts_pin );
+size_t dmx_write( dmx_port_t dmx_num, const void* source, size_t size );
+size_t dmx_send_num( dmx_port_t dmx_num, size_t size );
+size_t dmx_send( dmx_port_t dmx_num );
+bool dmx_wait_sent( dmx_port_t dmx_num, TickType_t wait_ticks );
+
+// Host only.
+class HostDMX {
+public:
+  typedef std::function<void( dmx_port_t dmx_num, uint64_t break_us, const uint8_t* frame, size_t size )> SendHook;
+
+  struct Port {
+    bool     m_installed;
+    int      m_tx_pin;
+    int      m_rx_pin;
+    int      m_rts_pin;
+    uint8_t  m_buffer[ DMX_PACKET_SIZE ];
+    uint64_t m_busy_until_us;
+    uint64_t m_frames_sent;
+    uint64_t m_slots_sent;
+    uint64_t m_writes_while_busy;
+    uint64_t m_wait_us;
+  };
+
+  static uint64_t FrameTimeMicros( size_t size ) { return DMX_BREAK_LEN_US + DMX_MAB_LEN_US + (uint64_t)size * DMX_SLOT_LEN_US; }
+
+  static Port& Get( dmx_port_t dmx_num ) { return s_ports[ dmx_num ]; }
+  static void Reset();
+
+  static SendHook s_send_hook;
+
+private:
+  static Port s_ports[ DMX_NUM_MAX ];
+};
+
+#endif
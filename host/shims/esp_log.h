@@ -0,0 +1,17 @@
+#ifndef _HOST_ESP_LOG_H_
+#define _HOST_ESP_LOG_H_
+
+// Host stand-in for ESP-IDF logging : there is no console to silence.
+
+typedef enum {
+  ESP_LOG_NONE,
+  ESP_LOG_ERROR,
+  ESP_LOG_WARN,
+  ESP_LOG_INFO,
+  ESP_LOG_DEBUG,
+  ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+inline void esp_log_level_set( const char* tag, esp_log_level_t level ) { (void)tag; (void)level; }
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef _HOST_FREERTOS_H_
+#define _HOST_FREERTOS_H_
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+
+#define portTICK_PERIOD_MS  1
+#define portMAX_DELAY       ( (TickType_t)0xFFFFFFFFUL )
+#define pdMS_TO_TICKS( ms ) ( (TickType_t)( ms ) )
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef _HOST_FREERTOS_TASK_H_
+#define _HOST_FREERTOS_TASK_H_
+
+// Host stand-in for FreeRTOS tasks.
+//
+// Each task is a detached std::thread; priority and core affinity are
+// accepted and ignored.  A task function must end with vTaskDelete( NULL ),
+// which on the host simply lets the thread return.  vTaskDelay() yields the
+// thread and moves the simulated clock on like delay().
+
+#include "FreeRTOS.h"
+
+typedef void*        TaskHandle_t;
+typedef unsigned int UBaseType_t;
+typedef void ( *TaskFunction_t )( void* );
+
+#ifndef portNUM_PROCESSORS
+#define portNUM_PROCESSORS 2
+#endif
+
+#define tskNO_AFFINITY ( (BaseType_t)0x7FFFFFFF )
+
+BaseType_t xTaskCreatePinnedToCore( TaskFunction_t task_function, const char* name, uint32_t stack_depth, void* parameter, UBaseType_t priority, TaskHandle_t* created_task, BaseType_t core_id );
+void vTaskDelete( TaskHandle_t task );
+void vTaskDelay( TickType_t ticks );
+BaseType_t xPortGetCoreID();
+
+#endif
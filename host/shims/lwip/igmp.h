@@ -0,0 +1,24 @@
+#ifndef _HOST_LWIP_IGMP_H_
+#define _HOST_LWIP_IGMP_H_
+
+#include <stdint.h>
+
+// Host stand-in for lwIP's IGMP API.
+//
+// Groups joined here are the interface's : a multicast datagram reaches any
+// socket bound to its port once its group was joined, as on the ESP32.
+
+typedef int8_t err_t;
+
+struct ip4_addr_t {
+  uint32_t addr;        // Network order.
+};
+
+#define ERR_OK     0
+#define ERR_VAL   -6
+#define IPADDR_ANY ( (uint32_t)0x00000000UL )
+
+err_t igmp_joingroup( const ip4_addr_t* ifaddr, const ip4_addr_t* groupaddr );
+err_t igmp_leavegroup( const ip4_addr_t* ifaddr, const ip4_addr_t* groupaddr );
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef _HOST_LWIP_TCPIP_H_
+#define _HOST_LWIP_TCPIP_H_
+
+// Host stand-in for lwIP's tcpip thread API.  There is no tcpip thread on the
+// host, so LWIP_TCPIP_CORE_LOCKING is left undefined and nothing is locked.
+
+#endif